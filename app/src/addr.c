@@ -17,6 +17,7 @@
 #include "app_mode.h"
 #include "coin.h"
 #include "crypto.h"
+#include "os.h"
 #include "zxerror.h"
 #include "zxformat.h"
 #include "zxmacros.h"
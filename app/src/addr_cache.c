@@ -0,0 +1,86 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "addr_cache.h"
+#include <string.h>
+#include <zxmacros.h>
+
+static bool addr_cache_matches(const addr_cache_entry_t *entry,
+                               const uint32_t *path, uint8_t pathLen,
+                               const char *hrp, size_t hrpLen,
+                               uint8_t encoding) {
+  return entry->used && entry->encoding == encoding &&
+         entry->pathLen == pathLen && entry->hrpLen == hrpLen &&
+         MEMCMP(entry->path, path, pathLen * sizeof(uint32_t)) == 0 &&
+         MEMCMP(entry->hrp, hrp, hrpLen) == 0;
+}
+
+const addr_cache_entry_t *addr_cache_find(const addr_cache_t *cache,
+                                          const uint32_t *path,
+                                          uint8_t pathLen, const char *hrp,
+                                          uint8_t encoding) {
+  if (cache == NULL || path == NULL || hrp == NULL ||
+      pathLen > HDPATH_LEN_DEFAULT) {
+    return NULL;
+  }
+  const size_t hrpLen = strnlen(hrp, ADDR_CACHE_HRP_SIZE);
+  if (hrpLen == ADDR_CACHE_HRP_SIZE) {
+    return NULL;
+  }
+
+  for (uint8_t i = 0; i < ADDR_CACHE_ENTRIES; i++) {
+    const addr_cache_entry_t *entry = &cache->entries[i];
+    if (addr_cache_matches(entry, path, pathLen, hrp, hrpLen, encoding)) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+void addr_cache_store(addr_cache_t *cache, const uint32_t *path,
+                      uint8_t pathLen, const char *hrp, uint8_t encoding,
+                      const uint8_t *pubkey, const char *addr, size_t addrLen) {
+  if (cache == NULL || path == NULL || hrp == NULL || pubkey == NULL ||
+      addr == NULL || pathLen > HDPATH_LEN_DEFAULT ||
+      addrLen >= ADDR_CACHE_ADDR_SIZE) {
+    return;
+  }
+  const size_t hrpLen = strnlen(hrp, ADDR_CACHE_HRP_SIZE);
+  if (hrpLen == ADDR_CACHE_HRP_SIZE ||
+      addr_cache_find(cache, path, pathLen, hrp, encoding) != NULL) {
+    return;
+  }
+
+  addr_cache_entry_t *entry = &cache->entries[cache->next];
+  cache->next = (uint8_t)((cache->next + 1) % ADDR_CACHE_ENTRIES);
+
+  MEMZERO(entry, sizeof(*entry));
+  entry->encoding = encoding;
+  entry->pathLen = pathLen;
+  entry->hrpLen = (uint8_t)hrpLen;
+  entry->addrLen = (uint8_t)addrLen;
+  MEMCPY(entry->path, path, pathLen * sizeof(uint32_t));
+  MEMCPY(entry->hrp, hrp, hrpLen);
+  MEMCPY(entry->pubkey, pubkey, ADDR_CACHE_PUBKEY_LEN);
+  MEMCPY(entry->addr, addr, addrLen);
+  entry->used = true;
+}
+
+void addr_cache_clear(addr_cache_t *cache) {
+  if (cache == NULL) {
+    return;
+  }
+  MEMZERO(cache, sizeof(*cache));
+}
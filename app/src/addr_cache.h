@@ -0,0 +1,69 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "coin.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Public keys and addresses already derived in this session, keyed by path,
+// HRP and encoding. Entries are replaced in turn. Addresses of long HRPs do
+// not fit an entry and are derived every time.
+
+#define ADDR_CACHE_ENTRIES 4u
+#define ADDR_CACHE_HRP_SIZE 24u
+#define ADDR_CACHE_ADDR_SIZE 72u
+#define ADDR_CACHE_PUBKEY_LEN 33u
+
+typedef struct {
+  bool used;
+  uint8_t encoding;
+  uint8_t pathLen;
+  uint8_t hrpLen;
+  uint8_t addrLen;
+  uint32_t path[HDPATH_LEN_DEFAULT];
+  char hrp[ADDR_CACHE_HRP_SIZE];
+  uint8_t pubkey[ADDR_CACHE_PUBKEY_LEN];
+  char addr[ADDR_CACHE_ADDR_SIZE];
+} addr_cache_entry_t;
+
+typedef struct {
+  addr_cache_entry_t entries[ADDR_CACHE_ENTRIES];
+  // Entry replaced by the next store
+  uint8_t next;
+} addr_cache_t;
+
+/// Returns the entry of path, hrp and encoding, or NULL
+const addr_cache_entry_t *addr_cache_find(const addr_cache_t *cache,
+                                          const uint32_t *path,
+                                          uint8_t pathLen, const char *hrp,
+                                          uint8_t encoding);
+
+/// Keeps a compressed public key and its address, unless they do not fit
+void addr_cache_store(addr_cache_t *cache, const uint32_t *path,
+                      uint8_t pathLen, const char *hrp, uint8_t encoding,
+                      const uint8_t *pubkey, const char *addr, size_t addrLen);
+
+void addr_cache_clear(addr_cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
@@ -43,6 +43,12 @@
 
 tx_state_e g_tx_state = TX_STATE_IDLE;
 
+// P2 bits of INS_SIGN chunks, set on every chunk of an upload
+#define P2_COMPRESSED 0x80u
+#define P2_STREAMED 0x40u
+#define P2_UPLOAD_FLAGS (P2_COMPRESSED | P2_STREAMED)
+static uint8_t tx_upload_flags = 0;
+
 static const char *msg_error1 = "Expert Mode";
 static const char *msg_error2 = "Required";
 
@@ -144,6 +150,44 @@ static void extractHDPath_HRP(uint32_t rx, uint32_t offset) {
   }
 }
 
+static void append_chunk(uint32_t rx) {
+  // Every chunk of an upload must agree on how it is sent
+  if ((G_io_apdu_buffer[OFFSET_P2] & P2_UPLOAD_FLAGS) != tx_upload_flags) {
+    THROW(APDU_CODE_INVALIDP1P2);
+  }
+
+  // The signature covers the transaction as sent, which for a compressed
+  // upload is what it decompresses to
+  if ((tx_upload_flags & P2_COMPRESSED) == 0 &&
+      crypto_digestUpdate(&(G_io_apdu_buffer[OFFSET_DATA]), rx - OFFSET_DATA) !=
+          zxerr_ok) {
+    THROW(APDU_CODE_EXECUTION_ERROR);
+  }
+
+  if ((tx_upload_flags & P2_STREAMED) != 0) {
+    tx_append_streamed(&(G_io_apdu_buffer[OFFSET_DATA]), rx - OFFSET_DATA);
+    return;
+  }
+
+  if ((tx_upload_flags & P2_COMPRESSED) != 0) {
+    const zxerr_t err = tx_append_compressed(&(G_io_apdu_buffer[OFFSET_DATA]),
+                                             rx - OFFSET_DATA);
+    if (err == zxerr_buffer_too_small) {
+      THROW(APDU_CODE_TRANSACTION_DATA_EXCEEDS_BUFFER_CAPACITY);
+    }
+    if (err != zxerr_ok) {
+      THROW(APDU_CODE_DATA_INVALID);
+    }
+    return;
+  }
+
+  const uint32_t added =
+      tx_append(&(G_io_apdu_buffer[OFFSET_DATA]), rx - OFFSET_DATA);
+  if (added != rx - OFFSET_DATA) {
+    THROW(APDU_CODE_TRANSACTION_DATA_EXCEEDS_BUFFER_CAPACITY);
+  }
+}
+
 static bool process_chunk(volatile uint32_t *tx, uint32_t rx) {
   UNUSED(tx);
 
@@ -153,7 +197,6 @@ static bool process_chunk(volatile uint32_t *tx, uint32_t rx) {
     THROW(APDU_CODE_WRONG_LENGTH);
   }
 
-  uint32_t added;
   switch (payloadType) {
   case P1_INIT:
     if (g_tx_state != TX_STATE_IDLE) {
@@ -162,24 +205,36 @@ static bool process_chunk(volatile uint32_t *tx, uint32_t rx) {
     tx_initialize();
     tx_reset();
     extractHDPath_HRP(rx, OFFSET_DATA);
+    tx_upload_flags = G_io_apdu_buffer[OFFSET_P2] & P2_UPLOAD_FLAGS;
+    // Compressed chunks refer back to the transaction buffer, which a
+    // streamed upload does not keep
+    if (tx_upload_flags == P2_UPLOAD_FLAGS) {
+      THROW(APDU_CODE_INVALIDP1P2);
+    }
+    // Hashed with the hash of the chain resolved above
+    if (crypto_digestStart() != zxerr_ok) {
+      THROW(APDU_CODE_EXECUTION_ERROR);
+    }
+    if ((tx_upload_flags & P2_STREAMED) != 0) {
+      tx_stream_start();
+    }
     g_tx_state = TX_STATE_RECEIVING;
     return false;
   case P1_ADD:
     if (g_tx_state != TX_STATE_RECEIVING) {
       THROW(APDU_CODE_COMMAND_NOT_ALLOWED);
     }
-    added = tx_append(&(G_io_apdu_buffer[OFFSET_DATA]), rx - OFFSET_DATA);
-    if (added != rx - OFFSET_DATA) {
-      THROW(APDU_CODE_TRANSACTION_DATA_EXCEEDS_BUFFER_CAPACITY);
-    }
+    append_chunk(rx);
     return false;
   case P1_LAST:
     if (g_tx_state != TX_STATE_RECEIVING) {
       THROW(APDU_CODE_COMMAND_NOT_ALLOWED);
     }
-    added = tx_append(&(G_io_apdu_buffer[OFFSET_DATA]), rx - OFFSET_DATA);
-    if (added != rx - OFFSET_DATA) {
-      THROW(APDU_CODE_TRANSACTION_DATA_EXCEEDS_BUFFER_CAPACITY);
+    append_chunk(rx);
+    tx_flush();
+    if ((tx_upload_flags & P2_COMPRESSED) != 0 &&
+        tx_append_compressed_finish() != zxerr_ok) {
+      THROW(APDU_CODE_DATA_INVALID);
     }
     return true;
   }
@@ -223,6 +278,62 @@ __Z_INLINE void handleGetAddrSecp256K1(volatile uint32_t *flags,
   THROW(APDU_CODE_OK);
 }
 
+// Addresses of consecutive accounts or address indexes, so that account
+// discovery takes one request per few addresses. Nothing is shown.
+__Z_INLINE void handleGetAddrRangeSecp256K1(volatile uint32_t *tx,
+                                            uint32_t rx) {
+  if (g_tx_state != TX_STATE_IDLE) {
+    THROW(APDU_CODE_COMMAND_NOT_ALLOWED);
+  }
+  if (G_io_apdu_buffer[OFFSET_P1] != 0) {
+    THROW(APDU_CODE_INVALIDP1P2);
+  }
+
+  const uint8_t len = extractHRP(rx, OFFSET_DATA);
+  const uint32_t rangeOffset =
+      OFFSET_DATA + 1 + len + sizeof(uint32_t) * HDPATH_LEN_DEFAULT;
+  if (rx != rangeOffset + 2) {
+    THROW(APDU_CODE_WRONG_LENGTH);
+  }
+  extractHDPath(rangeOffset, OFFSET_DATA + 1 + len);
+
+  // The range starts at the path, and must stay within the limits of single
+  // addresses
+  const uint8_t level = G_io_apdu_buffer[rangeOffset];
+  const uint8_t count = G_io_apdu_buffer[rangeOffset + 1];
+  if ((level != HDPATH_ACCOUNT_LEVEL && level != HDPATH_INDEX_LEVEL) ||
+      count == 0) {
+    THROW(APDU_CODE_DATA_INVALID);
+  }
+  if (!app_mode_expert() && (hdPath[level] & 0x7FFFFFFF) + count - 1 > 100) {
+    THROW(APDU_CODE_INVALID_HD_PATH_VALUE);
+  }
+
+  encoding = checkChainConfig(hdPath[1], bech32_hrp, bech32_hrp_len);
+  if (encoding == UNSUPPORTED) {
+    ZEMU_LOGF(50, "Chain config not supported for: %s\n", bech32_hrp)
+    THROW(APDU_CODE_CHAIN_CONFIG_NOT_SUPPORTED);
+  }
+
+  MEMZERO(G_io_apdu_buffer, IO_APDU_BUFFER_SIZE);
+  uint16_t responseLen = 0;
+  if (crypto_fillAddressRange(G_io_apdu_buffer, IO_APDU_BUFFER_SIZE - 2,
+                              hdPath, level, count,
+                              &responseLen) != zxerr_ok) {
+    *tx = 0;
+    THROW(APDU_CODE_EXECUTION_ERROR);
+  }
+
+  *tx = responseLen;
+  THROW(APDU_CODE_OK);
+}
+
+// Wipes what a sign request keeps between its chunks and its approval
+static void sign_abort() {
+  crypto_digestStop();
+  crypto_signSessionEnd();
+}
+
 __Z_INLINE void handleSign(volatile uint32_t *flags, volatile uint32_t *tx,
                            uint32_t rx) {
   if (!process_chunk(tx, rx)) {
@@ -230,7 +341,8 @@ __Z_INLINE void handleSign(volatile uint32_t *flags, volatile uint32_t *tx,
   }
 
   // Let grab P2 value and if it's not valid, the parser should reject it
-  const tx_type_e sign_type = (tx_type_e)G_io_apdu_buffer[OFFSET_P2];
+  const tx_type_e sign_type =
+      (tx_type_e)(G_io_apdu_buffer[OFFSET_P2] & ~P2_UPLOAD_FLAGS);
 
   if ((hdPath[1] == HDPATH_ETH_1_DEFAULT) && !app_mode_expert()) {
     *flags |= IO_ASYNCH_REPLY;
@@ -238,16 +350,24 @@ __Z_INLINE void handleSign(volatile uint32_t *flags, volatile uint32_t *tx,
     THROW(APDU_CODE_DATA_INVALID);
   }
 
+  // The key is derived once, for the address below and for the signature
+  if (crypto_signSessionStart() != zxerr_ok) {
+    crypto_digestStop();
+    THROW(APDU_CODE_EXECUTION_ERROR);
+  }
+
   // Put address in output buffer, we will use it to confirm source address
   zxerr_t zxerr = app_fill_address();
   if (zxerr != zxerr_ok) {
     *tx = 0;
+    sign_abort();
     THROW(APDU_CODE_DATA_INVALID);
   }
 
   // Safety: ensure response contains more than just pubkey
   if (action_addrResponseLen <= PK_LEN_SECP256K1) {
     *tx = 0;
+    sign_abort();
     THROW(APDU_CODE_DATA_INVALID);
   }
 
@@ -257,11 +377,16 @@ __Z_INLINE void handleSign(volatile uint32_t *flags, volatile uint32_t *tx,
       action_addrResponseLen - PK_LEN_SECP256K1;
   const char *error_msg = tx_parse(sign_type);
   if (error_msg != NULL) {
+    sign_abort();
     const int error_msg_length = strnlen(error_msg, sizeof(G_io_apdu_buffer));
     MEMCPY(G_io_apdu_buffer, error_msg, error_msg_length);
     *tx += (error_msg_length);
     THROW(APDU_CODE_DATA_INVALID);
   }
+  if (crypto_digestFinish() != zxerr_ok) {
+    sign_abort();
+    THROW(APDU_CODE_EXECUTION_ERROR);
+  }
 
 #ifdef HAVE_SWAP
   if (G_swap_state.called_from_swap && G_swap_state.should_exit &&
@@ -282,11 +407,24 @@ __Z_INLINE void handleSign(volatile uint32_t *flags, volatile uint32_t *tx,
   *flags |= IO_ASYNCH_REPLY;
 }
 
+// Derived addresses are not kept across a lock of the device
+__Z_INLINE void check_pin_state() {
+  if (os_global_pin_is_validated() != BOLOS_TRUE) {
+    crypto_addrCacheClear();
+  }
+}
+
+// Ticker events keep coming while the lock screen is shown, so a lock is
+// noticed even when the device is unlocked again before the next APDU
+void app_ticker_event_callback(void) { check_pin_state(); }
+
 void handleApdu(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
   volatile uint16_t sw = 0;
 
   BEGIN_TRY {
     TRY {
+      check_pin_state();
+
       if (G_io_apdu_buffer[OFFSET_CLA] != CLA) {
         THROW(APDU_CODE_CLA_NOT_SUPPORTED);
       }
@@ -307,6 +445,12 @@ void handleApdu(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
         break;
       }
 
+      case INS_GET_ADDR_RANGE_SECP256K1: {
+        CHECK_PIN_VALIDATED()
+        handleGetAddrRangeSecp256K1(tx, rx);
+        break;
+      }
+
       case INS_SIGN_SECP256K1: {
         CHECK_PIN_VALIDATED()
         handleSign(flags, tx, rx);
@@ -319,6 +463,7 @@ void handleApdu(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
     }
     CATCH(EXCEPTION_IO_RESET) {
       g_tx_state = TX_STATE_IDLE;
+      sign_abort();
       THROW(EXCEPTION_IO_RESET);
     }
     CATCH_OTHER(e) {
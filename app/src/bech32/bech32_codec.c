@@ -0,0 +1,211 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "bech32_codec.h"
+#include "chain_config.h"
+#include <zxmacros.h>
+
+static const char bech32_charset[] = "qpzry9x8gf2tvdw0s3jn54khce6mua7l";
+
+// Charset position of each ASCII character, either case, -1 if not in it
+static const int8_t bech32_charset_rev[128] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    15, -1, 10, 17, 21, 20, 26, 30, 7, 5, -1, -1, -1, -1, -1, -1,
+    -1, 29, -1, 24, 13, 25, 9, 8, 23, -1, 18, 22, 31, 27, 19, -1,
+    1, 0, 3, 16, 11, 28, 12, 14, 6, 4, 2, -1, -1, -1, -1, -1,
+    -1, 29, -1, 24, 13, 25, 9, 8, 23, -1, 18, 22, 31, 27, 19, -1,
+    1, 0, 3, 16, 11, 28, 12, 14, 6, 4, 2, -1, -1, -1, -1, -1,
+};
+
+// XOR of the BIP173 generators selected by the five bits shifted out
+static const uint32_t bech32_polymod_table[32] = {
+    0x00000000u, 0x3b6a57b2u, 0x26508e6du, 0x1d3ad9dfu,
+    0x1ea119fau, 0x25cb4e48u, 0x38f19797u, 0x039bc025u,
+    0x3d4233ddu, 0x0628646fu, 0x1b12bdb0u, 0x2078ea02u,
+    0x23e32a27u, 0x18897d95u, 0x05b3a44au, 0x3ed9f3f8u,
+    0x2a1462b3u, 0x117e3501u, 0x0c44ecdeu, 0x372ebb6cu,
+    0x34b57b49u, 0x0fdf2cfbu, 0x12e5f524u, 0x298fa296u,
+    0x1756516eu, 0x2c3c06dcu, 0x3106df03u, 0x0a6c88b1u,
+    0x09f74894u, 0x329d1f26u, 0x2fa7c6f9u, 0x14cd914bu,
+};
+
+#define BECH32_CONST 1u
+
+__Z_INLINE uint32_t polymod_step(uint32_t chk, uint8_t value) {
+  const uint32_t *table = (const uint32_t *)PIC(bech32_polymod_table);
+  return ((chk & 0x1FFFFFFu) << 5u) ^ value ^ table[chk >> 25u];
+}
+
+__Z_INLINE bool is_upper(char c) { return c >= 'A' && c <= 'Z'; }
+
+__Z_INLINE bool is_lower(char c) { return c >= 'a' && c <= 'z'; }
+
+// Computed over the lowercase hrp, uppercase addresses share the checksum
+static uint32_t hrp_state_compute(const char *hrp, size_t hrpLen) {
+  uint32_t chk = 1;
+  for (size_t i = 0; i < hrpLen; i++) {
+    const char c = is_upper(hrp[i]) ? (char)(hrp[i] | 0x20) : hrp[i];
+    chk = polymod_step(chk, (uint8_t)c >> 5u);
+  }
+  chk = polymod_step(chk, 0);
+  for (size_t i = 0; i < hrpLen; i++) {
+    chk = polymod_step(chk, (uint8_t)hrp[i] & 0x1Fu);
+  }
+  return chk;
+}
+
+uint32_t bech32_hrp_state(const char *hrp, size_t hrpLen) {
+  if (hrpLen <= UINT8_MAX) {
+    const chain_info_t *chain = chain_config_by_hrp(hrp, (uint8_t)hrpLen);
+    if (chain != NULL) {
+      return chain->hrpChecksum;
+    }
+  }
+  return hrp_state_compute(hrp, hrpLen);
+}
+
+zxerr_t bech32_encode(char *out, size_t outLen, const char *hrp,
+                      size_t hrpLen, const uint8_t *data, size_t dataLen) {
+  if (out == NULL || hrp == NULL || (data == NULL && dataLen > 0) ||
+      hrpLen == 0) {
+    return zxerr_invalid_crypto_settings;
+  }
+  for (size_t i = 0; i < hrpLen; i++) {
+    if (hrp[i] < 33 || hrp[i] > 126 || is_upper(hrp[i])) {
+      return zxerr_invalid_crypto_settings;
+    }
+  }
+
+  const size_t groups = (dataLen * 8 + 4) / 5;
+  const size_t total = hrpLen + 1 + groups + BECH32_CHECKSUM_LEN;
+  if (total > BECH32_MAX_LEN || total >= outLen) {
+    return zxerr_buffer_too_small;
+  }
+
+  const char *charset = (const char *)PIC(bech32_charset);
+  MEMCPY(out, hrp, hrpLen);
+  char *pos = out + hrpLen;
+  *pos++ = '1';
+
+  // Groups go to the output and the checksum as they are cut from the bytes
+  uint32_t chk = bech32_hrp_state(hrp, hrpLen);
+  uint32_t acc = 0;
+  uint8_t bits = 0;
+  for (size_t i = 0; i < dataLen; i++) {
+    acc = (acc << 8u) | data[i];
+    bits += 8;
+    while (bits >= 5) {
+      bits -= 5;
+      const uint8_t value = (acc >> bits) & 0x1Fu;
+      chk = polymod_step(chk, value);
+      *pos++ = charset[value];
+    }
+  }
+  if (bits > 0) {
+    const uint8_t value = (acc << (5u - bits)) & 0x1Fu;
+    chk = polymod_step(chk, value);
+    *pos++ = charset[value];
+  }
+
+  for (uint8_t i = 0; i < BECH32_CHECKSUM_LEN; i++) {
+    chk = polymod_step(chk, 0);
+  }
+  chk ^= BECH32_CONST;
+  for (uint8_t i = 0; i < BECH32_CHECKSUM_LEN; i++) {
+    *pos++ = charset[(chk >> (5u * (5u - i))) & 0x1Fu];
+  }
+  *pos = 0;
+  return zxerr_ok;
+}
+
+// Returns the hrp length, zero if the address is malformed
+static size_t bech32_check(const char *addr, size_t addrLen) {
+  if (addr == NULL || addrLen > BECH32_MAX_LEN ||
+      addrLen < 2 + BECH32_CHECKSUM_LEN) {
+    return 0;
+  }
+
+  // The separator is the last '1', the hrp may contain others
+  size_t hrpLen = addrLen;
+  bool lower = false;
+  bool upper = false;
+  for (size_t i = 0; i < addrLen; i++) {
+    const char c = addr[i];
+    if (c < 33 || c > 126) {
+      return 0;
+    }
+    lower |= is_lower(c);
+    upper |= is_upper(c);
+    if (c == '1') {
+      hrpLen = i;
+    }
+  }
+  if ((lower && upper) || hrpLen == 0 || hrpLen == addrLen ||
+      addrLen - hrpLen - 1 < BECH32_CHECKSUM_LEN) {
+    return 0;
+  }
+
+  const int8_t *rev = (const int8_t *)PIC(bech32_charset_rev);
+  uint32_t chk = upper ? hrp_state_compute(addr, hrpLen)
+                       : bech32_hrp_state(addr, hrpLen);
+  for (size_t i = hrpLen + 1; i < addrLen; i++) {
+    const int8_t value = rev[(uint8_t)addr[i]];
+    if (value < 0) {
+      return 0;
+    }
+    chk = polymod_step(chk, (uint8_t)value);
+  }
+  return chk == BECH32_CONST ? hrpLen : 0;
+}
+
+bool bech32_verify(const char *addr, size_t addrLen) {
+  return bech32_check(addr, addrLen) > 0;
+}
+
+zxerr_t bech32_decode(const char *addr, size_t addrLen, size_t *hrpLen,
+                      uint8_t *data, size_t dataSize, size_t *dataLen) {
+  if (hrpLen == NULL || data == NULL || dataLen == NULL) {
+    return zxerr_no_data;
+  }
+  *hrpLen = bech32_check(addr, addrLen);
+  if (*hrpLen == 0) {
+    return zxerr_encoding_failed;
+  }
+
+  const int8_t *rev = (const int8_t *)PIC(bech32_charset_rev);
+  const size_t end = addrLen - BECH32_CHECKSUM_LEN;
+  uint32_t acc = 0;
+  uint8_t bits = 0;
+  size_t len = 0;
+  for (size_t i = *hrpLen + 1; i < end; i++) {
+    acc = (acc << 5u) | (uint8_t)rev[(uint8_t)addr[i]];
+    bits += 5;
+    if (bits >= 8) {
+      bits -= 8;
+      if (len >= dataSize) {
+        return zxerr_buffer_too_small;
+      }
+      data[len++] = (uint8_t)(acc >> bits);
+    }
+  }
+  // Padding is shorter than a group and all zero
+  if (bits >= 5 || (acc & ((1u << bits) - 1u)) != 0) {
+    return zxerr_encoding_failed;
+  }
+  *dataLen = len;
+  return zxerr_ok;
+}
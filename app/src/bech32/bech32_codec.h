@@ -0,0 +1,54 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zxerror.h>
+
+// Bech32 (BIP173) encoding and checking. The checksum runs over the expanded
+// hrp and then the data; the hrp part is fixed per chain, so the state after
+// it is generated into chainConfig and only computed here for other hrps.
+// Each 5 bit group costs one lookup in a 32 entry table instead of testing
+// the five generator bits.
+
+#define BECH32_MAX_LEN 90u
+#define BECH32_CHECKSUM_LEN 6u
+
+/// Checksum state after the expanded hrp, as stored in chain_info_t
+uint32_t bech32_hrp_state(const char *hrp, size_t hrpLen);
+
+/// Encodes data as hrp1..., the same output as bech32EncodeFromBytes with
+/// padding and the bech32 constant
+zxerr_t bech32_encode(char *out, size_t outLen, const char *hrp,
+                      size_t hrpLen, const uint8_t *data, size_t dataLen);
+
+/// Checks case, charset, length and checksum of an address
+bool bech32_verify(const char *addr, size_t addrLen);
+
+/// Verifies an address and converts its data back to bytes
+/// \param hrpLen length of the hrp at the start of addr
+zxerr_t bech32_decode(const char *addr, size_t addrLen, size_t *hrpLen,
+                      uint8_t *data, size_t dataSize, size_t *dataLen);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,266 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "textual_cbor.h"
+#include "common/parser.h"
+#include <zxmacros.h>
+
+#define CBOR_MAJOR_UINT 0u
+#define CBOR_MAJOR_NINT 1u
+#define CBOR_MAJOR_TEXT 3u
+#define CBOR_MAJOR_ARRAY 4u
+#define CBOR_MAJOR_MAP 5u
+#define CBOR_MAJOR_SIMPLE 7u
+
+#define CBOR_AI_UINT8 24u
+#define CBOR_AI_UINT64 27u
+#define CBOR_AI_INDEFINITE 31u
+
+#define CBOR_SIMPLE_FALSE 20u
+#define CBOR_SIMPLE_TRUE 21u
+
+#define TEXTUAL_ENVELOPE_KEY 1u
+#define TEXTUAL_SCREEN_MAX_FIELDS 4u
+
+typedef struct {
+  uint8_t major;
+  uint64_t arg;
+} cbor_head_t;
+
+// Reads the initial byte and its argument. Arguments must use the shortest
+// form, so every value has a single encoding.
+static parser_error_t read_head(textual_cbor_t *decoder, cbor_head_t *head) {
+  if (decoder->ptr >= decoder->end) {
+    return parser_cbor_unexpected_EOF;
+  }
+
+  const uint8_t initial = *decoder->ptr++;
+  head->major = initial >> 5;
+  const uint8_t info = initial & 0x1F;
+
+  if (info < CBOR_AI_UINT8) {
+    head->arg = info;
+    return parser_ok;
+  }
+  if (info == CBOR_AI_INDEFINITE && head->major != CBOR_MAJOR_SIMPLE) {
+    return parser_cbor_unexpected;
+  }
+  if (info > CBOR_AI_UINT64) {
+    return parser_cbor_unexpected;
+  }
+
+  // 1, 2, 4 or 8 bytes, big endian
+  const uint8_t size = (uint8_t)(1u << (info - CBOR_AI_UINT8));
+  if ((size_t)(decoder->end - decoder->ptr) < size) {
+    return parser_cbor_unexpected_EOF;
+  }
+  uint64_t arg = 0;
+  for (uint8_t i = 0; i < size; i++) {
+    arg = (arg << 8) | *decoder->ptr++;
+  }
+
+  // A shorter head could hold the value: below 24 for one byte, otherwise
+  // below the limit of the previous size
+  const uint64_t lowest =
+      size == 1 ? CBOR_AI_UINT8 : (uint64_t)1 << (4u * size);
+  if (arg < lowest) {
+    return parser_cbor_not_canonical;
+  }
+  // Simple values 24..31 are reserved, and floats are not expected here
+  if (head->major == CBOR_MAJOR_SIMPLE) {
+    return parser_unexpected_type;
+  }
+
+  head->arg = arg;
+  return parser_ok;
+}
+
+static parser_error_t read_text(textual_cbor_t *decoder, char **ptr,
+                                size_t *len) {
+  cbor_head_t head;
+  CHECK_PARSER_ERR(read_head(decoder, &head))
+  if (head.major != CBOR_MAJOR_TEXT) {
+    return parser_context_mismatch;
+  }
+  if (head.arg > MAX_CONTENT_SIZE) {
+    return parser_unexpected_value;
+  }
+  if ((uint64_t)(decoder->end - decoder->ptr) < head.arg) {
+    return parser_cbor_unexpected_EOF;
+  }
+
+  *ptr = (char *)decoder->ptr;
+  *len = (size_t)head.arg;
+  decoder->ptr += head.arg;
+  return parser_ok;
+}
+
+static parser_error_t read_key(textual_cbor_t *decoder, uint64_t *key) {
+  cbor_head_t head;
+  CHECK_PARSER_ERR(read_head(decoder, &head))
+  if (head.major != CBOR_MAJOR_UINT) {
+    return parser_unexpected_type;
+  }
+  *key = head.arg;
+  return parser_ok;
+}
+
+parser_error_t textual_cbor_init(textual_cbor_t *decoder, const uint8_t *buffer,
+                                 size_t bufferLen) {
+  if (decoder == NULL || buffer == NULL) {
+    return parser_unexpected_value;
+  }
+  decoder->ptr = buffer;
+  decoder->end = buffer + bufferLen;
+  return parser_ok;
+}
+
+parser_error_t textual_cbor_enter_screens(textual_cbor_t *decoder,
+                                          uint8_t *screenCount) {
+  if (decoder == NULL || screenCount == NULL) {
+    return parser_unexpected_value;
+  }
+
+  // Make sure we have a map/struct, holding only the screens
+  cbor_head_t head;
+  CHECK_PARSER_ERR(read_head(decoder, &head))
+  if (head.major != CBOR_MAJOR_MAP) {
+    return parser_unexpected_type;
+  }
+  if (head.arg != 1) {
+    return parser_unexpected_number_items;
+  }
+
+  // Make sure we have screen_key set to 1
+  uint64_t key = 0;
+  CHECK_PARSER_ERR(read_key(decoder, &key))
+  if (key != TEXTUAL_ENVELOPE_KEY) {
+    return parser_unexpected_type;
+  }
+
+  // Make sure we have an array of containers and check size
+  CHECK_PARSER_ERR(read_head(decoder, &head))
+  if (head.major != CBOR_MAJOR_ARRAY) {
+    return parser_unexpected_type;
+  }
+  if (head.arg == 0 || head.arg > TEXTUAL_MAX_SCREENS) {
+    return parser_unexpected_number_items;
+  }
+
+  *screenCount = (uint8_t)head.arg;
+  return parser_ok;
+}
+
+parser_error_t textual_cbor_read_screen(textual_cbor_t *decoder,
+                                        screen_arg_t *screen) {
+  if (decoder == NULL || screen == NULL) {
+    return parser_unexpected_value;
+  }
+  MEMZERO(screen, sizeof(*screen));
+
+  cbor_head_t head;
+  CHECK_PARSER_ERR(read_head(decoder, &head))
+  if (head.major != CBOR_MAJOR_MAP) {
+    return parser_unexpected_type;
+  }
+  if (head.arg == 0 || head.arg > TEXTUAL_SCREEN_MAX_FIELDS) {
+    return parser_unexpected_value;
+  }
+  const uint8_t fields = (uint8_t)head.arg;
+
+  // Title is optional, content is not. Omitted fields are never encoded
+  // with their default value.
+  uint64_t key = 0;
+  CHECK_PARSER_ERR(read_key(decoder, &key))
+  uint8_t read = 1;
+  if (key == TITLE_KEY_ID) {
+    CHECK_PARSER_ERR(read_text(decoder, &screen->titlePtr, &screen->titleLen))
+    if (screen->titleLen == 0) {
+      return parser_cbor_not_canonical;
+    }
+    if (read == fields) {
+      return parser_unexpected_type;
+    }
+    CHECK_PARSER_ERR(read_key(decoder, &key))
+    read++;
+  }
+  if (key != CONTENT_KEY_ID) {
+    return parser_unexpected_type;
+  }
+  CHECK_PARSER_ERR(
+      read_text(decoder, &screen->contentPtr, &screen->contentLen))
+
+  // Screens without a title never showed the indent of their last field,
+  // and the recorded screens rely on it
+  const uint8_t lastIndented = screen->titlePtr == NULL ? fields - 1 : fields;
+
+  for (; read < fields; read++) {
+    // Keys are unique and sorted
+    const uint64_t previousKey = key;
+    CHECK_PARSER_ERR(read_key(decoder, &key))
+    if (key <= previousKey) {
+      return parser_cbor_not_canonical;
+    }
+    CHECK_PARSER_ERR(read_head(decoder, &head))
+
+    switch (key) {
+    case INDENT_KEY_ID:
+      if (head.major == CBOR_MAJOR_NINT) {
+        return parser_unexpected_value;
+      }
+      if (head.major != CBOR_MAJOR_UINT) {
+        return parser_unexpected_type;
+      }
+      if (head.arg > UINT8_MAX) {
+        return parser_unexpected_value;
+      }
+      if (head.arg == 0) {
+        return parser_cbor_not_canonical;
+      }
+      if (read < lastIndented) {
+        screen->indent = (uint8_t)head.arg;
+      }
+      break;
+
+    case EXPERT_KEY_ID:
+      if (head.major != CBOR_MAJOR_SIMPLE ||
+          (head.arg != CBOR_SIMPLE_FALSE && head.arg != CBOR_SIMPLE_TRUE)) {
+        return parser_unexpected_type;
+      }
+      if (head.arg == CBOR_SIMPLE_FALSE) {
+        return parser_cbor_not_canonical;
+      }
+      screen->expert = true;
+      break;
+
+    default:
+      return parser_unexpected_value;
+    }
+  }
+
+  return parser_ok;
+}
+
+parser_error_t textual_cbor_finish(const textual_cbor_t *decoder) {
+  if (decoder == NULL) {
+    return parser_unexpected_value;
+  }
+
+  // End of buffer does not match end of parsed data
+  if (decoder->ptr != decoder->end) {
+    return parser_cbor_unexpected_EOF;
+  }
+  return parser_ok;
+}
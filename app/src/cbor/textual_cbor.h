@@ -0,0 +1,62 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "parser_txdef.h"
+#include <common/parser_common.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Decoder for the textual sign doc, which only ever is
+//
+//   {1: [{1: title, 2: content, 3: indent, 4: expert}, ...]}
+//
+// with title, indent and expert optional. Items are read straight from their
+// heads and strings are returned as pointers into the buffer.
+//
+// Only the canonical encoding is accepted, checked during the same walk:
+// shortest heads, definite lengths, sorted keys and no field holding its
+// default value (empty title, zero indent, expert false). A sign doc thus
+// has a single encoding.
+
+typedef struct {
+  const uint8_t *ptr;
+  const uint8_t *end;
+} textual_cbor_t;
+
+/// Starts decoding a textual sign doc held in buffer
+parser_error_t textual_cbor_init(textual_cbor_t *decoder, const uint8_t *buffer,
+                                 size_t bufferLen);
+
+/// Reads the envelope up to the array of screens and returns its length
+parser_error_t textual_cbor_enter_screens(textual_cbor_t *decoder,
+                                          uint8_t *screenCount);
+
+/// Reads the next screen. Title and content point into the buffer and are
+/// not terminated.
+parser_error_t textual_cbor_read_screen(textual_cbor_t *decoder,
+                                        screen_arg_t *screen);
+
+/// Checks that the whole buffer was consumed
+parser_error_t textual_cbor_finish(const textual_cbor_t *decoder);
+
+#ifdef __cplusplus
+}
+#endif
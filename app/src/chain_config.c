@@ -17,42 +17,75 @@
 
 #include <zxmacros.h>
 
-typedef struct {
-  const uint32_t path;
-  const char *hrp;
-  const address_encoding_e encoding;
-} chain_config_t;
-
-// To enable custom config for a new chain, just add a new entry in this array
-// with path, hrp and encoding
-static const chain_config_t chainConfig[] = {
-    {118, "cosmos", BECH32_COSMOS},   {60, "inj", BECH32_ETH},
-    {60, "evmos", BECH32_ETH},        {60, "xpla", BECH32_ETH},
-    {60, "dym", BECH32_ETH},          {60, "zeta", BECH32_ETH},
-    {60, "bera", BECH32_ETH},         {60, "human", BECH32_ETH},
-    {118, "osmo", BECH32_COSMOS},     {118, "dydx", BECH32_COSMOS},
-    {118, "mantra", BECH32_COSMOS},   {118, "xion", BECH32_COSMOS},
-    {118, "celestia", BECH32_COSMOS}, {118, "core", BECH32_COSMOS},
-    {118, "neutron", BECH32_COSMOS}};
-
-static const uint32_t chainConfigLen =
-    sizeof(chainConfig) / sizeof(chainConfig[0]);
+// To enable a new chain, add it to scripts/gen_chain_config.py and regenerate
+// this table
+#include "chain_config_table.h"
 
-address_encoding_e checkChainConfig(uint32_t path, const char *hrp,
-                                    uint8_t hrpLen) {
+// FNV-1a, folded so the low bits used as slot index depend on the whole key.
+// Must match chain_hash in scripts/gen_chain_config.py
+static uint32_t chain_config_hash(uint32_t seed, const char *key,
+                                  uint8_t keyLen) {
+  uint32_t h = 0x811C9DC5u ^ seed;
+  for (uint8_t i = 0; i < keyLen; i++) {
+    h ^= (uint8_t)key[i];
+    h *= 0x01000193u;
+  }
+  return h ^ (h >> 16);
+}
+
+const chain_info_t *chain_config_default(void) {
+  return &chainConfig[CHAIN_CONFIG_DEFAULT_IDX];
+}
+
+const chain_info_t *chain_config_by_hrp(const char *hrp, uint8_t hrpLen) {
   if (hrp == NULL || hrpLen == 0) {
-    return UNSUPPORTED;
+    return NULL;
+  }
+
+  const uint32_t slot = chain_config_hash(CHAIN_CONFIG_HRP_SEED, hrp, hrpLen) &
+                        (CHAIN_CONFIG_HRP_SLOTS - 1);
+  const uint8_t entry = chainConfigHrpSlots[slot];
+  if (entry == 0) {
+    return NULL;
   }
 
-  for (uint32_t i = 0; i < chainConfigLen; i++) {
-    if (path == (0x80000000u | chainConfig[i].path)) {
-      const char *hrpPtr = (const char *)PIC(chainConfig[i].hrp);
-      const uint16_t hrpPtrLen = strlen(hrpPtr);
-      if (hrpPtrLen == hrpLen && memcmp(hrpPtr, hrp, hrpLen) == 0) {
-        return chainConfig[i].encoding;
-      }
-    }
+  const chain_info_t *chain = &chainConfig[entry - 1];
+  if (chain->hrpLen != hrpLen ||
+      memcmp(PIC(chain->hrp), hrp, hrpLen) != 0) {
+    return NULL;
+  }
+  return chain;
+}
+
+const chain_info_t *chain_config_by_chain_id(const char *chainId,
+                                             uint8_t chainIdLen) {
+  if (chainId == NULL || chainIdLen == 0) {
+    return NULL;
+  }
+
+  const uint32_t slot =
+      chain_config_hash(CHAIN_CONFIG_CHAINID_SEED, chainId, chainIdLen) &
+      (CHAIN_CONFIG_CHAINID_SLOTS - 1);
+  const uint8_t entry = chainConfigChainIdSlots[slot];
+  if (entry == 0) {
+    return NULL;
+  }
+
+  const chain_info_t *chain = &chainConfig[entry - 1];
+  const char *id = (const char *)PIC(chain->chainId);
+  if (strnlen(id, chainIdLen + 1) != chainIdLen ||
+      memcmp(id, chainId, chainIdLen) != 0) {
+    return NULL;
+  }
+  return chain;
+}
+
+address_encoding_e checkChainConfig(uint32_t path, const char *hrp,
+                                    uint8_t hrpLen) {
+  const chain_info_t *chain = chain_config_by_hrp(hrp, hrpLen);
+  if (chain == NULL || path != (0x80000000u | chain->coinType)) {
+    return UNSUPPORTED;
   }
 
-  return UNSUPPORTED;
+  return chain->encoding;
 }
@@ -23,9 +23,37 @@ extern "C" {
 #include <stdbool.h>
 #include <stdint.h>
 
+typedef struct {
+  uint32_t coinType; // BIP44 coin type, without the hardened bit
+  const char *hrp;
+  uint8_t hrpLen;
+  // Bech32 checksum state after the expanded hrp, see bech32_codec.h
+  uint32_t hrpChecksum;
+  address_encoding_e encoding;
+  // Chain id and tickers are NULL for chains that are not supported in swap
+  const char *chainId;
+  const char *ticker;
+  const char *expertTicker;
+  uint8_t decimals;
+  bool isDefault;
+} chain_info_t;
+
+/// Returns the address encoding for a (coin type, hrp) pair
+/// \param path hardened BIP44 coin type
+/// \return UNSUPPORTED if the pair is not registered
 address_encoding_e checkChainConfig(uint32_t path, const char *hrp,
                                     uint8_t hrpLen);
 
+/// Returns the default chain (Cosmos Hub)
+const chain_info_t *chain_config_default(void);
+
+/// Looks up a chain by hrp, NULL if it is not registered
+const chain_info_t *chain_config_by_hrp(const char *hrp, uint8_t hrpLen);
+
+/// Looks up a chain by chain id, NULL if it is not registered
+const chain_info_t *chain_config_by_chain_id(const char *chainId,
+                                             uint8_t chainIdLen);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,47 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+// Generated by scripts/gen_chain_config.py. Do not edit.
+#pragma once
+
+#include "chain_config.h"
+
+#define CHAIN_CONFIG_HRP_SEED 10u
+#define CHAIN_CONFIG_HRP_SLOTS 32u
+#define CHAIN_CONFIG_CHAINID_SEED 0u
+#define CHAIN_CONFIG_CHAINID_SLOTS 16u
+#define CHAIN_CONFIG_DEFAULT_IDX 0u
+
+static const chain_info_t chainConfig[] = {
+    {118, "cosmos", 6, 0x3F302B3Fu, BECH32_COSMOS, "cosmoshub-4", "ATOM", "uatom", 6, true},
+    {60, "inj", 3, 0x04DD1573u, BECH32_ETH, NULL, NULL, NULL, 0, false},
+    {60, "evmos", 5, 0x025A0849u, BECH32_ETH, NULL, NULL, NULL, 0, false},
+    {60, "xpla", 4, 0x1778AED8u, BECH32_ETH, NULL, NULL, NULL, 0, false},
+    {60, "dym", 3, 0x04DD2394u, BECH32_ETH, NULL, NULL, NULL, 0, false},
+    {60, "zeta", 4, 0x1779F9D8u, BECH32_ETH, NULL, NULL, NULL, 0, false},
+    {60, "bera", 4, 0x1775F918u, BECH32_ETH, NULL, NULL, NULL, 0, false},
+    {60, "human", 5, 0x028B8994u, BECH32_ETH, NULL, NULL, NULL, 0, false},
+    {118, "osmo", 4, 0x177322F6u, BECH32_COSMOS, "osmosis-1", "OSMO", "uosmo", 6, false},
+    {118, "dydx", 4, 0x17768BC1u, BECH32_COSMOS, "dydx-mainnet-1", "DYDX", "adydx", 18, false},
+    {118, "mantra", 6, 0x23DECC8Du, BECH32_COSMOS, "mantra-1", "OM", "uom", 6, false},
+    {118, "xion", 4, 0x1778CAB7u, BECH32_COSMOS, "xion-mainnet-1", "XION", "uxion", 6, false},
+    {118, "celestia", 8, 0x222C1511u, BECH32_COSMOS, "celestia", "TIA", "utia", 6, false},
+    {118, "core", 4, 0x1775511Cu, BECH32_COSMOS, NULL, NULL, NULL, 0, false},
+    {118, "neutron", 7, 0x0D405E0Bu, BECH32_COSMOS, NULL, NULL, NULL, 0, false},
+};
+
+// Slot -> chainConfig index + 1, zero for empty slots
+static const uint8_t chainConfigHrpSlots[32] = {12, 0, 0, 11, 0, 0, 0, 6, 0, 0, 3, 9, 7, 0, 4, 10, 2, 0, 13, 0, 5, 0, 8, 1, 0, 0, 0, 0, 14, 15, 0, 0};
+static const uint8_t chainConfigChainIdSlots[16] = {0, 0, 10, 1, 0, 11, 0, 0, 12, 0, 9, 0, 0, 13, 0, 0};
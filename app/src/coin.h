@@ -28,6 +28,10 @@ extern "C" {
 #define HDPATH_2_DEFAULT (0x80000000u | 0u)
 #define HDPATH_3_DEFAULT (0u)
 
+// Levels an address range can vary
+#define HDPATH_ACCOUNT_LEVEL 2u
+#define HDPATH_INDEX_LEVEL 4u
+
 #define PK_LEN_SECP256K1 33u
 #define PK_LEN_SECP256K1_UNCOMPRESSED 65u
 
@@ -35,7 +39,7 @@ typedef enum {
   addr_secp256k1 = 0,
 } address_kind_e;
 
-typedef enum { tx_json = 0, tx_textual } tx_type_e;
+typedef enum { tx_json = 0, tx_textual, tx_direct } tx_type_e;
 
 typedef enum {
   BECH32_COSMOS = 0,
@@ -51,13 +55,6 @@ typedef enum {
 #define APPVERSION_LINE1 "Version:"
 #define APPVERSION_LINE2 ("v" APPVERSION)
 
-#define COIN_DEFAULT_CHAINID "cosmoshub-4"
-#define OSMOSIS_CHAINID "osmosis-1"
-#define DYDX_CHAINID "dydx-mainnet-1"
-#define MANTRA_CHAINID "mantra-1"
-#define XION_CHAINID "xion-mainnet-1"
-#define CELESTIA_CHAINID "celestia"
-
 // In non-expert mode, the app will convert from uatom to ATOM
 #define COIN_DEFAULT_DENOM_BASE "uatom"
 #define COIN_DEFAULT_DENOM_REPR "ATOM"
@@ -85,6 +82,7 @@ typedef enum {
 #define INS_GET_VERSION 0x00
 #define INS_SIGN_SECP256K1 0x02u
 #define INS_GET_ADDR_SECP256K1 0x04u
+#define INS_GET_ADDR_RANGE_SECP256K1 0x05u
 
 // Custom errors
 #define APDU_CODE_TRANSACTION_DATA_EXCEEDS_BUFFER_CAPACITY 0x6988
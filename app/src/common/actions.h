@@ -59,6 +59,7 @@ __Z_INLINE zxerr_t app_fill_address() {
       G_io_apdu_buffer, IO_APDU_BUFFER_SIZE - 2, &action_addrResponseLen);
 
   if (err != zxerr_ok || action_addrResponseLen == 0) {
+    crypto_signSessionEnd();
     THROW(APDU_CODE_EXECUTION_ERROR);
   }
 
@@ -67,6 +68,8 @@ __Z_INLINE zxerr_t app_fill_address() {
 
 __Z_INLINE void app_reject() {
   g_tx_state = TX_STATE_IDLE;
+  crypto_digestStop();
+  crypto_signSessionEnd();
   MEMZERO(G_io_apdu_buffer, IO_APDU_BUFFER_SIZE);
   set_code(G_io_apdu_buffer, 0, APDU_CODE_COMMAND_NOT_ALLOWED);
   io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, 2);
@@ -46,10 +46,20 @@ extern "C" {
 
 const char *parser_getErrorDescription(parser_error_t err);
 
+//// wipes what the previous parse wrote into a tx object
+void parser_reset(parser_tx_t *tx_obj);
+
 //// parses a tx buffer
 parser_error_t parser_parse(parser_context_t *ctx, const uint8_t *data,
                             size_t dataLen, parser_tx_t *tx_obj);
 
+//// finishes a streamed SIGN_MODE_DIRECT tx, data holds the fields it kept.
+//// tx_obj is the object the stream indexed into, and is not reset.
+parser_error_t parser_parseDirectStream(parser_context_t *ctx,
+                                       const uint8_t *data, size_t dataLen,
+                                       tx_direct_stream_t *stream,
+                                       parser_tx_t *tx_obj);
+
 //// verifies tx fields
 parser_error_t parser_validate(const parser_context_t *ctx);
 
@@ -63,6 +73,21 @@ parser_error_t parser_getItem(const parser_context_t *ctx, uint8_t displayIdx,
                               uint16_t outValLen, uint8_t pageIdx,
                               uint8_t *pageCount);
 
+// one field of a run read by parser_getItems, rendered at page pageIdx
+typedef struct {
+  char *key;
+  uint16_t keyLen;
+  char *val;
+  uint16_t valLen;
+  uint8_t pageIdx;
+  uint8_t pageCount;
+} parser_item_t;
+
+// retrieves count consecutive fields starting at firstIdx, as parser_getItem
+// would, for pages that show several fields at once
+parser_error_t parser_getItems(const parser_context_t *ctx, uint8_t firstIdx,
+                               uint8_t count, parser_item_t *items);
+
 #ifdef __cplusplus
 }
 #endif
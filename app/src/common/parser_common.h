@@ -34,6 +34,10 @@ extern "C" {
       return __err;                                                            \
   }
 
+#define PARSER_ASSERT_OR_ERROR(CALL, ERROR)                                    \
+  if (!(CALL))                                                                 \
+    return ERROR;
+
 typedef enum {
   // Generic errors
   parser_ok = 0,
@@ -75,6 +79,9 @@ typedef enum {
   parser_cbor_unexpected,
   parser_cbor_unexpected_EOF,
   parser_cbor_not_canonical,
+  // protobuf
+  parser_proto_unexpected_wire_type,
+  parser_proto_unexpected_EOF,
   // context
   parser_context_mismatch,
   parser_context_unexpected_size,
@@ -16,8 +16,11 @@
 
 #include "tx.h"
 #include "apdu_codes.h"
-#include "buffering.h"
+#include "compress/lz_decoder.h"
+#include "crypto.h"
+#include "nvm/nvm_cache.h"
 #include "parser.h"
+#include "tx_direct_stream.h"
 #include "zxmacros.h"
 #include <string.h>
 
@@ -32,6 +35,10 @@
 #elif defined(TARGET_NANOX)
 #define RAM_BUFFER_SIZE 7168
 #define FLASH_BUFFER_SIZE 16384
+#elif !defined(LEDGER_SPECIFIC)
+// Host builds, with the sizes of the target reported by host/include/os.h
+#define RAM_BUFFER_SIZE 8192
+#define FLASH_BUFFER_SIZE 16384
 #endif
 
 // Ram
@@ -43,44 +50,133 @@ typedef struct {
 } storage_t;
 
 #if defined(LEDGER_SPECIFIC)
-storage_t NV_CONST N_appdata_impl __attribute__((aligned(64)));
+storage_t NV_CONST N_appdata_impl
+    __attribute__((aligned(NVM_CACHE_PAGE_SIZE)));
 #define N_appdata (*(NV_VOLATILE storage_t *)PIC(&N_appdata_impl))
+#else
+static storage_t N_appdata;
 #endif
 
 parser_context_t ctx_parsed_tx;
 
+// Chunks are staged in RAM and written to flash a page at a time
+static nvm_cache_t tx_buffer;
+
+// Compressed uploads are decoded into this buffer, then appended in pieces of
+// about the size of a plain chunk
+#define INFLATE_BUFFER_SIZE 256
+static uint8_t inflate_buffer[INFLATE_BUFFER_SIZE];
+static lz_decoder_t inflate_decoder;
+
+// Streamed uploads are indexed into tx_obj as they arrive
+static tx_direct_stream_t direct_stream;
+static bool tx_streaming = false;
+static parser_tx_t tx_obj;
+
+static void tx_nvm_write(uint8_t *dst, const uint8_t *src, uint32_t len) {
+  MEMCPY_NV(dst, (void *)src, len);
+}
+
 void tx_initialize() {
-  buffering_init(ram_buffer, sizeof(ram_buffer), (uint8_t *)N_appdata.buffer,
-                 sizeof(((storage_t *)0)->buffer));
+  nvm_cache_init(&tx_buffer, ram_buffer, sizeof(ram_buffer),
+                 (uint8_t *)N_appdata.buffer, sizeof(((storage_t *)0)->buffer),
+                 tx_nvm_write);
 }
 
-void tx_reset() { buffering_reset(); }
+void tx_reset() {
+  nvm_cache_reset(&tx_buffer);
+  lz_decoder_init(&inflate_decoder);
+  tx_streaming = false;
+}
 
 uint32_t tx_append(unsigned char *buffer, uint32_t length) {
-  return buffering_append(buffer, length);
+  return nvm_cache_append(&tx_buffer, buffer, length);
 }
 
-uint32_t tx_get_buffer_length() { return buffering_get_buffer()->pos; }
+void tx_flush() { nvm_cache_flush(&tx_buffer); }
+
+zxerr_t tx_append_compressed(const uint8_t *buffer, uint32_t length) {
+  size_t offset = 0;
+  size_t produced = 0;
+  do {
+    size_t consumed = 0;
+    // Back references read the transaction buffer, which may move from RAM
+    // to flash while appending. Reading it writes out the staged page.
+    const parser_error_t err = lz_decode(
+        &inflate_decoder, buffer + offset, length - offset, &consumed,
+        tx_get_buffer(), tx_get_buffer_length(), inflate_buffer,
+        sizeof(inflate_buffer), &produced);
+    if (err != parser_ok) {
+      return zxerr_encoding_failed;
+    }
+    if (consumed == 0 && produced == 0) {
+      break;
+    }
+    offset += consumed;
+    if (produced > 0 &&
+        tx_append(inflate_buffer, (uint32_t)produced) != produced) {
+      return zxerr_buffer_too_small;
+    }
+    // Hashed as decompressed, which is what gets signed
+    CHECK_ZXERR(crypto_digestUpdate(inflate_buffer, (uint32_t)produced))
+  } while (offset < length || produced == sizeof(inflate_buffer));
 
-uint8_t *tx_get_buffer() { return buffering_get_buffer()->data; }
+  return offset == length ? zxerr_ok : zxerr_encoding_failed;
+}
 
-static parser_tx_t tx_obj;
+zxerr_t tx_append_compressed_finish() {
+  if (lz_decoder_finish(&inflate_decoder) != parser_ok) {
+    return zxerr_encoding_failed;
+  }
+  return zxerr_ok;
+}
+
+static uint32_t tx_stream_keep(const uint8_t *data, uint32_t len) {
+  return nvm_cache_append(&tx_buffer, data, len);
+}
+
+void tx_stream_start() {
+  tx_streaming = true;
+  parser_reset(&tx_obj);
+  tx_obj.tx_type = tx_direct;
+  tx_direct_stream_init(&direct_stream, &tx_obj.tx_direct, tx_stream_keep);
+}
+
+void tx_append_streamed(const uint8_t *buffer, uint32_t length) {
+  // The first error is kept by the stream
+  (void)tx_direct_stream_feed(&direct_stream, buffer, length);
+}
+
+uint32_t tx_get_buffer_length() { return nvm_cache_length(&tx_buffer); }
+
+uint8_t *tx_get_buffer() { return (uint8_t *)nvm_cache_data(&tx_buffer); }
 
 const char *tx_parse(tx_type_e type) {
 #if defined(COMPILE_TEXTUAL)
-  if (type != tx_json && type != tx_textual) {
+  if (type != tx_json && type != tx_textual && type != tx_direct) {
     return parser_getErrorDescription(parser_value_out_of_range);
   }
 #else
-  if (type != tx_json) {
+  if (type != tx_json && type != tx_direct) {
     return parser_getErrorDescription(parser_value_out_of_range);
   }
 #endif
 
-  MEMZERO(&tx_obj, sizeof(tx_obj));
-  tx_obj.tx_type = type;
-  uint8_t err = parser_parse(&ctx_parsed_tx, tx_get_buffer(),
-                             tx_get_buffer_length(), &tx_obj);
+  uint8_t err = parser_ok;
+  if (tx_streaming) {
+    // Only protobuf transactions can be read as they arrive
+    if (type != tx_direct) {
+      return parser_getErrorDescription(parser_unexpected_type);
+    }
+    err = parser_parseDirectStream(&ctx_parsed_tx, tx_get_buffer(),
+                                   tx_get_buffer_length(), &direct_stream,
+                                   &tx_obj);
+  } else {
+    parser_reset(&tx_obj);
+    tx_obj.tx_type = type;
+    err = parser_parse(&ctx_parsed_tx, tx_get_buffer(), tx_get_buffer_length(),
+                       &tx_obj);
+  }
   zemu_log_stack("parse|parsed");
 
   if (err != parser_ok) {
@@ -119,7 +215,7 @@ const char *tx_parse(tx_type_e type) {
   return NULL;
 }
 
-void tx_parse_reset() { MEMZERO(&tx_obj, sizeof(tx_obj)); }
+void tx_parse_reset() { parser_reset(&tx_obj); }
 
 zxerr_t tx_getNumItems(uint8_t *num_items) {
   parser_error_t err = parser_getNumItems(&ctx_parsed_tx, num_items);
@@ -156,3 +252,18 @@ zxerr_t tx_getItem(int8_t displayIdx, char *outKey, uint16_t outKeyLen,
 
   return zxerr_ok;
 }
+
+zxerr_t tx_getItems(uint8_t firstIdx, uint8_t count, parser_item_t *items) {
+  const parser_error_t err =
+      parser_getItems(&ctx_parsed_tx, firstIdx, count, items);
+
+  // Convert error codes
+  if (err == parser_no_data || err == parser_display_idx_out_of_range ||
+      err == parser_display_page_out_of_range)
+    return zxerr_no_data;
+
+  if (err != parser_ok)
+    return zxerr_unknown;
+
+  return zxerr_ok;
+}
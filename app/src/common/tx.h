@@ -17,8 +17,13 @@
 
 #include "coin.h"
 #include "os.h"
+#include "parser.h"
 #include "zxerror.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void tx_initialize();
 
 /// Clears the transaction buffer
@@ -31,6 +36,27 @@ void tx_reset();
 /// \return It returns an error message if the buffer is too small.
 uint32_t tx_append(unsigned char *buffer, uint32_t length);
 
+/// Writes chunks still staged in RAM to flash, see nvm/nvm_cache.h. Reading
+/// the buffer also does it.
+void tx_flush();
+
+/// Decompresses a chunk of a compressed upload and appends the output, see
+/// compress/lz_decoder.h. The stream restarts with tx_reset.
+/// \return zxerr_buffer_too_small if the output does not fit, or
+/// zxerr_encoding_failed if the chunk is malformed.
+zxerr_t tx_append_compressed(const uint8_t *buffer, uint32_t length);
+
+/// Checks that a compressed upload ended on a whole token
+zxerr_t tx_append_compressed_finish();
+
+/// Starts a streamed upload of a SIGN_MODE_DIRECT transaction, see
+/// tx_direct_stream.h. Only the fields shown are kept in the transaction
+/// buffer, and the caller hashes the chunks as they arrive.
+void tx_stream_start();
+
+/// Reads a chunk of a streamed upload. Errors are reported by tx_parse.
+void tx_append_streamed(const uint8_t *buffer, uint32_t length);
+
 /// Returns size of the raw json transaction buffer
 /// \return
 uint32_t tx_get_buffer_length();
@@ -52,3 +78,11 @@ zxerr_t tx_getTextualNumItems(uint8_t *num_items);
 zxerr_t tx_getItem(int8_t displayIdx, char *outKey, uint16_t outKeyLen,
                    char *outValue, uint16_t outValueLen, uint8_t pageIdx,
                    uint8_t *pageCount);
+
+/// Gets count consecutive items from the transaction, each at the page it
+/// asks for. Views that show several items per page read them at once.
+zxerr_t tx_getItems(uint8_t firstIdx, uint8_t count, parser_item_t *items);
+
+#ifdef __cplusplus
+}
+#endif
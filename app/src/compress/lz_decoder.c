@@ -0,0 +1,166 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "lz_decoder.h"
+#include <zxmacros.h>
+
+// Fragments of canonical amino JSON: the sign doc skeleton, the messages of
+// value_substitutions in tx_parser.c with their fields, and common values.
+// Encoders must use the exact same bytes, so this table can only be extended
+// together with a new P2 flag.
+static const char lz_dictionary_data[] =
+    "\"voter\":\"cosmos1"
+    "\"option\":\""
+    "\"proposal_id\":\""
+    "\"depositor\":\"cosmos1"
+    "\"initial_deposit\":[{\"amount\":\""
+    "\"proposer\":\"cosmos1"
+    "\"content\":{\"type\":\"cosmos-sdk/TextProposal\",\"value\":"
+    "{\"description\":\""
+    "\",\"title\":\""
+    "{\"type\":\"cosmos-sdk/MsgVote\",\"value\":{"
+    "{\"type\":\"cosmos-sdk/MsgDeposit\",\"value\":{"
+    "{\"type\":\"cosmos-sdk/MsgSubmitProposal\",\"value\":{"
+    "{\"type\":\"cosmos-sdk/MsgMultiSend\",\"value\":{\"inputs\":[{"
+    "\"outputs\":[{\"address\":\"cosmos1"
+    "\"coins\":[{\"amount\":\""
+    "{\"type\":\"cosmos-sdk/MsgSetWithdrawAddress\",\"value\":{"
+    "\"withdraw_address\":\"cosmos1"
+    "{\"type\":\"cosmos-sdk/MsgWithdrawValidatorCommission\",\"value\":{"
+    "{\"type\":\"cosmos-sdk/MsgBeginRedelegate\",\"value\":{"
+    "\"validator_dst_address\":\"cosmosvaloper1"
+    "\"validator_src_address\":\"cosmosvaloper1"
+    "{\"type\":\"cosmos-sdk/MsgUndelegate\",\"value\":{"
+    "{\"type\":\"cosmos-sdk/MsgSend\",\"value\":{\"amount\":[{\"amount\":\""
+    "\",\"from_address\":\"cosmos1"
+    "\",\"to_address\":\"cosmos1"
+    "\",\"granter\":\"cosmos1"
+    "\",\"payer\":\"cosmos1"
+    "\"}],\"gas\":\"200000\"},\"memo\":\"\",\"msgs\":["
+    "{\"type\":\"cosmos-sdk/MsgDelegate\",\"value\":{\"amount\":{\"amount\":\""
+    "{\"type\":\"cosmos-sdk/MsgWithdrawDelegationReward\",\"value\":{"
+    "\"delegator_address\":\"cosmos1"
+    "\",\"validator_address\":\"cosmosvaloper1"
+    "\"}},"
+    "\",\"denom\":\"uatom\"}"
+    "],\"sequence\":\""
+    "{\"account_number\":\""
+    "\",\"chain_id\":\"cosmoshub-4\",\"fee\":{\"amount\":[{\"amount\":\"";
+
+#define LZ_DICTIONARY_LEN (sizeof(lz_dictionary_data) - 1)
+
+const uint8_t *lz_dictionary(size_t *len) {
+  if (len != NULL) {
+    *len = LZ_DICTIONARY_LEN;
+  }
+  return (const uint8_t *)PIC(lz_dictionary_data);
+}
+
+void lz_decoder_init(lz_decoder_t *decoder) {
+  if (decoder == NULL) {
+    return;
+  }
+  MEMZERO(decoder, sizeof(*decoder));
+  decoder->state = lz_state_token;
+}
+
+parser_error_t lz_decode(lz_decoder_t *decoder, const uint8_t *in,
+                         size_t inLen, size_t *consumed, const uint8_t *history,
+                         size_t historyLen, uint8_t *out, size_t outLen,
+                         size_t *produced) {
+  if (decoder == NULL || consumed == NULL || produced == NULL ||
+      (in == NULL && inLen > 0) || (history == NULL && historyLen > 0) ||
+      out == NULL) {
+    return parser_unexpected_value;
+  }
+
+  const uint8_t *dictionary = (const uint8_t *)PIC(lz_dictionary_data);
+  size_t inPos = 0;
+  size_t outPos = 0;
+
+  while (outPos < outLen) {
+    if (decoder->state == lz_state_match) {
+      // Copy one byte at a time, matches may overlap their own output
+      const size_t position = LZ_DICTIONARY_LEN + historyLen + outPos;
+      const size_t source = position - decoder->distance;
+      if (source < LZ_DICTIONARY_LEN) {
+        out[outPos] = dictionary[source];
+      } else if (source - LZ_DICTIONARY_LEN < historyLen) {
+        out[outPos] = history[source - LZ_DICTIONARY_LEN];
+      } else {
+        out[outPos] = out[source - LZ_DICTIONARY_LEN - historyLen];
+      }
+      outPos++;
+      decoder->length--;
+      if (decoder->length == 0) {
+        decoder->state = lz_state_token;
+      }
+      continue;
+    }
+
+    if (inPos >= inLen) {
+      break;
+    }
+    const uint8_t byte = in[inPos++];
+
+    switch (decoder->state) {
+    case lz_state_token:
+      if (byte < LZ_MAX_LITERALS) {
+        decoder->length = byte + 1;
+        decoder->state = lz_state_literals;
+      } else {
+        decoder->length = (byte & 0x7Fu) + LZ_MIN_MATCH;
+        decoder->state = lz_state_distance_hi;
+      }
+      break;
+    case lz_state_literals:
+      out[outPos++] = byte;
+      decoder->length--;
+      if (decoder->length == 0) {
+        decoder->state = lz_state_token;
+      }
+      break;
+    case lz_state_distance_hi:
+      decoder->distance = (uint16_t)(byte << 8u);
+      decoder->state = lz_state_distance_lo;
+      break;
+    case lz_state_distance_lo: {
+      decoder->distance |= byte;
+      const size_t available = LZ_DICTIONARY_LEN + historyLen + outPos;
+      if (decoder->distance == 0 || decoder->distance > available) {
+        return parser_value_out_of_range;
+      }
+      decoder->state = lz_state_match;
+      break;
+    }
+    default:
+      return parser_unexpected_error;
+    }
+  }
+
+  *consumed = inPos;
+  *produced = outPos;
+  return parser_ok;
+}
+
+parser_error_t lz_decoder_finish(const lz_decoder_t *decoder) {
+  if (decoder == NULL) {
+    return parser_unexpected_value;
+  }
+  if (decoder->state != lz_state_token) {
+    return parser_unexpected_buffer_end;
+  }
+  return parser_ok;
+}
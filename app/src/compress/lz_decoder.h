@@ -0,0 +1,78 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <common/parser_common.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Decoder for compressed transaction uploads. The format is an LZ77 variant
+// whose window is primed with a preset dictionary of amino JSON fragments,
+// so even the first occurrence of a key or message type is a back reference.
+//
+// The stream is a sequence of tokens:
+//   0x00 - 0x7F  literal run, the next (c + 1) bytes are output as they are
+//   0x80 - 0xFF  match of (c & 0x7F) + LZ_MIN_MATCH bytes, followed by a two
+//                byte big endian distance, 1 <= distance
+//
+// Distances count back from the current output position. Reaching past the
+// start of the output continues into the end of the dictionary. Tokens may
+// be split across calls, so chunks can be decoded as they arrive.
+
+#define LZ_MIN_MATCH 3u
+#define LZ_MAX_MATCH (0x7Fu + LZ_MIN_MATCH)
+#define LZ_MAX_LITERALS 0x80u
+#define LZ_MAX_DISTANCE 0xFFFFu
+
+typedef enum {
+  lz_state_token = 0,
+  lz_state_literals,
+  lz_state_distance_hi,
+  lz_state_distance_lo,
+  lz_state_match,
+} lz_state_e;
+
+typedef struct {
+  uint8_t state;
+  // Literal or match bytes still to output
+  uint8_t length;
+  uint16_t distance;
+} lz_decoder_t;
+
+/// Starts a new stream
+void lz_decoder_init(lz_decoder_t *decoder);
+
+/// Decodes input into out until the input is consumed or out is full. history
+/// is the output of previous calls, which out continues; the caller flushes
+/// out and calls again while out comes back full.
+parser_error_t lz_decode(lz_decoder_t *decoder, const uint8_t *in,
+                         size_t inLen, size_t *consumed, const uint8_t *history,
+                         size_t historyLen, uint8_t *out, size_t outLen,
+                         size_t *produced);
+
+/// Checks that the stream ended on a token boundary
+parser_error_t lz_decoder_finish(const lz_decoder_t *decoder);
+
+/// Preset dictionary, shared with encoders
+const uint8_t *lz_dictionary(size_t *len);
+
+#ifdef __cplusplus
+}
+#endif
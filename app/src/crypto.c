@@ -16,12 +16,14 @@
 
 #include "crypto.h"
 #include "apdu_codes.h"
+#include "addr_cache.h"
 #include "coin.h"
+#include "key_session.h"
 #include "tx.h"
 #include "zxmacros.h"
 
+#include "bech32/bech32_codec.h"
 #include "chain_config.h"
-#include <bech32.h>
 
 #define MAX_DER_SIGNATURE_LEN 73u
 
@@ -33,26 +35,39 @@ address_encoding_e encoding = BECH32_COSMOS;
 
 #include "cx.h"
 
-static zxerr_t crypto_extractUncompressedPublicKey(uint8_t *pubKey,
-                                                   uint16_t pubKeyLen,
-                                                   uint32_t *hdPath_to_use,
-                                                   uint16_t hdPath_to_use_len) {
-  if (pubKey == NULL || pubKeyLen < PK_LEN_SECP256K1_UNCOMPRESSED) {
-    return zxerr_invalid_crypto_settings;
-  }
+// Key of the sign request being reviewed
+static key_session_t sign_session;
 
-  cx_ecfp_public_key_t cx_publicKey = {0};
-  cx_ecfp_private_key_t cx_privateKey = {0};
+static zxerr_t crypto_derivePrivateKey(const uint32_t *path, uint8_t pathLen,
+                                       uint8_t *privateKey) {
   uint8_t privateKeyData[64] = {0};
-
   zxerr_t error = zxerr_unknown;
-  // Generate keys
   CATCH_CXERROR(os_derive_bip32_with_seed_no_throw(
-      HDW_NORMAL, CX_CURVE_256K1, hdPath_to_use, hdPath_to_use_len,
-      privateKeyData, NULL, NULL, 0));
+      HDW_NORMAL, CX_CURVE_256K1, (uint32_t *)path, pathLen, privateKeyData,
+      NULL, NULL, 0));
+  MEMCPY(privateKey, privateKeyData, KEY_SESSION_KEY_LEN);
+  error = zxerr_ok;
+
+catch_cx_error:
+  MEMZERO(privateKeyData, sizeof(privateKeyData));
+  return error;
+}
 
+zxerr_t crypto_signSessionStart() {
+  return key_session_start(&sign_session, hdPath, HDPATH_LEN_DEFAULT,
+                           crypto_derivePrivateKey);
+}
+
+void crypto_signSessionEnd() { key_session_end(&sign_session); }
+
+// Uncompressed public key of a private key
+static zxerr_t crypto_publicKeyOf(const uint8_t *privateKey, uint8_t *pubKey) {
+  cx_ecfp_public_key_t cx_publicKey = {0};
+  cx_ecfp_private_key_t cx_privateKey = {0};
+
+  zxerr_t error = zxerr_unknown;
   CATCH_CXERROR(cx_ecfp_init_private_key_no_throw(
-      CX_CURVE_256K1, privateKeyData, 32, &cx_privateKey));
+      CX_CURVE_256K1, privateKey, 32, &cx_privateKey));
   CATCH_CXERROR(
       cx_ecfp_init_public_key_no_throw(CX_CURVE_256K1, NULL, 0, &cx_publicKey));
   CATCH_CXERROR(cx_ecfp_generate_pair_no_throw(CX_CURVE_256K1, &cx_publicKey,
@@ -62,6 +77,32 @@ static zxerr_t crypto_extractUncompressedPublicKey(uint8_t *pubKey,
 
 catch_cx_error:
   MEMZERO(&cx_privateKey, sizeof(cx_privateKey));
+  return error;
+}
+
+static zxerr_t crypto_extractUncompressedPublicKey(uint8_t *pubKey,
+                                                   uint16_t pubKeyLen,
+                                                   uint32_t *hdPath_to_use,
+                                                   uint16_t hdPath_to_use_len) {
+  if (pubKey == NULL || pubKeyLen < PK_LEN_SECP256K1_UNCOMPRESSED) {
+    return zxerr_invalid_crypto_settings;
+  }
+
+  uint8_t privateKeyData[64] = {0};
+
+  zxerr_t error = zxerr_unknown;
+  // Generate keys, unless the sign request already did
+  const uint8_t *sessionKey = key_session_get(&sign_session, hdPath_to_use,
+                                              (uint8_t)hdPath_to_use_len);
+  if (sessionKey != NULL) {
+    MEMCPY(privateKeyData, sessionKey, KEY_SESSION_KEY_LEN);
+  } else if (crypto_derivePrivateKey(hdPath_to_use, (uint8_t)hdPath_to_use_len,
+                                     privateKeyData) != zxerr_ok) {
+    goto catch_cx_error;
+  }
+  error = crypto_publicKeyOf(privateKeyData, pubKey);
+
+catch_cx_error:
   MEMZERO(privateKeyData, sizeof(privateKeyData));
 
   if (error != zxerr_ok) {
@@ -84,54 +125,99 @@ __Z_INLINE zxerr_t compressPubkey(const uint8_t *pubkey, uint16_t pubkeyLen,
   return zxerr_ok;
 }
 
-static zxerr_t crypto_hashBuffer(const uint8_t *input, const uint16_t inputLen,
-                                 uint8_t *output, uint16_t outputLen) {
+// Hash of the transaction being uploaded, updated as chunks arrive so that
+// signing does not read the transaction buffer again
+typedef struct {
+  bool active;
+  bool finished;
+  address_encoding_e encoding;
+  union {
+    cx_sha256_t sha256;
+    cx_sha3_t keccak;
+  };
+  uint8_t value[CX_SHA256_SIZE];
+} crypto_digest_t;
+
+static crypto_digest_t digest;
+
+__Z_INLINE cx_hash_t *crypto_digestHash() {
+  return digest.encoding == BECH32_ETH ? &digest.keccak.header
+                                       : &digest.sha256.header;
+}
 
+zxerr_t crypto_digestStart() {
+  MEMZERO(&digest, sizeof(digest));
   switch (encoding) {
-  case BECH32_COSMOS: {
-    cx_hash_sha256(input, inputLen, output, outputLen);
+  case BECH32_COSMOS:
+    CHECK_CX_OK(cx_sha256_init_no_throw(&digest.sha256));
     break;
+  case BECH32_ETH:
+    CHECK_CX_OK(cx_keccak_init_no_throw(&digest.keccak, 256));
+    break;
+  default:
+    return zxerr_unknown;
   }
+  digest.encoding = encoding;
+  digest.active = true;
+  return zxerr_ok;
+}
 
-  case BECH32_ETH: {
-    CHECK_CX_OK(cx_keccak_256_hash(input, inputLen, output));
-    break;
+zxerr_t crypto_digestUpdate(const uint8_t *data, uint32_t len) {
+  if (!digest.active || (data == NULL && len > 0)) {
+    return zxerr_unknown;
   }
+  CHECK_CX_OK(cx_hash_no_throw(crypto_digestHash(), 0, data, len, NULL, 0));
+  return zxerr_ok;
+}
 
-  default:
+void crypto_digestStop() { MEMZERO(&digest, sizeof(digest)); }
+
+zxerr_t crypto_digestFinish() {
+  if (!digest.active) {
+    return zxerr_unknown;
+  }
+  const cx_err_t err = cx_hash_no_throw(crypto_digestHash(), CX_LAST, NULL, 0,
+                                        digest.value, sizeof(digest.value));
+  digest.active = false;
+  if (err != CX_OK) {
+    crypto_digestStop();
     return zxerr_unknown;
   }
+  digest.finished = true;
   return zxerr_ok;
 }
 
 zxerr_t crypto_sign(uint8_t *output, uint16_t outputLen, uint16_t *sigSize) {
   if (output == NULL || sigSize == NULL || outputLen < MAX_DER_SIGNATURE_LEN) {
+    crypto_signSessionEnd();
     return zxerr_invalid_crypto_settings;
   }
 
+  // Hashed while uploaded, the transaction buffer is not read again
+  if (!digest.finished) {
+    crypto_signSessionEnd();
+    return zxerr_unknown;
+  }
   uint8_t messageDigest[CX_SHA256_SIZE] = {0};
-
-  // Hash it
-  const uint8_t *message = tx_get_buffer();
-  const uint16_t messageLen = tx_get_buffer_length();
-
-  CHECK_ZXERR(
-      crypto_hashBuffer(message, messageLen, messageDigest, CX_SHA256_SIZE));
+  MEMCPY(messageDigest, digest.value, sizeof(messageDigest));
+  crypto_digestStop();
   CHECK_APP_CANARY()
 
   cx_ecfp_private_key_t cx_privateKey;
-  uint8_t privateKeyData[64] = {0};
   size_t signatureLength = MAX_DER_SIGNATURE_LEN;
   uint32_t tmpInfo = 0;
   *sigSize = 0;
 
   zxerr_t error = zxerr_unknown;
 
-  CATCH_CXERROR(os_derive_bip32_with_seed_no_throw(
-      HDW_NORMAL, CX_CURVE_256K1, hdPath, HDPATH_LEN_DEFAULT, privateKeyData,
-      NULL, NULL, 0));
+  // Derived when the request started, not again after approval
+  const uint8_t *sessionKey =
+      key_session_get(&sign_session, hdPath, HDPATH_LEN_DEFAULT);
+  if (sessionKey == NULL) {
+    goto catch_cx_error;
+  }
   CATCH_CXERROR(cx_ecfp_init_private_key_no_throw(
-      CX_CURVE_256K1, privateKeyData, 32, &cx_privateKey));
+      CX_CURVE_256K1, sessionKey, KEY_SESSION_KEY_LEN, &cx_privateKey));
   CATCH_CXERROR(cx_ecdsa_sign_no_throw(&cx_privateKey, CX_RND_RFC6979 | CX_LAST,
                                        CX_SHA256, messageDigest, CX_SHA256_SIZE,
                                        output, &signatureLength, &tmpInfo));
@@ -140,7 +226,7 @@ zxerr_t crypto_sign(uint8_t *output, uint16_t outputLen, uint16_t *sigSize) {
 
 catch_cx_error:
   MEMZERO(&cx_privateKey, sizeof(cx_privateKey));
-  MEMZERO(privateKeyData, sizeof(privateKeyData));
+  crypto_signSessionEnd();
 
   if (error != zxerr_ok) {
     MEMZERO(output, outputLen);
@@ -149,59 +235,111 @@ catch_cx_error:
   return error;
 }
 
-zxerr_t crypto_fillAddress_helper(uint8_t *buffer, uint16_t buffer_len,
-                                  uint16_t *addrResponseLen,
-                                  uint32_t *hdPath_to_use,
-                                  uint16_t hdPath_to_use_len) {
-  if (buffer == NULL || addrResponseLen == NULL || hdPath_to_use == NULL) {
-    return zxerr_unknown;
-  }
+// Addresses already derived in this session
+static addr_cache_t addr_cache;
 
-  if (buffer_len < PK_LEN_SECP256K1 + MIN_ADDRESS_BUFFER_SPACE) {
-    return zxerr_buffer_too_small;
-  }
+void crypto_addrCacheClear() { addr_cache_clear(&addr_cache); }
 
-  // extract pubkey
-  uint8_t uncompressedPubkey[PK_LEN_SECP256K1_UNCOMPRESSED] = {0};
-  CHECK_ZXERR(crypto_extractUncompressedPublicKey(
-      uncompressedPubkey, sizeof(uncompressedPubkey), hdPath_to_use,
-      hdPath_to_use_len));
-  CHECK_ZXERR(compressPubkey(uncompressedPubkey, sizeof(uncompressedPubkey),
-                             buffer, buffer_len));
-  char *addr = (char *)(buffer + PK_LEN_SECP256K1);
+// Compressed public key and address of an uncompressed public key
+static zxerr_t crypto_encodeAddress(const uint8_t *uncompressedPubkey,
+                                    const char *hrp,
+                                    address_encoding_e encode_type,
+                                    uint8_t *pubkey, char *addr,
+                                    uint16_t addrLen) {
+  CHECK_ZXERR(compressPubkey(uncompressedPubkey,
+                             PK_LEN_SECP256K1_UNCOMPRESSED, pubkey,
+                             PK_LEN_SECP256K1));
 
   uint8_t hashed1_pk[CX_SHA256_SIZE] = {0};
 
-  switch (encoding) {
+  switch (encode_type) {
   case BECH32_COSMOS: {
     // Hash it
-    cx_hash_sha256(buffer, PK_LEN_SECP256K1, hashed1_pk, CX_SHA256_SIZE);
+    cx_hash_sha256(pubkey, PK_LEN_SECP256K1, hashed1_pk, CX_SHA256_SIZE);
     uint8_t hashed2_pk[CX_RIPEMD160_SIZE] = {0};
     CHECK_CX_OK(cx_ripemd160_hash(hashed1_pk, CX_SHA256_SIZE, hashed2_pk));
-    CHECK_ZXERR(bech32EncodeFromBytes(addr, buffer_len - PK_LEN_SECP256K1,
-                                      bech32_hrp, hashed2_pk, CX_RIPEMD160_SIZE,
-                                      1, BECH32_ENCODING_BECH32));
+    CHECK_ZXERR(bech32_encode(addr, addrLen, hrp, strlen(hrp), hashed2_pk,
+                              CX_RIPEMD160_SIZE));
     break;
   }
 
   case BECH32_ETH: {
     CHECK_CX_OK(cx_keccak_256_hash(
         uncompressedPubkey + PK_UNCOMPRESSED_FORMAT_PREFIX_LEN,
-        sizeof(uncompressedPubkey) - PK_UNCOMPRESSED_FORMAT_PREFIX_LEN,
+        PK_LEN_SECP256K1_UNCOMPRESSED - PK_UNCOMPRESSED_FORMAT_PREFIX_LEN,
         hashed1_pk));
-    CHECK_ZXERR(
-        bech32EncodeFromBytes(addr, buffer_len - PK_LEN_SECP256K1, bech32_hrp,
+    CHECK_ZXERR(bech32_encode(addr, addrLen, hrp, strlen(hrp),
                               hashed1_pk + ETH_ADDRESS_HASH_OFFSET,
-                              sizeof(hashed1_pk) - ETH_ADDRESS_HASH_OFFSET, 1,
-                              BECH32_ENCODING_BECH32));
+                              sizeof(hashed1_pk) - ETH_ADDRESS_HASH_OFFSET));
     break;
   }
 
   default:
-    *addrResponseLen = 0;
     return zxerr_encoding_failed;
   }
 
+  return zxerr_ok;
+}
+
+// Copies a cached public key and address
+static zxerr_t crypto_copyCached(const addr_cache_entry_t *cached,
+                                 uint8_t *pubkey, char *addr,
+                                 uint16_t addrLen) {
+  if (addrLen <= cached->addrLen) {
+    return zxerr_buffer_too_small;
+  }
+  MEMCPY(pubkey, cached->pubkey, PK_LEN_SECP256K1);
+  MEMCPY(addr, cached->addr, cached->addrLen);
+  addr[cached->addrLen] = '\0';
+  return zxerr_ok;
+}
+
+// Compressed public key and address of a path, from the cache when they were
+// derived before
+static zxerr_t crypto_pubkeyAndAddress(uint32_t *path, uint16_t pathLen,
+                                       const char *hrp,
+                                       address_encoding_e encode_type,
+                                       uint8_t *pubkey, char *addr,
+                                       uint16_t addrLen) {
+  const addr_cache_entry_t *cached =
+      addr_cache_find(&addr_cache, path, (uint8_t)pathLen, hrp, encode_type);
+  if (cached != NULL) {
+    return crypto_copyCached(cached, pubkey, addr, addrLen);
+  }
+
+  // extract pubkey
+  uint8_t uncompressedPubkey[PK_LEN_SECP256K1_UNCOMPRESSED] = {0};
+  CHECK_ZXERR(crypto_extractUncompressedPublicKey(
+      uncompressedPubkey, sizeof(uncompressedPubkey), path, pathLen));
+  CHECK_ZXERR(crypto_encodeAddress(uncompressedPubkey, hrp, encode_type,
+                                   pubkey, addr, addrLen));
+
+  addr_cache_store(&addr_cache, path, (uint8_t)pathLen, hrp, encode_type,
+                   pubkey, addr, strnlen(addr, addrLen));
+  return zxerr_ok;
+}
+
+zxerr_t crypto_fillAddress_helper(uint8_t *buffer, uint16_t buffer_len,
+                                  uint16_t *addrResponseLen,
+                                  uint32_t *hdPath_to_use,
+                                  uint16_t hdPath_to_use_len) {
+  if (buffer == NULL || addrResponseLen == NULL || hdPath_to_use == NULL) {
+    return zxerr_unknown;
+  }
+
+  if (buffer_len < PK_LEN_SECP256K1 + MIN_ADDRESS_BUFFER_SPACE) {
+    return zxerr_buffer_too_small;
+  }
+
+  char *addr = (char *)(buffer + PK_LEN_SECP256K1);
+  const zxerr_t err = crypto_pubkeyAndAddress(
+      hdPath_to_use, hdPath_to_use_len, bech32_hrp, encoding, buffer, addr,
+      buffer_len - PK_LEN_SECP256K1);
+  if (err != zxerr_ok) {
+    *addrResponseLen = 0;
+    return err;
+  }
+
   *addrResponseLen =
       PK_LEN_SECP256K1 + strnlen(addr, (buffer_len - PK_LEN_SECP256K1));
 
@@ -215,6 +353,169 @@ zxerr_t crypto_fillAddress(uint8_t *buffer, uint16_t buffer_len,
                                    HDPATH_LEN_DEFAULT);
 }
 
+#define BIP32_HARDENED 0x80000000u
+#define BIP32_KEY_LEN 32u
+
+// Private key and chain code of a BIP32 node
+typedef struct {
+  uint8_t key[BIP32_KEY_LEN];
+  uint8_t chainCode[BIP32_KEY_LEN];
+} crypto_bip32_node_t;
+
+static const uint8_t secp256k1_order[BIP32_KEY_LEN] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xBA, 0xAE, 0xDC, 0xE6, 0xAF, 0x48,
+    0xA0, 0x3B, 0xBF, 0xD2, 0x5E, 0x8C, 0xD0, 0x36, 0x41, 0x41};
+
+// Child of a private node, CKDpriv in BIP32
+static zxerr_t crypto_deriveChild(const crypto_bip32_node_t *parent,
+                                  uint32_t index, crypto_bip32_node_t *child) {
+  uint8_t data[PK_LEN_SECP256K1 + sizeof(uint32_t)] = {0};
+  uint8_t digest512[2 * BIP32_KEY_LEN] = {0};
+  zxerr_t error = zxerr_unknown;
+
+  if ((index & BIP32_HARDENED) != 0) {
+    MEMCPY(data + 1, parent->key, BIP32_KEY_LEN);
+  } else {
+    uint8_t uncompressedPubkey[PK_LEN_SECP256K1_UNCOMPRESSED] = {0};
+    if (crypto_publicKeyOf(parent->key, uncompressedPubkey) != zxerr_ok ||
+        compressPubkey(uncompressedPubkey, sizeof(uncompressedPubkey), data,
+                       PK_LEN_SECP256K1) != zxerr_ok) {
+      goto catch_cx_error;
+    }
+  }
+  data[PK_LEN_SECP256K1] = (uint8_t)(index >> 24);
+  data[PK_LEN_SECP256K1 + 1] = (uint8_t)(index >> 16);
+  data[PK_LEN_SECP256K1 + 2] = (uint8_t)(index >> 8);
+  data[PK_LEN_SECP256K1 + 3] = (uint8_t)index;
+
+  if (cx_hmac_sha512(parent->chainCode, BIP32_KEY_LEN, data, sizeof(data),
+                     digest512, sizeof(digest512)) != sizeof(digest512)) {
+    goto catch_cx_error;
+  }
+
+  // The left half must be below the order and the key must not be zero,
+  // which BIP32 leaves to the next index
+  int diff = 0;
+  bool isZero = false;
+  CATCH_CXERROR(
+      cx_math_cmp_no_throw(digest512, secp256k1_order, BIP32_KEY_LEN, &diff));
+  if (diff >= 0) {
+    goto catch_cx_error;
+  }
+  CATCH_CXERROR(cx_math_addm_no_throw(child->key, digest512, parent->key,
+                                      secp256k1_order, BIP32_KEY_LEN));
+  CATCH_CXERROR(cx_math_is_zero_no_throw(child->key, BIP32_KEY_LEN, &isZero));
+  if (isZero) {
+    goto catch_cx_error;
+  }
+  MEMCPY(child->chainCode, digest512 + BIP32_KEY_LEN, BIP32_KEY_LEN);
+  error = zxerr_ok;
+
+catch_cx_error:
+  MEMZERO(data, sizeof(data));
+  MEMZERO(digest512, sizeof(digest512));
+  if (error != zxerr_ok) {
+    MEMZERO(child, sizeof(*child));
+  }
+  return error;
+}
+
+zxerr_t crypto_fillAddressRange(uint8_t *buffer, uint16_t bufferLen,
+                                const uint32_t *path, uint8_t level,
+                                uint8_t count, uint16_t *responseLen) {
+  if (buffer == NULL || path == NULL || responseLen == NULL ||
+      level == 0 || level >= HDPATH_LEN_DEFAULT || count == 0 ||
+      bufferLen < 1 ||
+      (path[level] & ~BIP32_HARDENED) + (count - 1u) >= BIP32_HARDENED) {
+    return zxerr_unknown;
+  }
+  *responseLen = 0;
+
+  crypto_bip32_node_t parent = {0};
+  crypto_bip32_node_t node = {0};
+  crypto_bip32_node_t child = {0};
+  uint8_t privateKeyData[64] = {0};
+  uint32_t childPath[HDPATH_LEN_DEFAULT] = {0};
+  MEMCPY(childPath, path, sizeof(childPath));
+
+  zxerr_t error = zxerr_unknown;
+  // Only the levels below the node above level are derived for each child
+  CATCH_CXERROR(os_derive_bip32_with_seed_no_throw(
+      HDW_NORMAL, CX_CURVE_256K1, childPath, level, privateKeyData,
+      parent.chainCode, NULL, 0));
+  MEMCPY(parent.key, privateKeyData, BIP32_KEY_LEN);
+
+  uint16_t offset = 1;
+  uint8_t filled = 0;
+  for (; filled < count; filled++) {
+    childPath[level] = path[level] + filled;
+
+    // Public key, address length and address, as many as fit
+    uint8_t *pubkey = buffer + offset;
+    const uint16_t entryHeader = PK_LEN_SECP256K1 + 1;
+    if (bufferLen - offset <= entryHeader) {
+      break;
+    }
+    char *addr = (char *)(pubkey + entryHeader);
+    const uint16_t addrLen = bufferLen - offset - entryHeader;
+
+    const addr_cache_entry_t *cached = addr_cache_find(
+        &addr_cache, childPath, HDPATH_LEN_DEFAULT, bech32_hrp, encoding);
+    if (cached != NULL) {
+      if (crypto_copyCached(cached, pubkey, addr, addrLen) != zxerr_ok) {
+        break;
+      }
+    } else {
+      uint8_t uncompressedPubkey[PK_LEN_SECP256K1_UNCOMPRESSED] = {0};
+      if (crypto_deriveChild(&parent, childPath[level], &node) != zxerr_ok) {
+        goto catch_cx_error;
+      }
+      for (uint8_t l = level + 1; l < HDPATH_LEN_DEFAULT; l++) {
+        if (crypto_deriveChild(&node, childPath[l], &child) != zxerr_ok) {
+          goto catch_cx_error;
+        }
+        MEMCPY(&node, &child, sizeof(node));
+      }
+      if (crypto_publicKeyOf(node.key, uncompressedPubkey) != zxerr_ok) {
+        goto catch_cx_error;
+      }
+      const zxerr_t err = crypto_encodeAddress(uncompressedPubkey, bech32_hrp,
+                                               encoding, pubkey, addr, addrLen);
+      if (err == zxerr_buffer_too_small) {
+        break;
+      }
+      if (err != zxerr_ok) {
+        goto catch_cx_error;
+      }
+      addr_cache_store(&addr_cache, childPath, HDPATH_LEN_DEFAULT, bech32_hrp,
+                       encoding, pubkey, addr, strnlen(addr, addrLen));
+    }
+
+    const uint8_t len = (uint8_t)strnlen(addr, addrLen);
+    pubkey[PK_LEN_SECP256K1] = len;
+    offset += entryHeader + len;
+  }
+  if (filled == 0) {
+    error = zxerr_buffer_too_small;
+    goto catch_cx_error;
+  }
+
+  buffer[0] = filled;
+  *responseLen = offset;
+  error = zxerr_ok;
+
+catch_cx_error:
+  MEMZERO(&parent, sizeof(parent));
+  MEMZERO(&node, sizeof(node));
+  MEMZERO(&child, sizeof(child));
+  MEMZERO(privateKeyData, sizeof(privateKeyData));
+  if (error != zxerr_ok) {
+    MEMZERO(buffer, bufferLen);
+  }
+  return error;
+}
+
 // Fill address using a hd path coming from check_address_parameters_t
 zxerr_t crypto_swap_fillAddress(uint32_t *hdPath_swap, uint8_t hdPathLen_swap,
                                 char *hrp, address_encoding_e encode_type,
@@ -228,44 +529,13 @@ zxerr_t crypto_swap_fillAddress(uint32_t *hdPath_swap, uint8_t hdPathLen_swap,
     return zxerr_buffer_too_small;
   }
 
-  // extract pubkey
-  uint8_t uncompressedPubkey[PK_LEN_SECP256K1_UNCOMPRESSED] = {0};
   uint8_t compressedPubkey[PK_LEN_SECP256K1] = {0};
-  CHECK_ZXERR(crypto_extractUncompressedPublicKey(uncompressedPubkey,
-                                                  sizeof(uncompressedPubkey),
-                                                  hdPath_swap, hdPathLen_swap));
-  CHECK_ZXERR(compressPubkey(uncompressedPubkey, sizeof(uncompressedPubkey),
-                             compressedPubkey, sizeof(compressedPubkey)));
-
-  uint8_t hashed1_pk[CX_SHA256_SIZE] = {0};
-  switch (encode_type) {
-  case BECH32_COSMOS: {
-    // Hash it
-    cx_hash_sha256(compressedPubkey, PK_LEN_SECP256K1, hashed1_pk,
-                   CX_SHA256_SIZE);
-    uint8_t hashed2_pk[CX_RIPEMD160_SIZE] = {0};
-    CHECK_CX_OK(cx_ripemd160_hash(hashed1_pk, CX_SHA256_SIZE, hashed2_pk));
-    CHECK_ZXERR(bech32EncodeFromBytes(buffer, bufferLen, hrp, hashed2_pk,
-                                      CX_RIPEMD160_SIZE, 1,
-                                      BECH32_ENCODING_BECH32));
-    break;
-  }
-
-  case BECH32_ETH: {
-    CHECK_CX_OK(cx_keccak_256_hash(
-        uncompressedPubkey + PK_UNCOMPRESSED_FORMAT_PREFIX_LEN,
-        sizeof(uncompressedPubkey) - PK_UNCOMPRESSED_FORMAT_PREFIX_LEN,
-        hashed1_pk));
-    CHECK_ZXERR(bech32EncodeFromBytes(
-        buffer, bufferLen, hrp, hashed1_pk + ETH_ADDRESS_HASH_OFFSET,
-        sizeof(hashed1_pk) - ETH_ADDRESS_HASH_OFFSET, 1,
-        BECH32_ENCODING_BECH32));
-    break;
-  }
-
-  default:
+  const zxerr_t err =
+      crypto_pubkeyAndAddress(hdPath_swap, hdPathLen_swap, hrp, encode_type,
+                              compressedPubkey, buffer, bufferLen);
+  if (err != zxerr_ok) {
     *addrResponseLen = 0;
-    return zxerr_encoding_failed;
+    return err;
   }
 
   *addrResponseLen = strnlen(buffer, bufferLen);
@@ -46,6 +46,41 @@ extern address_encoding_e encoding;
 zxerr_t crypto_fillAddress(uint8_t *buffer, uint16_t bufferLen,
                            uint16_t *addrResponseLen);
 
+/// Fills the public keys and addresses of count paths that only differ from
+/// path at level, starting at path[level], with the HRP and encoding of
+/// crypto_fillAddress. The node above level is derived once. buffer gets the
+/// number of entries, then for each one the compressed public key, the
+/// address length and the address, as many as fit.
+zxerr_t crypto_fillAddressRange(uint8_t *buffer, uint16_t bufferLen,
+                                const uint32_t *path, uint8_t level,
+                                uint8_t count, uint16_t *responseLen);
+
+/// Forgets the public keys and addresses derived so far, see addr_cache.h
+void crypto_addrCacheClear();
+
+/// Starts hashing a transaction as its chunks arrive, with the hash of the
+/// current encoding
+zxerr_t crypto_digestStart();
+
+/// Hashes the next chunk of the transaction
+zxerr_t crypto_digestUpdate(const uint8_t *data, uint32_t len);
+
+/// Completes the digest once the transaction has been parsed. crypto_sign
+/// signs it.
+zxerr_t crypto_digestFinish();
+
+/// Drops the digest
+void crypto_digestStop();
+
+/// Derives the key of hdPath for a sign request. Addresses of hdPath and the
+/// signature use it until crypto_sign or crypto_signSessionEnd.
+zxerr_t crypto_signSessionStart();
+
+/// Wipes the key of the sign request
+void crypto_signSessionEnd();
+
+/// Signs the transaction digest with the key of the sign request, then ends
+/// the request
 zxerr_t crypto_sign(uint8_t *signature, uint16_t signatureMaxlen,
                     uint16_t *signatureLen);
 
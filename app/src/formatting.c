@@ -0,0 +1,227 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "formatting.h"
+#include "zxmacros.h"
+
+typedef struct {
+  uint64_t hi;
+  uint64_t lo;
+} u128_pow10_t;
+
+static const uint64_t pow10_u64[FORMAT_U64_MAX_DIGITS] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL,
+};
+
+// 10^19 .. 10^38, the powers of ten that need more than 64 bits to be
+// subtracted from a 128-bit value
+static const u128_pow10_t pow10_u128[FORMAT_U128_MAX_DIGITS -
+                                     FORMAT_U64_MAX_DIGITS + 1] = {
+    {0x0000000000000000ULL, 0x8ac7230489e80000ULL}, // 1e19
+    {0x0000000000000005ULL, 0x6bc75e2d63100000ULL}, // 1e20
+    {0x0000000000000036ULL, 0x35c9adc5dea00000ULL}, // 1e21
+    {0x000000000000021eULL, 0x19e0c9bab2400000ULL}, // 1e22
+    {0x000000000000152dULL, 0x02c7e14af6800000ULL}, // 1e23
+    {0x000000000000d3c2ULL, 0x1bcecceda1000000ULL}, // 1e24
+    {0x0000000000084595ULL, 0x161401484a000000ULL}, // 1e25
+    {0x000000000052b7d2ULL, 0xdcc80cd2e4000000ULL}, // 1e26
+    {0x00000000033b2e3cULL, 0x9fd0803ce8000000ULL}, // 1e27
+    {0x00000000204fce5eULL, 0x3e25026110000000ULL}, // 1e28
+    {0x00000001431e0faeULL, 0x6d7217caa0000000ULL}, // 1e29
+    {0x0000000c9f2c9cd0ULL, 0x4674edea40000000ULL}, // 1e30
+    {0x0000007e37be2022ULL, 0xc0914b2680000000ULL}, // 1e31
+    {0x000004ee2d6d415bULL, 0x85acef8100000000ULL}, // 1e32
+    {0x0000314dc6448d93ULL, 0x38c15b0a00000000ULL}, // 1e33
+    {0x0001ed09bead87c0ULL, 0x378d8e6400000000ULL}, // 1e34
+    {0x0013426172c74d82ULL, 0x2b878fe800000000ULL}, // 1e35
+    {0x00c097ce7bc90715ULL, 0xb34b9f1000000000ULL}, // 1e36
+    {0x0785ee10d5da46d9ULL, 0x00f436a000000000ULL}, // 1e37
+    {0x4b3b4ca85a86c47aULL, 0x098a224000000000ULL}, // 1e38
+};
+
+// Digits are produced by repeated subtraction of powers of ten. It avoids
+// 64-bit divisions, which are library calls on the device cores.
+static uint8_t u64_to_digits(uint64_t value, int8_t topExponent, char *digits,
+                             uint8_t count) {
+  for (int8_t k = topExponent; k >= 0; k--) {
+    const uint64_t p = pow10_u64[k];
+    char d = '0';
+    while (value >= p) {
+      value -= p;
+      d++;
+    }
+    // Skip leading zeros, but always emit the units digit
+    if (count > 0 || d != '0' || k == 0) {
+      digits[count++] = d;
+    }
+  }
+  return count;
+}
+
+static uint8_t u128_to_digits(uint64_t hi, uint64_t lo, char *digits) {
+  uint8_t count = 0;
+  for (int8_t k = (int8_t)array_length(pow10_u128) - 1; k >= 0; k--) {
+    const u128_pow10_t p = pow10_u128[k];
+    char d = '0';
+    while (hi > p.hi || (hi == p.hi && lo >= p.lo)) {
+      hi -= p.hi + (lo < p.lo ? 1 : 0);
+      lo -= p.lo;
+      d++;
+    }
+    if (count > 0 || d != '0') {
+      digits[count++] = d;
+    }
+  }
+
+  // What remains is below 10^19, so it fits in the low word
+  return u64_to_digits(lo, FORMAT_U64_MAX_DIGITS - 2, digits, count);
+}
+
+zxerr_t format_fixed_point(char *out, uint16_t outLen, const char *digits,
+                           uint16_t digitsLen, uint8_t decimals,
+                           uint8_t minDecimals, const char *unit,
+                           uint16_t unitLen) {
+  if (out == NULL || outLen == 0 || (digits == NULL && digitsLen > 0) ||
+      (unit == NULL && unitLen > 0)) {
+    return zxerr_unknown;
+  }
+
+  if (digitsLen == 0) {
+    digits = "0";
+    digitsLen = 1;
+  }
+
+  // Either the integer part comes from the digits, or the fraction has to be
+  // padded with leading zeros
+  const uint16_t intLen = digitsLen > decimals ? digitsLen - decimals : 0;
+  const uint16_t padLen = digitsLen < decimals ? decimals - digitsLen : 0;
+
+  // Trim trailing zeros in the fraction, keeping minDecimals digits
+  const uint16_t keep = minDecimals < decimals ? minDecimals : decimals;
+  uint16_t fracLen = decimals;
+  while (fracLen > keep) {
+    const uint16_t fracIdx = fracLen - 1;
+    if (fracIdx >= padLen && digits[intLen + fracIdx - padLen] != '0') {
+      break;
+    }
+    fracLen--;
+  }
+
+  const uint32_t required = (intLen > 0 ? intLen : 1) +
+                            (fracLen > 0 ? 1 + fracLen : 0) +
+                            (unitLen > 0 ? 1 + unitLen : 0) + 1;
+  if (required > outLen) {
+    out[0] = 0;
+    return zxerr_buffer_too_small;
+  }
+
+  char *p = out;
+  if (intLen > 0) {
+    MEMCPY(p, digits, intLen);
+    p += intLen;
+  } else {
+    *p++ = '0';
+  }
+
+  if (fracLen > 0) {
+    *p++ = '.';
+    const uint16_t zeros = fracLen < padLen ? fracLen : padLen;
+    for (uint16_t i = 0; i < zeros; i++) {
+      *p++ = '0';
+    }
+    MEMCPY(p, digits + intLen, fracLen - zeros);
+    p += fracLen - zeros;
+  }
+
+  if (unitLen > 0) {
+    *p++ = ' ';
+    MEMCPY(p, unit, unitLen);
+    p += unitLen;
+  }
+  *p = 0;
+
+  return zxerr_ok;
+}
+
+zxerr_t format_fixed_point_u64(char *out, uint16_t outLen, uint64_t value,
+                               uint8_t decimals, uint8_t minDecimals,
+                               const char *unit, uint16_t unitLen) {
+  char digits[FORMAT_U64_MAX_DIGITS];
+  const uint8_t digitsLen =
+      u64_to_digits(value, FORMAT_U64_MAX_DIGITS - 1, digits, 0);
+  return format_fixed_point(out, outLen, digits, digitsLen, decimals,
+                            minDecimals, unit, unitLen);
+}
+
+zxerr_t format_fixed_point_u128(char *out, uint16_t outLen, uint64_t hi,
+                                uint64_t lo, uint8_t decimals,
+                                uint8_t minDecimals, const char *unit,
+                                uint16_t unitLen) {
+  if (hi == 0) {
+    return format_fixed_point_u64(out, outLen, lo, decimals, minDecimals, unit,
+                                  unitLen);
+  }
+
+  char digits[FORMAT_U128_MAX_DIGITS];
+  const uint8_t digitsLen = u128_to_digits(hi, lo, digits);
+  return format_fixed_point(out, outLen, digits, digitsLen, decimals,
+                            minDecimals, unit, unitLen);
+}
+
+zxerr_t format_fixed_point_be(char *out, uint16_t outLen, const uint8_t *bytes,
+                              uint16_t bytesLen, uint8_t decimals,
+                              uint8_t minDecimals, const char *unit,
+                              uint16_t unitLen) {
+  if (bytes == NULL && bytesLen > 0) {
+    return zxerr_unknown;
+  }
+
+  while (bytesLen > 0 && *bytes == 0) {
+    bytes++;
+    bytesLen--;
+  }
+  if (bytesLen > 2 * sizeof(uint64_t)) {
+    return zxerr_out_of_bounds;
+  }
+
+  uint64_t hi = 0;
+  uint64_t lo = 0;
+  for (uint16_t i = 0; i < bytesLen; i++) {
+    hi = (hi << 8) | (lo >> 56);
+    lo = (lo << 8) | bytes[i];
+  }
+
+  return format_fixed_point_u128(out, outLen, hi, lo, decimals, minDecimals,
+                                 unit, unitLen);
+}
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "zxerror.h"
+#include <stdint.h>
+
+// Largest number of decimal digits produced by the native integer paths
+#define FORMAT_U64_MAX_DIGITS 20u
+#define FORMAT_U128_MAX_DIGITS 39u
+
+/// Formats a fixed-point amount given as its decimal digits.
+/// The output is "<integer>[.<fraction>][ <unit>]" written in a single pass.
+/// Trailing zeros of the fraction are trimmed, but at least minDecimals
+/// fraction digits are kept. The unit is optional (unitLen == 0).
+/// \param out output buffer, always null terminated on success
+/// \param outLen output buffer size
+/// \param digits amount digits (not null terminated)
+/// \param digitsLen number of digits
+/// \param decimals number of fraction digits in the amount
+/// \param minDecimals minimum number of fraction digits to keep
+/// \param unit unit appended after a single space
+/// \param unitLen unit length
+/// \return zxerr_ok or zxerr_buffer_too_small
+zxerr_t format_fixed_point(char *out, uint16_t outLen, const char *digits,
+                           uint16_t digitsLen, uint8_t decimals,
+                           uint8_t minDecimals, const char *unit,
+                           uint16_t unitLen);
+
+/// Same as format_fixed_point for an amount that fits in 64 bits
+zxerr_t format_fixed_point_u64(char *out, uint16_t outLen, uint64_t value,
+                               uint8_t decimals, uint8_t minDecimals,
+                               const char *unit, uint16_t unitLen);
+
+/// Same as format_fixed_point for an amount that fits in 128 bits
+/// (value = hi * 2^64 + lo)
+zxerr_t format_fixed_point_u128(char *out, uint16_t outLen, uint64_t hi,
+                                uint64_t lo, uint8_t decimals,
+                                uint8_t minDecimals, const char *unit,
+                                uint16_t unitLen);
+
+/// Same as format_fixed_point for an amount given as big-endian bytes.
+/// Leading zero bytes are skipped, the remaining ones must fit in 128 bits.
+/// \return zxerr_out_of_bounds if the amount does not fit in 128 bits, so the
+/// caller can fall back to an arbitrary precision conversion
+zxerr_t format_fixed_point_be(char *out, uint16_t outLen, const uint8_t *bytes,
+                              uint16_t bytesLen, uint8_t decimals,
+                              uint8_t minDecimals, const char *unit,
+                              uint16_t unitLen);
+
+#ifdef __cplusplus
+}
+#endif
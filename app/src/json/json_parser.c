@@ -23,7 +23,7 @@
   (MEMCMP((const void *)PIC(_P), (const void *)PIC(_Q), (_LEN)) == 0)
 
 parser_error_t json_parse(parsed_json_t *parsed_json, const char *buffer,
-                          uint16_t bufferLen) {
+                          uint16_t bufferLen, uint16_t previous_tokens) {
   if (parsed_json == NULL || buffer == NULL) {
     return parser_unexpected_value;
   }
@@ -47,7 +47,13 @@ parser_error_t json_parse(parsed_json_t *parsed_json, const char *buffer,
   jsmn_parser parser;
   jsmn_init(&parser);
 
-  MEMZERO(parsed_json, sizeof(parsed_json_t));
+  // jsmn initializes every token it allocates, so only the tokens left over
+  // from a longer previous parse need to be wiped
+  const uint16_t previousTokens = previous_tokens < MAX_NUMBER_OF_TOKENS
+                                      ? previous_tokens
+                                      : MAX_NUMBER_OF_TOKENS;
+  parsed_json->isValid = 0;
+  parsed_json->numberOfTokens = 0;
   parsed_json->buffer = buffer;
   parsed_json->bufferLen = bufferLen;
 
@@ -55,6 +61,13 @@ parser_error_t json_parse(parsed_json_t *parsed_json, const char *buffer,
       jsmn_parse(&parser, parsed_json->buffer, parsed_json->bufferLen,
                  parsed_json->tokens, MAX_NUMBER_OF_TOKENS);
 
+  const uint16_t writtenTokens = parser.toknext;
+  if (previousTokens > writtenTokens) {
+    MEMZERO(&parsed_json->tokens[writtenTokens],
+            (previousTokens - writtenTokens) * sizeof(jsmntok_t));
+  }
+  parsed_json->tokensWritten = writtenTokens;
+
 #ifdef APP_TESTING
   char tmpBuffer[100];
   snprintf(tmpBuffer, sizeof(tmpBuffer), "tokens: %d", num_tokens);
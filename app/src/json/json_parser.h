@@ -48,9 +48,13 @@ extern "C" {
 typedef struct {
   uint8_t isValid;
   uint32_t numberOfTokens;
-  jsmntok_t tokens[MAX_NUMBER_OF_TOKENS];
   const char *buffer;
   uint16_t bufferLen;
+  // Number of tokens written by the last parse, including failed ones.
+  // Only this extent needs to be wiped before the next parse.
+  uint16_t tokensWritten;
+  // Kept last so that everything else in the struct is a small prefix
+  jsmntok_t tokens[MAX_NUMBER_OF_TOKENS];
 } parsed_json_t;
 
 //---------------------------------------------
@@ -60,9 +64,13 @@ typedef struct {
 /// \param parsed_json
 /// \param transaction
 /// \param transaction_length
+/// \param previous_tokens tokensWritten of the previous parse into
+/// parsed_json, or 0 if it has not been parsed into. Only these tokens are
+/// read as stale, and wiped if this parse writes fewer.
 /// \return Error message
 parser_error_t json_parse(parsed_json_t *parsed_json, const char *transaction,
-                          uint16_t transaction_length);
+                          uint16_t transaction_length,
+                          uint16_t previous_tokens);
 
 /// Get the number of elements in the array
 /// \param json
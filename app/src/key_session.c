@@ -0,0 +1,56 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "key_session.h"
+#include <zxmacros.h>
+
+zxerr_t key_session_start(key_session_t *session, const uint32_t *path,
+                          uint8_t pathLen, key_session_derive_t derive) {
+  if (session == NULL) {
+    return zxerr_unknown;
+  }
+  key_session_end(session);
+  if (path == NULL || derive == NULL || pathLen == 0 ||
+      pathLen > HDPATH_LEN_DEFAULT) {
+    return zxerr_unknown;
+  }
+
+  const zxerr_t err = derive(path, pathLen, session->key);
+  if (err != zxerr_ok) {
+    key_session_end(session);
+    return err;
+  }
+  MEMCPY(session->path, path, pathLen * sizeof(uint32_t));
+  session->pathLen = pathLen;
+  session->ready = true;
+  return zxerr_ok;
+}
+
+const uint8_t *key_session_get(const key_session_t *session,
+                               const uint32_t *path, uint8_t pathLen) {
+  if (session == NULL || path == NULL || !session->ready ||
+      pathLen != session->pathLen ||
+      MEMCMP(path, session->path, pathLen * sizeof(uint32_t)) != 0) {
+    return NULL;
+  }
+  return session->key;
+}
+
+void key_session_end(key_session_t *session) {
+  if (session == NULL) {
+    return;
+  }
+  MEMZERO(session, sizeof(*session));
+}
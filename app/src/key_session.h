@@ -0,0 +1,57 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "coin.h"
+#include "zxerror.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Private key of a sign request. It is derived once, used for the address
+// that is checked against the transaction and for the signature, and wiped
+// when the request ends however it ends.
+
+#define KEY_SESSION_KEY_LEN 32u
+
+/// Derives the private key of path into privateKey, KEY_SESSION_KEY_LEN bytes
+typedef zxerr_t (*key_session_derive_t)(const uint32_t *path, uint8_t pathLen,
+                                        uint8_t *privateKey);
+
+typedef struct {
+  bool ready;
+  uint32_t path[HDPATH_LEN_DEFAULT];
+  uint8_t pathLen;
+  uint8_t key[KEY_SESSION_KEY_LEN];
+} key_session_t;
+
+/// Derives and keeps the key of path, replacing any previous session
+zxerr_t key_session_start(key_session_t *session, const uint32_t *path,
+                          uint8_t pathLen, key_session_derive_t derive);
+
+/// Returns the session key if it was derived for path, NULL otherwise
+const uint8_t *key_session_get(const key_session_t *session,
+                               const uint32_t *path, uint8_t pathLen);
+
+/// Wipes the key
+void key_session_end(key_session_t *session);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,131 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "nvm_cache.h"
+#include <zxmacros.h>
+
+void nvm_cache_init(nvm_cache_t *cache, uint8_t *ram, uint32_t ramSize,
+                    uint8_t *flash, uint32_t flashSize,
+                    nvm_cache_write_t write) {
+  if (cache == NULL) {
+    return;
+  }
+  MEMZERO(cache, sizeof(*cache));
+  cache->ram = ram;
+  cache->ramSize = ramSize;
+  cache->flash = flash;
+  cache->flashSize = flashSize;
+  cache->write = write;
+  nvm_cache_reset(cache);
+}
+
+void nvm_cache_reset(nvm_cache_t *cache) {
+  if (cache == NULL) {
+    return;
+  }
+  cache->inFlash = false;
+  cache->pos = 0;
+  cache->pageStart = 0;
+  cache->pageClean = true;
+}
+
+static void nvm_cache_write_page(nvm_cache_t *cache) {
+  const uint32_t staged = cache->pos - cache->pageStart;
+  if (staged == 0 || cache->pageClean) {
+    return;
+  }
+  cache->write(cache->flash + cache->pageStart, cache->ram, staged);
+  cache->pageClean = true;
+}
+
+// Stages data in the RAM page, writing the page out each time it fills
+static void nvm_cache_stage(nvm_cache_t *cache, const uint8_t *data,
+                            uint32_t len) {
+  while (len > 0) {
+    const uint32_t staged = cache->pos - cache->pageStart;
+    uint32_t n = NVM_CACHE_PAGE_SIZE - staged;
+    if (n > len) {
+      n = len;
+    }
+    MEMCPY(cache->ram + staged, data, n);
+    cache->pos += n;
+    cache->pageClean = false;
+    data += n;
+    len -= n;
+
+    if (cache->pos - cache->pageStart == NVM_CACHE_PAGE_SIZE) {
+      nvm_cache_write_page(cache);
+      cache->pageStart += NVM_CACHE_PAGE_SIZE;
+    }
+  }
+}
+
+// Moves the RAM contents to flash. Whole pages are written at once, the rest
+// becomes the staged page.
+static void nvm_cache_spill(nvm_cache_t *cache) {
+  const uint32_t whole = cache->pos - cache->pos % NVM_CACHE_PAGE_SIZE;
+  if (whole > 0) {
+    cache->write(cache->flash, cache->ram, whole);
+  }
+  MEMMOVE(cache->ram, cache->ram + whole, cache->pos - whole);
+  cache->inFlash = true;
+  cache->pageStart = whole;
+  cache->pageClean = cache->pos == whole;
+}
+
+uint32_t nvm_cache_append(nvm_cache_t *cache, const uint8_t *data,
+                          uint32_t len) {
+  if (cache == NULL || (data == NULL && len > 0)) {
+    return 0;
+  }
+
+  if (!cache->inFlash && len <= cache->ramSize - cache->pos) {
+    MEMCPY(cache->ram + cache->pos, data, len);
+    cache->pos += len;
+    return len;
+  }
+  if (cache->pos > cache->flashSize || len > cache->flashSize - cache->pos ||
+      cache->ramSize < NVM_CACHE_PAGE_SIZE) {
+    return 0;
+  }
+
+  if (!cache->inFlash) {
+    nvm_cache_spill(cache);
+  }
+  nvm_cache_stage(cache, data, len);
+  return len;
+}
+
+void nvm_cache_flush(nvm_cache_t *cache) {
+  if (cache == NULL || !cache->inFlash) {
+    return;
+  }
+  nvm_cache_write_page(cache);
+}
+
+const uint8_t *nvm_cache_data(nvm_cache_t *cache) {
+  if (cache == NULL) {
+    return NULL;
+  }
+  if (!cache->inFlash) {
+    return cache->ram;
+  }
+  nvm_cache_flush(cache);
+  return cache->flash;
+}
+
+uint32_t nvm_cache_length(const nvm_cache_t *cache) {
+  return cache == NULL ? 0 : cache->pos;
+}
@@ -0,0 +1,79 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Transaction buffer that starts in RAM and moves to flash when it outgrows
+// it, like zxlib buffering. Once in flash, appended bytes are staged in a RAM
+// page and written back a whole aligned page at a time, instead of one flash
+// write per chunk. Reading the buffer writes out the staged tail first.
+//
+// The RAM buffer is not used once the contents are in flash, so it holds the
+// staged page and must be at least NVM_CACHE_PAGE_SIZE bytes. The flash area
+// must be aligned to NVM_CACHE_PAGE_SIZE.
+
+#ifndef NVM_CACHE_PAGE_SIZE
+#define NVM_CACHE_PAGE_SIZE 512u
+#endif
+
+/// Programs len bytes of flash at dst, nvm_write on the device
+typedef void (*nvm_cache_write_t)(uint8_t *dst, const uint8_t *src,
+                                  uint32_t len);
+
+typedef struct {
+  uint8_t *ram;
+  uint32_t ramSize;
+  uint8_t *flash;
+  uint32_t flashSize;
+  nvm_cache_write_t write;
+
+  bool inFlash;
+  // Bytes appended
+  uint32_t pos;
+  // Flash offset of the staged page, always page aligned
+  uint32_t pageStart;
+  // Staged bytes already written to flash
+  bool pageClean;
+} nvm_cache_t;
+
+void nvm_cache_init(nvm_cache_t *cache, uint8_t *ram, uint32_t ramSize,
+                    uint8_t *flash, uint32_t flashSize,
+                    nvm_cache_write_t write);
+
+/// Empties the buffer, which starts again in RAM
+void nvm_cache_reset(nvm_cache_t *cache);
+
+/// Appends data, returns len or 0 when it does not fit
+uint32_t nvm_cache_append(nvm_cache_t *cache, const uint8_t *data,
+                          uint32_t len);
+
+/// Writes the staged bytes to flash
+void nvm_cache_flush(nvm_cache_t *cache);
+
+/// Returns the buffer contents, flushing first
+const uint8_t *nvm_cache_data(nvm_cache_t *cache);
+
+uint32_t nvm_cache_length(const nvm_cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
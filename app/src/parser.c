@@ -17,16 +17,23 @@
 #include "common/parser.h"
 #include "app_mode.h"
 #include "coin.h"
+#include "formatting.h"
 #include "parser_impl.h"
+#include "render_arena.h"
+#include "tx_direct.h"
 #include "tx_display.h"
 #include "tx_parser.h"
-#include <cbor/cbor_parser_helper.h>
 #include <stdio.h>
 #include <tx_validate.h>
 #include <zxformat.h>
 #include <zxmacros.h>
 #include <zxtypes.h>
 
+#if defined(COMPILE_TEXTUAL)
+static parser_error_t parser_validateTextual(const parser_context_t *ctx,
+                                             uint16_t outValLen);
+#endif
+
 parser_error_t parser_init_context(parser_context_t *ctx, const uint8_t *buffer,
                                    uint16_t bufferSize) {
   if (ctx == NULL) {
@@ -48,6 +55,43 @@ parser_error_t parser_init_context(parser_context_t *ctx, const uint8_t *buffer,
   return parser_ok;
 }
 
+void parser_reset(parser_tx_t *tx_obj) {
+  if (tx_obj == NULL) {
+    return;
+  }
+
+  // Everything but the JSON tokens and the textual screens is a prefix of the
+  // object. Their counters are only meaningful for the type of the last
+  // parse, since both sides of the union overlap. Direct transactions are
+  // small and always cleared.
+  size_t extent = offsetof(parser_tx_t, tx_json.json.tokens);
+  const size_t directExtent = offsetof(parser_tx_t, tx_direct) +
+                              sizeof(tx_direct_t);
+  size_t textualExtent = offsetof(parser_tx_t, tx_text.screens);
+  if (tx_obj->tx_type == tx_textual) {
+    const size_t screens =
+        tx_obj->tx_text.n_containers < TEXTUAL_MAX_SCREENS
+            ? tx_obj->tx_text.n_containers
+            : TEXTUAL_MAX_SCREENS;
+    textualExtent += screens * sizeof(textual_screen_t);
+  }
+  if (tx_obj->tx_type == tx_json) {
+    const uint16_t tokens =
+        tx_obj->tx_json.json.tokensWritten < MAX_NUMBER_OF_TOKENS
+            ? tx_obj->tx_json.json.tokensWritten
+            : MAX_NUMBER_OF_TOKENS;
+    extent += tokens * sizeof(jsmntok_t);
+  }
+  if (textualExtent > extent) {
+    extent = textualExtent;
+  }
+  if (directExtent > extent) {
+    extent = directExtent;
+  }
+
+  MEMZERO(tx_obj, extent);
+}
+
 parser_error_t parser_parse(parser_context_t *ctx, const uint8_t *data,
                             size_t dataLen, parser_tx_t *tx_obj) {
   if (ctx == NULL || tx_obj == NULL) {
@@ -58,6 +102,8 @@ parser_error_t parser_parse(parser_context_t *ctx, const uint8_t *data,
   ctx->tx_obj = tx_obj;
   if (tx_obj->tx_type == tx_textual) {
     CHECK_PARSER_ERR(_read_text_tx(ctx, tx_obj))
+  } else if (tx_obj->tx_type == tx_direct) {
+    CHECK_PARSER_ERR(_read_direct_tx(ctx, tx_obj))
   } else {
     CHECK_PARSER_ERR(_read_json_tx(ctx, tx_obj))
   }
@@ -66,6 +112,27 @@ parser_error_t parser_parse(parser_context_t *ctx, const uint8_t *data,
   return parser_ok;
 }
 
+parser_error_t parser_parseDirectStream(parser_context_t *ctx,
+                                       const uint8_t *data, size_t dataLen,
+                                       tx_direct_stream_t *stream,
+                                       parser_tx_t *tx_obj) {
+  if (ctx == NULL || stream == NULL || tx_obj == NULL ||
+      stream->tx != &tx_obj->tx_direct) {
+    return parser_unexpected_value;
+  }
+  if (dataLen > UINT16_MAX) {
+    return parser_transaction_too_big;
+  }
+
+  CHECK_PARSER_ERR(parser_init_context(ctx, data, (uint16_t)dataLen))
+  ctx->tx_obj = tx_obj;
+  tx_obj->tx_type = tx_direct;
+  CHECK_PARSER_ERR(_read_direct_stream(ctx, stream, tx_obj))
+
+  extraDepthLevel = false;
+  return parser_ok;
+}
+
 parser_error_t parser_validate(const parser_context_t *ctx) {
   if (ctx == NULL || ctx->tx_obj == NULL) {
     return parser_unexpected_value;
@@ -75,12 +142,18 @@ parser_error_t parser_validate(const parser_context_t *ctx) {
     CHECK_PARSER_ERR(tx_validate(&parser_tx_obj.tx_json.json))
   }
 
+  char tmpKey[MAX_TITLE_SIZE];
+  char tmpVal[MAX_TITLE_SIZE];
+#if defined(COMPILE_TEXTUAL)
+  if (ctx->tx_obj->tx_type == tx_textual) {
+    return parser_validateTextual(ctx, sizeof(tmpVal));
+  }
+#endif
+
   // Iterate through all items to check that all can be shown and are valid
   uint8_t numItems = 0;
   CHECK_PARSER_ERR(parser_getNumItems(ctx, &numItems))
 
-  char tmpKey[MAX_TITLE_SIZE];
-  char tmpVal[MAX_TITLE_SIZE];
   uint8_t pageCount = 0;
   for (uint8_t idx = 0; idx < numItems; idx++) {
     CHECK_PARSER_ERR(parser_getItem(ctx, idx, tmpKey, sizeof(tmpKey), tmpVal,
@@ -97,9 +170,16 @@ parser_error_t parser_getNumItems(const parser_context_t *ctx,
 
   *num_items = 0;
   if (ctx->tx_obj->tx_type == tx_textual) {
+    // Expert screens are only shown in expert mode
     *num_items = (uint8_t)ctx->tx_obj->tx_text.n_containers;
+    if (!app_mode_expert()) {
+      *num_items -= ctx->tx_obj->tx_text.n_expert;
+    }
     return parser_ok;
   }
+  if (ctx->tx_obj->tx_type == tx_direct) {
+    return tx_direct_numItems(&ctx->tx_obj->tx_direct, num_items);
+  }
 
   parser_error_t ret = tx_display_numItems(num_items);
   ctx->tx_obj->tx_json.num_items = *num_items;
@@ -238,14 +318,6 @@ __Z_INLINE parser_error_t parser_formatAmountItem(uint16_t amountToken,
     return parser_unexpected_field;
   }
 
-  char bufferUI[FORMATTED_AMOUNT_BUFFER_SIZE];
-  char tmpDenom[COIN_DENOM_MAXSIZE];
-  char tmpAmount[COIN_AMOUNT_MAXSIZE];
-  MEMZERO(tmpDenom, sizeof tmpDenom);
-  MEMZERO(tmpAmount, sizeof(tmpAmount));
-  MEMZERO(outVal, outValLen);
-  MEMZERO(bufferUI, sizeof(bufferUI));
-
   if (parser_tx_obj.tx_json.json.tokens[amountToken + AMOUNT_VALUE_TOKEN_OFFSET]
               .start < 0 ||
       parser_tx_obj.tx_json.json.tokens[amountToken + DENOM_VALUE_TOKEN_OFFSET]
@@ -280,31 +352,39 @@ __Z_INLINE parser_error_t parser_formatAmountItem(uint16_t amountToken,
   }
 
   const size_t totalLen = amountLen + denomLen + 2;
-  if (sizeof(bufferUI) < totalLen) {
+  if (FORMATTED_AMOUNT_BUFFER_SIZE < totalLen) {
     return parser_unexpected_buffer_end;
   }
 
-  // Extract amount and denomination
-  MEMCPY(tmpDenom, denomPtr, denomLen);
-  MEMCPY(tmpAmount, amountPtr, amountLen);
+  // Raw amount and denomination unless the denomination has been recognized
+  const char *unit = denomPtr;
+  uint16_t unitLen = (uint16_t)denomLen;
+  uint8_t decimals = 0;
+  uint8_t minDecimals = 0;
 
-  snprintf(bufferUI, sizeof(bufferUI), "%s ", tmpAmount);
-  // If denomination has been recognized format and replace
   bool is_default = false;
   CHECK_PARSER_ERR(is_default_denom_base(denomPtr, denomLen, &is_default))
   if (is_default) {
-    if (fpstr_to_str(bufferUI, sizeof(bufferUI), tmpAmount,
-                     COIN_DEFAULT_DENOM_FACTOR) != 0) {
-      return parser_unexpected_error;
-    }
-    number_inplace_trimming(bufferUI, COIN_DEFAULT_DENOM_TRIMMING);
-    snprintf(tmpDenom, sizeof(tmpDenom), " %s", COIN_DEFAULT_DENOM_REPR);
+    unit = COIN_DEFAULT_DENOM_REPR;
+    unitLen = sizeof(COIN_DEFAULT_DENOM_REPR) - 1;
+    decimals = COIN_DEFAULT_DENOM_FACTOR;
+    minDecimals = COIN_DEFAULT_DENOM_TRIMMING;
   }
 
-  z_str3join(bufferUI, sizeof(bufferUI), "", tmpDenom);
-  pageString(outVal, outValLen, bufferUI, pageIdx, pageCount);
+  render_arena_t *arena = render_arena_acquire(render_phase_amount);
+  if (arena == NULL) {
+    return parser_unexpected_error;
+  }
+  char *bufferUI = arena->amount.bufferUI;
+  const zxerr_t err = format_fixed_point(
+      bufferUI, sizeof(arena->amount.bufferUI), amountPtr, (uint16_t)amountLen,
+      decimals, minDecimals, unit, unitLen);
+  if (err == zxerr_ok) {
+    pageString(outVal, outValLen, bufferUI, pageIdx, pageCount);
+  }
+  render_arena_release(render_phase_amount);
 
-  return parser_ok;
+  return err == zxerr_ok ? parser_ok : parser_unexpected_error;
 }
 
 __Z_INLINE parser_error_t parser_formatAmount(uint16_t amountToken,
@@ -384,126 +464,256 @@ __Z_INLINE parser_error_t parser_formatAmount(uint16_t amountToken,
 }
 
 #if defined(COMPILE_TEXTUAL)
-__Z_INLINE parser_error_t parser_screenPrint(const parser_context_t *ctx,
-                                             Cbor_container *container,
-                                             char *outKey, uint16_t outKeyLen,
-                                             char *outVal, uint16_t outValLen,
-                                             uint8_t pageIdx,
-                                             uint8_t *pageCount) {
-  if (ctx == NULL || ctx->tx_obj == NULL || container == NULL ||
-      pageCount == NULL) {
-    return parser_unexpected_value;
-  }
-
+// How a textual screen is laid out for a given output width. It is derived
+// from the lengths measured while parsing, so it needs no translation.
+typedef struct {
+  bool mergeTitle;
+  // Content is shown as is, so it does not need translating
+  bool verbatim;
+  uint16_t valueLen;
+  uint8_t pageCount;
+} screen_layout_t;
+
+__Z_INLINE parser_error_t parser_screenLayout(const textual_screen_t *screen,
+                                              uint16_t outValLen,
+                                              screen_layout_t *layout) {
   // verification assures that content + title < size(tmp), to be used in string
   // manipulation
-  if (container->screen.titleLen > MAX_TITLE_SIZE ||
-      container->screen.contentLen > MAX_CONTENT_SIZE) {
+  if (screen->titleLen > MAX_TITLE_SIZE ||
+      screen->contentLen > MAX_CONTENT_SIZE) {
     return parser_unexpected_value;
   }
-  MEMZERO(ctx->tx_obj->tx_text.tmpBuffer,
-          sizeof(ctx->tx_obj->tx_text.tmpBuffer));
-  char *tmp = (char *)ctx->tx_obj->tx_text.tmpBuffer;
-  size_t tmp_len = sizeof(ctx->tx_obj->tx_text.tmpBuffer);
-  char out[OUTPUT_HANDLER_SIZE] = {0};
+  // Translated content and its terminator must fit in the output buffer
+  if (screen->translatedLen >= OUTPUT_HANDLER_SIZE) {
+    return parser_transaction_too_big;
+  }
 
-  // No Tittle screen
-  if (container->screen.titleLen == 0) {
-    if (container->screen.contentPtr == NULL) {
-      return parser_unexpected_value;
+  // Escapes always make the translation longer than its source
+  layout->verbatim = (screen->flags & TEXTUAL_SCREEN_CONTENT_ASCII) &&
+                     screen->translatedLen == screen->contentLen;
+  layout->mergeTitle = false;
+  layout->valueLen = screen->translatedLen;
+  if (!(screen->flags & TEXTUAL_SCREEN_HAS_TITLE)) {
+    // Indentation is prepended to the content
+    if (screen->translatedLen + screen->indent >= OUTPUT_HANDLER_SIZE) {
+      return parser_transaction_too_big;
+    }
+    layout->valueLen += screen->indent;
+  } else {
+    // Title needs to be truncated, so we concat title with content
+    const uint16_t titleLen = screen->titleLen + screen->indent;
+    layout->mergeTitle =
+        titleLen > PRINTABLE_TITLE_SIZE ||
+        (outValLen > 0 && screen->translatedLen >= outValLen &&
+         titleLen > PRINTABLE_PAGINATED_TITLE_SIZE);
+    if (layout->mergeTitle) {
+      const uint16_t contentMax = OUTPUT_HANDLER_SIZE - screen->titleLen - 2;
+      layout->valueLen =
+          screen->titleLen + 2 +
+          (screen->translatedLen < contentMax ? screen->translatedLen
+                                              : contentMax);
     }
-    MEMCPY(tmp, container->screen.contentPtr, container->screen.contentLen);
-    CHECK_PARSER_ERR(tx_display_translation(out, sizeof(out), tmp,
-                                            container->screen.contentLen))
+  }
+
+  // Same split as pageString, the last page may be shorter
+  uint16_t pages = 0;
+  if (outValLen > 1) {
+    const uint16_t pageLen = outValLen - 1;
+    pages = (layout->valueLen + pageLen - 1) / pageLen;
+  }
+  if (pages > UINT8_MAX) {
+    return parser_value_out_of_range;
+  }
+  layout->pageCount = (uint8_t)pages;
 
-    for (uint8_t i = 0; i < container->screen.indent; i++) {
-      z_str3join(out, sizeof(out), SCREEN_INDENT, "");
+  return parser_ok;
+}
+
+__Z_INLINE parser_error_t parser_screenRender(screen_arg_t *screenArg,
+                                              const screen_layout_t *layout,
+                                              render_screen_t *scratch,
+                                              char *outKey, uint16_t outKeyLen,
+                                              char *outVal, uint16_t outValLen,
+                                              uint8_t pageIdx,
+                                              uint8_t *pageCount) {
+  if (screenArg->contentPtr == NULL) {
+    return parser_unexpected_value;
+  }
+
+  // Translation reads exactly contentLen bytes and terminates its output
+  char *out = scratch->out;
+  if (layout->verbatim) {
+    MEMCPY(out, screenArg->contentPtr, screenArg->contentLen);
+    out[screenArg->contentLen] = 0;
+  } else {
+    CHECK_PARSER_ERR(tx_display_translation(out, sizeof(scratch->out),
+                                            screenArg->contentPtr,
+                                            screenArg->contentLen))
+  }
+
+  // No Tittle screen
+  if (screenArg->titleLen == 0) {
+    for (uint8_t i = 0; i < screenArg->indent; i++) {
+      z_str3join(out, sizeof(scratch->out), SCREEN_INDENT, "");
     }
 
     snprintf(outKey, outKeyLen, " ");
-    pageString(outVal, outValLen, out, pageIdx, pageCount);
+    pageStringExt(outVal, outValLen, out, layout->valueLen, pageIdx,
+                  pageCount);
     return parser_ok;
   }
 
-  // Translate output, cpy to tmp to assure it ends in \0
-  MEMZERO(tmp, tmp_len);
-  if (container->screen.contentPtr == NULL) {
+  if (screenArg->titlePtr == NULL) {
     return parser_unexpected_value;
   }
-  MEMCPY(tmp, container->screen.contentPtr, container->screen.contentLen);
-  CHECK_PARSER_ERR(tx_display_translation(out, sizeof(out), tmp,
-                                          container->screen.contentLen))
 
-  uint8_t titleLen = container->screen.titleLen + container->screen.indent;
-  // Title needs to be truncated, so we concat title witn content
-  if ((titleLen > PRINTABLE_TITLE_SIZE) ||
-      (outValLen > 0 && ((strlen(out) / outValLen) >= 1 &&
-                         titleLen > PRINTABLE_PAGINATED_TITLE_SIZE))) {
+  char *key = scratch->key;
+  const uint16_t keyLen = sizeof(scratch->key);
+  MEMZERO(key, keyLen);
 
-    char key[MAX_TITLE_SIZE + 2] = {0};
+  if (layout->mergeTitle) {
     MEMCPY(key, TITLE_TRUNCATE_REPLACE, strlen(TITLE_TRUNCATE_REPLACE));
-    for (uint8_t i = 0; i < container->screen.indent; i++) {
-      z_str3join(key, sizeof(key), SCREEN_INDENT, "");
+    for (uint8_t i = 0; i < screenArg->indent; i++) {
+      z_str3join(key, keyLen, SCREEN_INDENT, "");
     }
 
-    MEMZERO(ctx->tx_obj->tx_text.tmpBuffer,
-            sizeof(ctx->tx_obj->tx_text.tmpBuffer));
-    if (container->screen.titlePtr == NULL) {
-      return parser_unexpected_value;
-    }
-    MEMCPY(tmp, container->screen.titlePtr, container->screen.titleLen);
-    MEMCPY(tmp + container->screen.titleLen, ": ", 2);
-    MEMCPY(tmp + container->screen.titleLen + 2, out,
-           sizeof(out) - container->screen.titleLen - 2);
+    // The layout bounds title and content to sizeof(out) bytes
+    char *tmp = scratch->tmp;
+    const size_t contentLen = layout->valueLen - screenArg->titleLen - 2;
+    MEMCPY(tmp, screenArg->titlePtr, screenArg->titleLen);
+    MEMCPY(tmp + screenArg->titleLen, ": ", 2);
+    MEMCPY(tmp + screenArg->titleLen + 2, out, contentLen);
+    tmp[layout->valueLen] = 0;
     snprintf(outKey, outKeyLen, "%s", key);
-    pageString(outVal, outValLen, tmp, pageIdx, pageCount);
+    pageStringExt(outVal, outValLen, tmp, layout->valueLen, pageIdx,
+                  pageCount);
     return parser_ok;
   }
 
   // Normal print case - Prepare title
-  char key[MAX_TITLE_SIZE + 2] = {0};
-  if (container->screen.titlePtr == NULL) {
-    return parser_unexpected_value;
-  }
-  MEMCPY(key, container->screen.titlePtr, container->screen.titleLen);
-  for (uint8_t i = 0; i < container->screen.indent; i++) {
-    z_str3join(key, sizeof(key), SCREEN_INDENT, "");
+  MEMCPY(key, screenArg->titlePtr, screenArg->titleLen);
+  for (uint8_t i = 0; i < screenArg->indent; i++) {
+    z_str3join(key, keyLen, SCREEN_INDENT, "");
   }
   snprintf(outKey, outKeyLen, "%s", key);
-  pageString(outVal, outValLen, out, pageIdx, pageCount);
+  pageStringExt(outVal, outValLen, out, layout->valueLen, pageIdx, pageCount);
 
   return parser_ok;
 }
 
-__Z_INLINE parser_error_t parser_getScreenInfo(const parser_context_t *ctx,
-                                               Cbor_container *container,
-                                               uint8_t index) {
-  CborValue it;
-  CborValue containerArray_ptr;
-  CborValue mapStruct_ptr;
-  INIT_CBOR_PARSER(ctx, mapStruct_ptr)
+__Z_INLINE parser_error_t parser_screenPrint(const parser_context_t *ctx,
+                                             screen_arg_t *screenArg,
+                                             const screen_layout_t *layout,
+                                             char *outKey, uint16_t outKeyLen,
+                                             char *outVal, uint16_t outValLen,
+                                             uint8_t pageIdx,
+                                             uint8_t *pageCount) {
+  if (ctx == NULL || ctx->tx_obj == NULL || screenArg == NULL ||
+      layout == NULL || pageCount == NULL) {
+    return parser_unexpected_value;
+  }
+
+  render_arena_t *arena = render_arena_acquire(render_phase_screen);
+  if (arena == NULL) {
+    return parser_unexpected_error;
+  }
+  const parser_error_t err =
+      parser_screenRender(screenArg, layout, &arena->screen, outKey, outKeyLen,
+                          outVal, outValLen, pageIdx, pageCount);
+  render_arena_release(render_phase_screen);
+  return err;
+}
 
-  PARSER_ASSERT_OR_ERROR(!cbor_value_at_end(&mapStruct_ptr),
-                         parser_unexpected_buffer_end)
-  PARSER_ASSERT_OR_ERROR(cbor_value_is_map(&mapStruct_ptr),
-                         parser_unexpected_type)
-  CHECK_CBOR_MAP_ERR(cbor_value_enter_container(&mapStruct_ptr, &it))
-  CHECK_CBOR_MAP_ERR(cbor_value_advance(&it))
-  CHECK_CBOR_MAP_ERR(cbor_value_enter_container(&it, &containerArray_ptr))
+__Z_INLINE parser_error_t parser_getScreenInfo(
+    const parser_context_t *ctx, screen_arg_t *screenArg,
+    const textual_screen_t **screenOut, uint8_t displayIdx) {
+  const tx_textual_t *tx_text = &ctx->tx_obj->tx_text;
+  uint8_t index = displayIdx;
+  if (!app_mode_expert()) {
+    if (displayIdx >= tx_text->n_containers - tx_text->n_expert) {
+      return parser_display_idx_out_of_range;
+    }
+    index = tx_text->normalScreens[displayIdx];
+  }
+  if (index >= tx_text->n_containers) {
+    return parser_display_idx_out_of_range;
+  }
 
-  for (int i = 0; i < index; i++) {
-    CHECK_CBOR_MAP_ERR(cbor_value_advance(&containerArray_ptr))
+  // Screens were decoded while parsing
+  const textual_screen_t *screen = &tx_text->screens[index];
+  if (screen->flags & TEXTUAL_SCREEN_HAS_TITLE) {
+    screenArg->titlePtr = (char *)ctx->buffer + screen->titleOffset;
+    screenArg->titleLen = screen->titleLen;
   }
+  screenArg->contentPtr = (char *)ctx->buffer + screen->contentOffset;
+  screenArg->contentLen = screen->contentLen;
+  screenArg->indent = screen->indent;
+  screenArg->expert = (screen->flags & TEXTUAL_SCREEN_EXPERT) != 0;
+  *screenOut = screen;
+
+  return parser_ok;
+}
 
-  CborValue data;
-  CHECK_CBOR_MAP_ERR(
-      cbor_value_get_map_length(&containerArray_ptr, &container->n_field))
-  CHECK_CBOR_MAP_ERR(cbor_value_enter_container(&containerArray_ptr, &data))
-  CHECK_PARSER_ERR(cbor_get_containerInfo(&data, container))
+__Z_INLINE parser_error_t parser_checkChainId(const screen_arg_t *screenArg) {
+  // title and content can be Null depending on the screen for chain id they
+  // cant be null
+  if (screenArg->titlePtr != NULL && screenArg->contentPtr != NULL) {
+    static const char chain_id_title[] = "Chain id";
+    const size_t chain_id_title_len = sizeof(chain_id_title) - 1;
 
+    if (screenArg->titleLen == chain_id_title_len &&
+        memcmp(screenArg->titlePtr, chain_id_title, chain_id_title_len) == 0) {
+      if (screenArg->contentLen == 1 &&
+          (screenArg->contentPtr[0] == '0' ||
+           screenArg->contentPtr[0] == '1')) {
+        return parser_unexpected_chain;
+      }
+    }
+  }
   return parser_ok;
 }
 
+__Z_INLINE parser_error_t parser_getScreen(const parser_context_t *ctx,
+                                           uint8_t displayIdx,
+                                           uint16_t outValLen,
+                                           screen_arg_t *screenArg,
+                                           screen_layout_t *layout) {
+  uint8_t numItems;
+  CHECK_PARSER_ERR(parser_getNumItems(ctx, &numItems))
+  PARSER_ASSERT_OR_ERROR((numItems != 0), parser_unexpected_number_items)
+  PARSER_ASSERT_OR_ERROR((displayIdx < numItems),
+                         parser_display_idx_out_of_range)
+
+  CHECK_APP_CANARY()
+
+  screenArg->titlePtr = NULL;
+  screenArg->titleLen = 0;
+  screenArg->contentPtr = NULL;
+  screenArg->contentLen = 0;
+  screenArg->indent = 0;
+  screenArg->expert = false;
+  const textual_screen_t *screen = NULL;
+  CHECK_PARSER_ERR(parser_getScreenInfo(ctx, screenArg, &screen, displayIdx))
+  CHECK_PARSER_ERR(parser_checkChainId(screenArg))
+
+  return parser_screenLayout(screen, outValLen, layout);
+}
+
+static parser_error_t parser_validateTextual(const parser_context_t *ctx,
+                                             uint16_t outValLen) {
+  uint8_t numItems = 0;
+  CHECK_PARSER_ERR(parser_getNumItems(ctx, &numItems))
+
+  // Content was measured while parsing, so screens are checked without
+  // rendering them
+  screen_arg_t screenArg;
+  screen_layout_t layout;
+  for (uint8_t idx = 0; idx < numItems; idx++) {
+    CHECK_PARSER_ERR(
+        parser_getScreen(ctx, idx, outValLen, &screenArg, &layout))
+  }
+  return parser_ok;
+}
 #endif
 
 __Z_INLINE parser_error_t
@@ -526,46 +736,54 @@ parser_getTextualItem(const parser_context_t *ctx, uint8_t displayIdx,
   MEMZERO(outKey, outKeyLen);
   MEMZERO(outVal, outValLen);
 
-  uint8_t numItems;
-  CHECK_PARSER_ERR(parser_getNumItems(ctx, &numItems))
-  PARSER_ASSERT_OR_ERROR((numItems != 0), parser_unexpected_number_items)
-  PARSER_ASSERT_OR_ERROR((displayIdx < numItems),
-                         parser_display_idx_out_of_range)
+  screen_arg_t screenArg;
+  screen_layout_t layout;
+  CHECK_PARSER_ERR(
+      parser_getScreen(ctx, displayIdx, outValLen, &screenArg, &layout))
 
-  CHECK_APP_CANARY()
+  CHECK_PARSER_ERR(parser_screenPrint(ctx, &screenArg, &layout, outKey,
+                                      outKeyLen, outVal, outValLen, pageIdx,
+                                      pageCount))
 
-  Cbor_container container;
-  container.screen.titlePtr = NULL;
-  container.screen.titleLen = 0;
-  container.screen.contentPtr = NULL;
-  container.screen.contentLen = 0;
-  container.screen.indent = 0;
-  container.screen.expert = false;
-  CHECK_PARSER_ERR(parser_getScreenInfo(ctx, &container, displayIdx))
+  return parser_ok;
+#endif
+}
 
-  // title and content can be Null depending on the screen for chain id they
-  // cant be null
-  if (container.screen.titlePtr != NULL &&
-      container.screen.contentPtr != NULL) {
-    static const char chain_id_title[] = "Chain id";
-    const size_t chain_id_title_len = sizeof(chain_id_title) - 1;
+__Z_INLINE parser_error_t parser_printJsonItem(tx_display_cursor_t *cursor,
+                                               char *outKey,
+                                               uint16_t outKeyLen,
+                                               char *outVal,
+                                               uint16_t outValLen,
+                                               uint8_t pageIdx,
+                                               uint8_t *pageCount) {
+  *pageCount = 0;
+  char tmpKey[QUERY_KEY_BUFFER_SIZE] = {0};
 
-    if (container.screen.titleLen == chain_id_title_len &&
-        memcmp(container.screen.titlePtr, chain_id_title, chain_id_title_len) ==
-            0) {
-      if (container.screen.contentLen == 1 &&
-          (container.screen.contentPtr[0] == '0' ||
-           container.screen.contentPtr[0] == '1')) {
-        return parser_unexpected_chain;
-      }
-    }
+  MEMZERO(outKey, outKeyLen);
+  MEMZERO(outVal, outValLen);
+
+  uint16_t ret_value_token_index = 0;
+  CHECK_PARSER_ERR(tx_display_cursor_query(cursor, tmpKey, sizeof(tmpKey),
+                                           &ret_value_token_index))
+  CHECK_APP_CANARY()
+  snprintf(outKey, outKeyLen, "%s", tmpKey);
+
+  if (parser_isAmount(tmpKey)) {
+    CHECK_PARSER_ERR(parser_formatAmount(ret_value_token_index, outVal,
+                                         outValLen, pageIdx, pageCount))
+  } else {
+    CHECK_PARSER_ERR(tx_getToken(ret_value_token_index, outVal, outValLen,
+                                 pageIdx, pageCount))
   }
+  CHECK_APP_CANARY()
 
-  CHECK_PARSER_ERR(parser_screenPrint(ctx, &container, outKey, outKeyLen,
-                                      outVal, outValLen, pageIdx, pageCount))
+  CHECK_PARSER_ERR(tx_display_make_friendly())
+  CHECK_APP_CANARY()
+
+  snprintf(outKey, outKeyLen, "%s", tmpKey);
+  CHECK_APP_CANARY()
 
   return parser_ok;
-#endif
 }
 
 __Z_INLINE parser_error_t parser_getJsonItem(const parser_context_t *ctx,
@@ -579,8 +797,6 @@ __Z_INLINE parser_error_t parser_getJsonItem(const parser_context_t *ctx,
   }
 
   *pageCount = 0;
-  char tmpKey[QUERY_KEY_BUFFER_SIZE] = {0};
-
   MEMZERO(outKey, outKeyLen);
   MEMZERO(outVal, outValLen);
 
@@ -596,28 +812,10 @@ __Z_INLINE parser_error_t parser_getJsonItem(const parser_context_t *ctx,
     return parser_display_idx_out_of_range;
   }
 
-  uint16_t ret_value_token_index = 0;
-  CHECK_PARSER_ERR(tx_display_query(displayIdx, tmpKey, sizeof(tmpKey),
-                                    &ret_value_token_index))
-  CHECK_APP_CANARY()
-  snprintf(outKey, outKeyLen, "%s", tmpKey);
-
-  if (parser_isAmount(tmpKey)) {
-    CHECK_PARSER_ERR(parser_formatAmount(ret_value_token_index, outVal,
-                                         outValLen, pageIdx, pageCount))
-  } else {
-    CHECK_PARSER_ERR(tx_getToken(ret_value_token_index, outVal, outValLen,
-                                 pageIdx, pageCount))
-  }
-  CHECK_APP_CANARY()
-
-  CHECK_PARSER_ERR(tx_display_make_friendly())
-  CHECK_APP_CANARY()
-
-  snprintf(outKey, outKeyLen, "%s", tmpKey);
-  CHECK_APP_CANARY()
-
-  return parser_ok;
+  tx_display_cursor_t cursor;
+  CHECK_PARSER_ERR(tx_display_cursor_init(&cursor, displayIdx))
+  return parser_printJsonItem(&cursor, outKey, outKeyLen, outVal, outValLen,
+                              pageIdx, pageCount);
 }
 
 parser_error_t parser_getItem(const parser_context_t *ctx, uint8_t displayIdx,
@@ -633,6 +831,10 @@ parser_error_t parser_getItem(const parser_context_t *ctx, uint8_t displayIdx,
                                            outVal, outValLen, pageIdx,
                                            pageCount));
 
+  } else if (ctx->tx_obj->tx_type == tx_direct) {
+    CHECK_PARSER_ERR(tx_direct_getItem(ctx->buffer, &ctx->tx_obj->tx_direct,
+                                       displayIdx, outKey, outKeyLen, outVal,
+                                       outValLen, pageIdx, pageCount))
   } else {
     CHECK_PARSER_ERR(parser_getJsonItem(ctx, displayIdx, outKey, outKeyLen,
                                         outVal, outValLen, pageIdx, pageCount));
@@ -640,3 +842,46 @@ parser_error_t parser_getItem(const parser_context_t *ctx, uint8_t displayIdx,
 
   return parser_ok;
 }
+
+parser_error_t parser_getItems(const parser_context_t *ctx, uint8_t firstIdx,
+                               uint8_t count, parser_item_t *items) {
+  if (ctx == NULL || ctx->tx_obj == NULL || items == NULL) {
+    return parser_unexpected_value;
+  }
+  if (count == 0) {
+    return parser_ok;
+  }
+
+  uint8_t numItems = 0;
+  CHECK_PARSER_ERR(parser_getNumItems(ctx, &numItems))
+  if (firstIdx >= numItems || count > numItems - firstIdx) {
+    return parser_display_idx_out_of_range;
+  }
+
+  // Textual and direct items are looked up in a table already
+  if (ctx->tx_obj->tx_type != tx_json) {
+    for (uint8_t i = 0; i < count; i++) {
+      parser_item_t *item = &items[i];
+      CHECK_PARSER_ERR(parser_getItem(ctx, firstIdx + i, item->key,
+                                      item->keyLen, item->val, item->valLen,
+                                      item->pageIdx, &item->pageCount))
+    }
+    return parser_ok;
+  }
+
+  // JSON items are found in one walk: the root item and the message of each
+  // one are where the previous one left off
+  tx_display_cursor_t cursor;
+  CHECK_PARSER_ERR(tx_display_cursor_init(&cursor, firstIdx))
+  for (uint8_t i = 0; i < count; i++) {
+    if (i > 0) {
+      CHECK_PARSER_ERR(tx_display_cursor_next(&cursor))
+    }
+    parser_item_t *item = &items[i];
+    CHECK_PARSER_ERR(parser_printJsonItem(&cursor, item->key, item->keyLen,
+                                          item->val, item->valLen,
+                                          item->pageIdx, &item->pageCount))
+  }
+
+  return parser_ok;
+}
@@ -15,8 +15,10 @@
  ********************************************************************************/
 
 #include "parser_impl.h"
-#include "cbor.h"
-#include <cbor/cbor_parser_helper.h>
+#include "tx_direct.h"
+#include "tx_display.h"
+#include "utf8_validate.h"
+#include <cbor/textual_cbor.h>
 
 parser_tx_t parser_tx_obj;
 
@@ -40,6 +42,8 @@ const char *parser_getErrorDescription(parser_error_t err) {
     return "Unexpected duplicated field";
   case parser_value_out_of_range:
     return "Value out of range";
+  case parser_invalid_address:
+    return "Invalid address";
   case parser_unexpected_chain:
     return "Unexpected chain";
   case parser_query_no_results:
@@ -85,6 +89,11 @@ const char *parser_getErrorDescription(parser_error_t err) {
     return "CBOR was not in canonical order";
   case parser_cbor_unexpected_EOF:
     return "Unexpected CBOR EOF";
+  // protobuf
+  case parser_proto_unexpected_wire_type:
+    return "Unexpected protobuf wire type";
+  case parser_proto_unexpected_EOF:
+    return "Unexpected protobuf EOF";
   // Context specific
   case parser_context_mismatch:
     return "context prefix is invalid";
@@ -126,8 +135,11 @@ const char *parser_getErrorDescription(parser_error_t err) {
 }
 
 parser_error_t _read_json_tx(parser_context_t *c, __Z_UNUSED parser_tx_t *v) {
+  // parser_tx_obj has static storage, so its count starts at 0 and is then
+  // kept by every parse
   parser_error_t err = json_parse(&parser_tx_obj.tx_json.json,
-                                  (const char *)c->buffer, c->bufferLen);
+                                  (const char *)c->buffer, c->bufferLen,
+                                  parser_tx_obj.tx_json.json.tokensWritten);
   if (err != parser_ok) {
     return err;
   }
@@ -146,60 +158,69 @@ parser_error_t _read_text_tx(parser_context_t *c, parser_tx_t *v) {
   UNUSED(v);
   return parser_value_out_of_range;
 #else
-  CborValue it;
-  CborValue mapStruct_ptr;
+  textual_cbor_t decoder;
   CHECK_APP_CANARY()
-  INIT_CBOR_PARSER(c, mapStruct_ptr)
-  CHECK_APP_CANARY()
-
-  // Make sure we have a map/struct
-  PARSER_ASSERT_OR_ERROR(cbor_value_is_map(&mapStruct_ptr),
-                         parser_unexpected_type)
-  CHECK_CBOR_MAP_ERR(cbor_value_enter_container(&mapStruct_ptr, &it))
-
-  // Make sure we have screen_key set to 1
-  int screen_key = 0;
-  PARSER_ASSERT_OR_ERROR(cbor_value_is_integer(&it), parser_unexpected_type)
-  CHECK_CBOR_MAP_ERR(cbor_value_get_int(&it, &screen_key))
-  PARSER_ASSERT_OR_ERROR(screen_key == 1, parser_unexpected_type)
-  CHECK_CBOR_MAP_ERR(cbor_value_advance(&it))
-
-  // Make sure we have an array of containers and check size
-  PARSER_ASSERT_OR_ERROR(cbor_value_is_array(&it), parser_unexpected_type)
-
-  CHECK_CBOR_MAP_ERR(cbor_value_get_array_length(&it, &v->tx_text.n_containers))
-  // Limit max fields to 255
-  PARSER_ASSERT_OR_ERROR(
-      (v->tx_text.n_containers > 0 && v->tx_text.n_containers <= UINT8_MAX),
-      parser_unexpected_number_items)
-
-  CborValue containerArray_ptr;
-  CborValue data;
-  Cbor_container container;
-
-  // Enter array of containers
-  CHECK_CBOR_MAP_ERR(cbor_value_enter_container(&it, &containerArray_ptr))
-
-  for (size_t i = 0; i < v->tx_text.n_containers; i++) {
-    MEMZERO(&container, sizeof(container));
-
-    CHECK_CBOR_MAP_ERR(
-        cbor_value_get_map_length(&containerArray_ptr, &container.n_field))
-    PARSER_ASSERT_OR_ERROR((container.n_field > 0 && container.n_field < 5),
-                           parser_unexpected_value)
-
-    CHECK_CBOR_MAP_ERR(cbor_value_enter_container(&containerArray_ptr, &data))
-    CHECK_PARSER_ERR(cbor_check_expert(&data, &container))
-
-    v->tx_text.n_expert += container.screen.expert ? 1 : 0;
-    CHECK_CBOR_MAP_ERR(cbor_value_advance(&containerArray_ptr))
+  CHECK_PARSER_ERR(textual_cbor_init(&decoder, c->buffer + c->offset,
+                                     c->bufferLen - c->offset))
+
+  uint8_t screenCount = 0;
+  CHECK_PARSER_ERR(textual_cbor_enter_screens(&decoder, &screenCount))
+  v->tx_text.n_containers = screenCount;
+
+  for (uint8_t i = 0; i < screenCount; i++) {
+    // Decode the screen as it will be displayed
+    screen_arg_t screenInfo;
+    CHECK_PARSER_ERR(textual_cbor_read_screen(&decoder, &screenInfo))
+
+    // Every title and content is checked once here, whether it is shown or not
+    bool titleAscii = true;
+    bool contentAscii = true;
+    CHECK_PARSER_ERR(utf8_validate((const uint8_t *)screenInfo.titlePtr,
+                                   screenInfo.titleLen, &titleAscii))
+    CHECK_PARSER_ERR(utf8_validate((const uint8_t *)screenInfo.contentPtr,
+                                   screenInfo.contentLen, &contentAscii))
+
+    textual_screen_t *screen = &v->tx_text.screens[i];
+    screen->flags = screenInfo.expert ? TEXTUAL_SCREEN_EXPERT : 0;
+    // Only the content is translated for display, see parser_screenLayout
+    screen->flags |= contentAscii ? TEXTUAL_SCREEN_CONTENT_ASCII : 0;
+    if (screenInfo.titlePtr != NULL) {
+      screen->flags |= TEXTUAL_SCREEN_HAS_TITLE;
+      screen->titleOffset =
+          (uint16_t)((const uint8_t *)screenInfo.titlePtr - c->buffer);
+      screen->titleLen = (uint16_t)screenInfo.titleLen;
+    }
+    screen->contentOffset =
+        (uint16_t)((const uint8_t *)screenInfo.contentPtr - c->buffer);
+    screen->contentLen = (uint16_t)screenInfo.contentLen;
+    screen->indent = screenInfo.indent;
+    // Measured now so that paging a screen does not require translating it
+    CHECK_PARSER_ERR(tx_display_translation_len(
+        screenInfo.contentPtr, screen->contentLen, &screen->translatedLen))
+
+    if (screenInfo.expert) {
+      v->tx_text.n_expert++;
+    } else {
+      v->tx_text.normalScreens[i - v->tx_text.n_expert] = i;
+    }
   }
-  CHECK_CBOR_MAP_ERR(cbor_value_leave_container(&it, &containerArray_ptr))
-
-  // End of buffer does not match end of parsed data
-  PARSER_ASSERT_OR_ERROR(it.source.ptr == c->buffer + c->bufferLen,
-                         parser_cbor_unexpected_EOF)
+  CHECK_PARSER_ERR(textual_cbor_finish(&decoder))
 
   return parser_ok;
 #endif
 }
+
+parser_error_t _read_direct_tx(parser_context_t *c, parser_tx_t *v) {
+  // The signing address is set on the JSON object by the APDU handler
+  return tx_direct_parse(c->buffer + c->offset, c->bufferLen - c->offset,
+                         parser_tx_obj.tx_json.own_addr,
+                         parser_tx_obj.tx_json.own_addr_len, &v->tx_direct);
+}
+
+parser_error_t _read_direct_stream(parser_context_t *c,
+                                   tx_direct_stream_t *stream, parser_tx_t *v) {
+  CHECK_PARSER_ERR(tx_direct_stream_finish(stream))
+  return tx_direct_build(c->buffer, c->bufferLen,
+                         parser_tx_obj.tx_json.own_addr,
+                         parser_tx_obj.tx_json.own_addr_len, &v->tx_direct);
+}
@@ -17,6 +17,7 @@
 
 #include "parser_common.h"
 #include "parser_txdef.h"
+#include "tx_direct_stream.h"
 #include "zxtypes.h"
 #include "json/json_parser.h"
 #include <zxmacros.h>
@@ -46,6 +47,9 @@ extern parser_tx_t parser_tx_obj;
 
 parser_error_t _read_json_tx(parser_context_t *c, parser_tx_t *v);
 parser_error_t _read_text_tx(parser_context_t *c, parser_tx_t *v);
+parser_error_t _read_direct_tx(parser_context_t *c, parser_tx_t *v);
+parser_error_t _read_direct_stream(parser_context_t *c,
+                                   tx_direct_stream_t *stream, parser_tx_t *v);
 
 #ifdef __cplusplus
 }
@@ -19,9 +19,9 @@
 extern "C" {
 #endif
 
-#include "cbor.h"
 #include "coin.h"
 #include <json/json_parser.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -31,7 +31,7 @@ extern "C" {
 #define INDENT_KEY_ID 3
 #define EXPERT_KEY_ID 4
 
-// Textual transaction temporary buffer size
+// Textual screen temporary buffer size, held in the render arena
 #define TX_TEXTUAL_TMP_BUFFER_SIZE 625
 
 typedef struct screen_arg_t {
@@ -43,12 +43,73 @@ typedef struct screen_arg_t {
   bool expert;
 } screen_arg_t;
 
+// Textual screens decoded while parsing, so that showing a screen does not
+// need to walk the CBOR again. Offsets are relative to the tx buffer.
+#define TEXTUAL_MAX_SCREENS UINT8_MAX
+#define TEXTUAL_SCREEN_HAS_TITLE 0x01u
+#define TEXTUAL_SCREEN_EXPERT 0x02u
+#define TEXTUAL_SCREEN_CONTENT_ASCII 0x04u
+
+typedef struct {
+  uint16_t titleOffset;
+  uint16_t titleLen;
+  uint16_t contentOffset;
+  uint16_t contentLen;
+  // Length of the content once escaped for display
+  uint16_t translatedLen;
+  uint8_t indent;
+  uint8_t flags;
+} textual_screen_t;
+
 typedef struct tx_textual_t {
   size_t n_containers;
   uint8_t n_expert;
-  uint8_t tmpBuffer[TX_TEXTUAL_TMP_BUFFER_SIZE];
+  // Screens shown outside expert mode, as indexes into screens. In expert
+  // mode every screen is shown, so that map is the identity.
+  uint8_t normalScreens[TEXTUAL_MAX_SCREENS];
+  textual_screen_t screens[TEXTUAL_MAX_SCREENS];
 } tx_textual_t;
 
+// SIGN_MODE_DIRECT transactions are indexed while parsing. Fields point into
+// the tx buffer, as offset and length, and are decoded again when shown. A
+// streamed transaction points into the fields that were kept instead.
+#define DIRECT_MAX_MSGS 64
+
+typedef struct {
+  uint32_t offset;
+  uint32_t len;
+} direct_bytes_t;
+
+typedef struct {
+  // Index of the message schema in tx_direct.c
+  uint8_t schema;
+  // Encoded message, the value of its Any
+  direct_bytes_t value;
+} direct_msg_t;
+
+typedef struct tx_direct_t {
+  direct_bytes_t chainId;
+  direct_bytes_t memo;
+  // Encoded Fee message, its coins are read when the fee is shown
+  direct_bytes_t fee;
+  direct_bytes_t payer;
+  direct_bytes_t granter;
+  uint64_t accountNumber;
+  uint64_t sequence;
+  uint64_t gasLimit;
+  bool defaultChain;
+
+  // Grouping, as for JSON: a type shared by every message is shown once,
+  // and outside expert mode so is a shared delegator
+  bool typeGrouping;
+  bool fromGrouping;
+  bool fromIsOwn;
+  uint8_t fromMsg;
+
+  uint8_t numMsgs;
+  direct_msg_t msgs[DIRECT_MAX_MSGS];
+} tx_direct_t;
+
 typedef struct {
   // These are internal values used for tracking the state of the query/search
   uint16_t _item_index_current;
@@ -76,9 +137,6 @@ typedef struct {
   // Buffer to the original tx blob
   const char *tx;
 
-  // parsed data (tokens, etc.)
-  parsed_json_t json;
-
   // internal flags
   struct {
     bool cache_valid : 1;
@@ -101,6 +159,9 @@ typedef struct {
   // current tx query
   tx_query_t query;
   uint8_t num_items;
+
+  // parsed data (tokens, etc.), kept last so its tokens end the struct
+  parsed_json_t json;
 } tx_json_t;
 
 typedef struct {
@@ -109,6 +170,7 @@ typedef struct {
   union {
     tx_json_t tx_json;
     tx_textual_t tx_text;
+    tx_direct_t tx_direct;
   };
 } parser_tx_t;
 
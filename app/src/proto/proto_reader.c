@@ -0,0 +1,108 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "proto_reader.h"
+#include <zxmacros.h>
+
+#define PROTO_VARINT_MAX_BYTES 10u
+
+static parser_error_t read_varint(proto_reader_t *reader, uint64_t *value) {
+  uint64_t result = 0;
+  for (uint8_t i = 0; i < PROTO_VARINT_MAX_BYTES; i++) {
+    if (reader->ptr >= reader->end) {
+      return parser_proto_unexpected_EOF;
+    }
+    const uint8_t byte = *reader->ptr++;
+    // The tenth byte only holds the top bit of a 64 bit value
+    if (i == PROTO_VARINT_MAX_BYTES - 1 && byte > 1) {
+      return parser_value_out_of_range;
+    }
+    result |= (uint64_t)(byte & 0x7Fu) << (7u * i);
+    if ((byte & 0x80u) == 0) {
+      *value = result;
+      return parser_ok;
+    }
+  }
+  return parser_value_out_of_range;
+}
+
+static parser_error_t read_fixed(proto_reader_t *reader, uint8_t size,
+                                 uint64_t *value) {
+  if ((size_t)(reader->end - reader->ptr) < size) {
+    return parser_proto_unexpected_EOF;
+  }
+  // Little endian
+  uint64_t result = 0;
+  for (uint8_t i = 0; i < size; i++) {
+    result |= (uint64_t)reader->ptr[i] << (8u * i);
+  }
+  reader->ptr += size;
+  *value = result;
+  return parser_ok;
+}
+
+parser_error_t proto_reader_init(proto_reader_t *reader, const uint8_t *buffer,
+                                 size_t bufferLen) {
+  if (reader == NULL || (buffer == NULL && bufferLen > 0)) {
+    return parser_unexpected_value;
+  }
+  reader->ptr = buffer;
+  reader->end = buffer + bufferLen;
+  return parser_ok;
+}
+
+bool proto_reader_done(const proto_reader_t *reader) {
+  return reader->ptr >= reader->end;
+}
+
+parser_error_t proto_read_field(proto_reader_t *reader, proto_field_t *field) {
+  if (reader == NULL || field == NULL) {
+    return parser_unexpected_value;
+  }
+
+  uint64_t tag = 0;
+  CHECK_PARSER_ERR(read_varint(reader, &tag))
+  const uint64_t number = tag >> 3u;
+  if (number == 0 || number > PROTO_MAX_FIELD_NUMBER) {
+    return parser_unexpected_field;
+  }
+  field->number = (uint32_t)number;
+  field->wireType = (proto_wire_type_e)(tag & 0x07u);
+  field->value = 0;
+  field->ptr = NULL;
+  field->len = 0;
+
+  switch (field->wireType) {
+  case proto_wire_varint:
+    return read_varint(reader, &field->value);
+  case proto_wire_i64:
+    return read_fixed(reader, 8, &field->value);
+  case proto_wire_i32:
+    return read_fixed(reader, 4, &field->value);
+  case proto_wire_len: {
+    uint64_t len = 0;
+    CHECK_PARSER_ERR(read_varint(reader, &len))
+    if (len > (uint64_t)(reader->end - reader->ptr)) {
+      return parser_proto_unexpected_EOF;
+    }
+    field->ptr = reader->ptr;
+    field->len = (size_t)len;
+    reader->ptr += len;
+    return parser_ok;
+  }
+  default:
+    return parser_proto_unexpected_wire_type;
+  }
+}
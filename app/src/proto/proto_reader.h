@@ -0,0 +1,71 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <common/parser_common.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Reader for protobuf wire format. Fields are returned one at a time with
+// length-delimited payloads pointing into the buffer, so a message is indexed
+// without copying it. Nested messages are read with a new reader over the
+// payload of their field.
+//
+// Groups (wire types 3 and 4) are not used by the Cosmos SDK and are
+// rejected, as are field number 0 and numbers above 2^29 - 1.
+
+#define PROTO_MAX_FIELD_NUMBER 0x1FFFFFFFu
+
+typedef enum {
+  proto_wire_varint = 0,
+  proto_wire_i64 = 1,
+  proto_wire_len = 2,
+  proto_wire_i32 = 5,
+} proto_wire_type_e;
+
+typedef struct {
+  const uint8_t *ptr;
+  const uint8_t *end;
+} proto_reader_t;
+
+typedef struct {
+  uint32_t number;
+  proto_wire_type_e wireType;
+  // Value of varint and fixed width fields
+  uint64_t value;
+  // Payload of length-delimited fields, not terminated
+  const uint8_t *ptr;
+  size_t len;
+} proto_field_t;
+
+/// Starts reading the message held in buffer
+parser_error_t proto_reader_init(proto_reader_t *reader, const uint8_t *buffer,
+                                 size_t bufferLen);
+
+/// True once every field of the message has been read
+bool proto_reader_done(const proto_reader_t *reader);
+
+/// Reads the next field, tag and value
+parser_error_t proto_read_field(proto_reader_t *reader, proto_field_t *field);
+
+#ifdef __cplusplus
+}
+#endif
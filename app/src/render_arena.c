@@ -0,0 +1,34 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "render_arena.h"
+
+static render_arena_t renderArena;
+static render_phase_e renderArenaOwner = render_phase_none;
+
+render_arena_t *render_arena_acquire(render_phase_e phase) {
+  if (phase == render_phase_none || renderArenaOwner != render_phase_none) {
+    return NULL;
+  }
+
+  renderArenaOwner = phase;
+  return &renderArena;
+}
+
+void render_arena_release(render_phase_e phase) {
+  if (renderArenaOwner == phase) {
+    renderArenaOwner = render_phase_none;
+  }
+}
@@ -0,0 +1,79 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "coin.h"
+#include "common/parser.h"
+#include "parser_txdef.h"
+#include <stdint.h>
+
+// Scratch memory used while rendering items. Only one phase can hold the
+// arena at a time; the phases never run nested:
+//
+//   phase      | buffers                                   | bytes
+//   -----------+-------------------------------------------+------
+//   screen     | translated content, title + content, key  | 1267
+//   amount     | formatted amount                          |  160
+//   indexing   | query key/value, grouping references      |  280
+//
+// The arena is sized by the largest phase, so its worst case is the screen
+// phase. Those buffers used to live on the stack on top of the traversal and
+// parsing frames.
+
+typedef enum {
+  render_phase_none = 0,
+  render_phase_screen,
+  render_phase_amount,
+  render_phase_indexing,
+} render_phase_e;
+
+typedef struct {
+  char out[OUTPUT_HANDLER_SIZE];
+  char tmp[TX_TEXTUAL_TMP_BUFFER_SIZE];
+  char key[MAX_TITLE_SIZE + 2];
+} render_screen_t;
+
+typedef struct {
+  char bufferUI[FORMATTED_AMOUNT_BUFFER_SIZE];
+} render_amount_t;
+
+typedef struct {
+  char tmp_key[INDEXING_TMP_KEYSIZE];
+  char tmp_val[INDEXING_TMP_VALUESIZE];
+  char reference_msg_type[INDEXING_GROUPING_REF_TYPE_SIZE];
+  char reference_msg_from[INDEXING_GROUPING_REF_FROM_SIZE];
+} render_indexing_t;
+
+typedef union {
+  render_screen_t screen;
+  render_amount_t amount;
+  render_indexing_t indexing;
+} render_arena_t;
+
+/// Borrows the arena for a phase. The content is not cleared.
+/// \return NULL if the arena is already held
+render_arena_t *render_arena_acquire(render_phase_e phase);
+
+/// Gives the arena back, only if it is held by the same phase
+void render_arena_release(render_phase_e phase);
+
+#ifdef __cplusplus
+}
+#endif
@@ -45,13 +45,13 @@ void handle_get_printable_amount(get_printable_amount_parameters_t *params) {
          params->amount_length);
 
   char tmp_amount[110] = {0};
-  int8_t chain_index = find_chain_index_by_coin_config(
+  const chain_info_t *chain = find_swap_chain_by_coin_config(
       (char *)&params->coin_configuration[1], coin_len);
-  if (chain_index == -1) {
+  if (chain == NULL) {
     return;
   }
   zxerr_t zxerr = bytesAmountToStringBalance(amount, sizeof(amount), tmp_amount,
-                                             sizeof(tmp_amount), chain_index);
+                                             sizeof(tmp_amount), chain);
 
   if (zxerr != zxerr_ok || strnlen(tmp_amount, sizeof(tmp_amount)) >=
                                sizeof(params->printable_amount)) {
@@ -148,15 +148,15 @@ parser_error_t parser_msg_send(parser_context_t *ctx_parsed_tx,
   }
   char tmpKey[20] = {0};
   char tmpValue[65] = {0};
-  int8_t chain_index = 0;
+  const chain_info_t *chain = chain_config_default();
 
   // Check if app is in expert mode
   CHECK_PARSER_ERR(parser_getItem(ctx_parsed_tx, displayIdx, tmpKey,
                                   sizeof(tmpKey), tmpValue, sizeof(tmpValue),
                                   pageIdx, &pageCount))
   if (strcmp(tmpKey, "Chain ID") == 0) {
-    chain_index = find_chain_index_by_chain_id(tmpValue);
-    if (chain_index == -1) {
+    chain = find_swap_chain_by_chain_id(tmpValue);
+    if (chain == NULL) {
       ZEMU_LOGF(200, " Not supported Chain Id\n");
       return parser_swap_wrong_chain_id;
     }
@@ -177,7 +177,7 @@ parser_error_t parser_msg_send(parser_context_t *ctx_parsed_tx,
   displayIdx += 1;
   char tmp_amount[100] = {0};
   zxerr_t zxerr = format_amount(G_swap_state.amount, G_swap_state.amount_length,
-                                tmp_amount, sizeof(tmp_amount), chain_index);
+                                tmp_amount, sizeof(tmp_amount), chain);
   if (zxerr != zxerr_ok) {
     return parser_swap_wrap_amount_computation_error;
   }
@@ -231,7 +231,7 @@ parser_error_t parser_msg_send(parser_context_t *ctx_parsed_tx,
 
   // Check fees
   zxerr = format_amount(G_swap_state.fees, G_swap_state.fees_length, tmp_amount,
-                        sizeof(tmp_amount), chain_index);
+                        sizeof(tmp_amount), chain);
   if (zxerr != zxerr_ok) {
     return parser_swap_wrap_amount_computation_error;
   }
@@ -245,7 +245,7 @@ parser_error_t parser_msg_send(parser_context_t *ctx_parsed_tx,
   switch (has_memo) {
   case 0:
     // When there's no memo, expect one less item
-    if (chain_index != 0 || app_mode_expert()) {
+    if (!chain->isDefault || app_mode_expert()) {
       if (ctx_parsed_tx->tx_obj->tx_json.num_items !=
           EXPERT_SEND_MODE_ITEMS - 1) {
         return parser_swap_unexpected_number_of_items;
@@ -260,7 +260,7 @@ parser_error_t parser_msg_send(parser_context_t *ctx_parsed_tx,
 
   case 1:
     // When there is a memo, expect full number of items
-    if (chain_index != 0 || app_mode_expert()) {
+    if (!chain->isDefault || app_mode_expert()) {
       if (ctx_parsed_tx->tx_obj->tx_json.num_items != EXPERT_SEND_MODE_ITEMS) {
         return parser_swap_unexpected_number_of_items;
       }
@@ -325,14 +325,14 @@ parser_error_t parser_simple_transfer(parser_context_t *ctx_parsed_tx,
 
   char tmpKey[20] = {0};
   char tmpValue[65] = {0};
-  int8_t chain_index = 0;
+  const chain_info_t *chain = chain_config_default();
   // Check if app is in expert mode
   CHECK_PARSER_ERR(parser_getItem(ctx_parsed_tx, displayIdx, tmpKey,
                                   sizeof(tmpKey), tmpValue, sizeof(tmpValue),
                                   pageIdx, &pageCount))
   if (strcmp(tmpKey, "Chain ID") == 0) {
-    chain_index = find_chain_index_by_chain_id(tmpValue);
-    if (chain_index == -1) {
+    chain = find_swap_chain_by_chain_id(tmpValue);
+    if (chain == NULL) {
       ZEMU_LOGF(200, " Not supported Chain Id\n");
       return parser_swap_wrong_chain_id;
     }
@@ -352,7 +352,7 @@ parser_error_t parser_simple_transfer(parser_context_t *ctx_parsed_tx,
   // Check source coins are equal to the amount and equal to destination coins
   char tmp_amount[100] = {0};
   zxerr_t zxerr = format_amount(G_swap_state.amount, G_swap_state.amount_length,
-                                tmp_amount, sizeof(tmp_amount), chain_index);
+                                tmp_amount, sizeof(tmp_amount), chain);
   if (zxerr != zxerr_ok) {
     return parser_swap_wrap_amount_computation_error;
   }
@@ -420,7 +420,7 @@ parser_error_t parser_simple_transfer(parser_context_t *ctx_parsed_tx,
 
   // Check fees
   zxerr = format_amount(G_swap_state.fees, G_swap_state.fees_length, tmp_amount,
-                        sizeof(tmp_amount), chain_index);
+                        sizeof(tmp_amount), chain);
   if (zxerr != zxerr_ok) {
     return parser_swap_wrap_amount_computation_error;
   }
@@ -434,7 +434,7 @@ parser_error_t parser_simple_transfer(parser_context_t *ctx_parsed_tx,
   switch (has_memo) {
   case 0:
     // When there's no memo, expect one less item
-    if (chain_index != 0 || app_mode_expert()) {
+    if (!chain->isDefault || app_mode_expert()) {
       if (ctx_parsed_tx->tx_obj->tx_json.num_items !=
           EXPERT_SEND_MODE_ITEMS - 1) {
         return parser_swap_unexpected_number_of_items;
@@ -449,7 +449,7 @@ parser_error_t parser_simple_transfer(parser_context_t *ctx_parsed_tx,
 
   case 1:
     // When there is a memo, expect full number of items
-    if (chain_index != 0 || app_mode_expert()) {
+    if (!chain->isDefault || app_mode_expert()) {
       if (ctx_parsed_tx->tx_obj->tx_json.num_items != EXPERT_SEND_MODE_ITEMS) {
         return parser_swap_unexpected_number_of_items;
       }
@@ -468,10 +468,15 @@ parser_error_t parser_simple_transfer(parser_context_t *ctx_parsed_tx,
 }
 
 parser_error_t check_swap_conditions(parser_context_t *ctx_parsed_tx) {
-  if (ctx_parsed_tx == NULL) {
+  if (ctx_parsed_tx == NULL || ctx_parsed_tx->tx_obj == NULL) {
     return parser_unexpected_error;
   }
 
+  // Item counts below are read from the JSON object
+  if (ctx_parsed_tx->tx_obj->tx_type == tx_direct) {
+    return parser_swap_wrong_type;
+  }
+
   uint8_t displayIdx = 0;
   uint8_t pageIdx = 0;
   uint8_t pageCount = 0;
@@ -16,6 +16,11 @@
  ********************************************************************************/
 #pragma once
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "chain_config.h"
 #include "lib_standard_app/swap_lib_calls.h"
 #include "parser.h"
 #include "parser_common.h"
@@ -43,16 +48,6 @@ typedef struct {
   char memo[MEMO_MAXSIZE];
 } swap_globals_t;
 
-typedef struct {
-  const char *chain_id;
-  const char *ticker;
-  const char *expert_ticker;
-  uint8_t decimals;
-  const char *coin_config;
-} chains_t;
-
-extern const chains_t chains[];
-extern const uint32_t chains_len;
 extern swap_globals_t G_swap_state;
 
 // Handler for swap features
@@ -63,3 +58,7 @@ bool copy_transaction_parameters(
     create_transaction_parameters_t *sign_transaction_params);
 void __attribute__((noreturn))
 finalize_exchange_sign_transaction(bool is_success);
+
+#ifdef __cplusplus
+}
+#endif
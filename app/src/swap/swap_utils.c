@@ -17,97 +17,90 @@
 #include "app_mode.h"
 #include "bignum.h"
 #include "crypto.h"
+#include "formatting.h"
 #include "lib_standard_app/swap_lib_calls.h"
 #include "swap.h"
 #include "zxformat.h"
 
-const chains_t chains[] = {
-    {COIN_DEFAULT_CHAINID, " ATOM", " uatom", 6, "cosmos"},
-    {OSMOSIS_CHAINID, " OSMO", " uosmo", 6, "osmo"},
-    {DYDX_CHAINID, " DYDX", " adydx", 18, "dydx"},
-    {MANTRA_CHAINID, " OM", " uom", 6, "mantra"},
-    {XION_CHAINID, " XION", " uxion", 6, "xion"},
-    {CELESTIA_CHAINID, " TIA", " utia", 6, "celestia"}};
-
-const uint32_t chains_len = sizeof(chains) / sizeof(chains[0]);
-
-int8_t find_chain_index_by_coin_config(const char *coin_config,
-                                       uint8_t coin_config_len) {
-  if (coin_config == NULL) {
-    return -1;
+// Swap is only supported on chains registered with a chain id and tickers.
+// The coin configuration sent by the exchange is the chain hrp
+const chain_info_t *find_swap_chain_by_coin_config(const char *coin_config,
+                                                   uint8_t coin_config_len) {
+  const chain_info_t *chain = chain_config_by_hrp(coin_config, coin_config_len);
+  if (chain == NULL || chain->chainId == NULL) {
+    return NULL;
   }
+  return chain;
+}
 
-  for (uint8_t i = 0; i < chains_len; i++) {
-    if (coin_config_len == strlen(PIC(chains[i].coin_config)) &&
-        strncmp(coin_config, PIC(chains[i].coin_config), coin_config_len) ==
-            0) {
-      return i;
-    }
+const chain_info_t *find_swap_chain_by_chain_id(const char *chain_id) {
+  if (chain_id == NULL) {
+    return NULL;
   }
 
-  return -1;
+  const size_t chain_id_len = strnlen(chain_id, COIN_MAX_CHAINID_LEN);
+  if (chain_id_len == COIN_MAX_CHAINID_LEN) {
+    return NULL;
+  }
+  return chain_config_by_chain_id(chain_id, (uint8_t)chain_id_len);
 }
 
-int8_t find_chain_index_by_chain_id(const char *chain_id) {
-  if (chain_id == NULL) {
-    return -1;
+// Amounts that do not fit in 128 bits go through the BCD conversion and are
+// then formatted from their digits
+static zxerr_t bytesAmountToFixedPoint(const uint8_t *amount,
+                                       uint8_t amount_len, char *out,
+                                       uint8_t out_len, uint8_t decimals,
+                                       const char *unit) {
+  const uint16_t unitLen = (uint16_t)strlen(unit);
+  zxerr_t err = format_fixed_point_be(out, out_len, amount, amount_len,
+                                      decimals, decimals, unit, unitLen);
+  if (err != zxerr_out_of_bounds) {
+    return err;
   }
 
-  for (uint8_t i = 0; i < chains_len; i++) {
-    if (strcmp(chain_id, PIC(chains[i].chain_id)) == 0) {
-      return i;
-    }
+  uint8_t bcd[COIN_AMOUNT_MAXSIZE] = {0};
+  char digits[2 * COIN_AMOUNT_MAXSIZE + 1] = {0};
+  bignumBigEndian_to_bcd(bcd, sizeof(bcd), amount, amount_len);
+  if (!bignumBigEndian_bcdprint(digits, sizeof(digits), bcd, sizeof(bcd))) {
+    return zxerr_encoding_failed;
   }
 
-  return -1;
+  return format_fixed_point(out, out_len, digits, (uint16_t)strlen(digits),
+                            decimals, decimals, unit, unitLen);
 }
 
 zxerr_t bytesAmountToStringBalance(uint8_t *amount, uint8_t amount_len,
                                    char *out, uint8_t out_len,
-                                   int8_t chain_index) {
-  uint8_t tmpBuf[COIN_AMOUNT_MAXSIZE] = {0};
-
-  bignumBigEndian_to_bcd(tmpBuf, sizeof(tmpBuf), amount, amount_len);
-  bignumBigEndian_bcdprint(out, out_len, tmpBuf, sizeof(tmpBuf));
-
-  // Format number.
-  if (!intstr_to_fpstr_inplace(out, out_len, chains[chain_index].decimals)) {
-    return zxerr_encoding_failed;
+                                   const chain_info_t *chain) {
+  if (chain == NULL) {
+    return zxerr_no_data;
   }
-
-  // Add ticker suffix.
-  CHECK_ZXERR(z_str3join(out, out_len, "", PIC(chains[chain_index].ticker)))
-
-  // Trim trailing zeros
-  number_inplace_trimming(out, 1);
-
-  return zxerr_ok;
+  // All decimals are kept, as in the amounts shown by the parser
+  return bytesAmountToFixedPoint(amount, amount_len, out, out_len,
+                                 chain->decimals, PIC(chain->ticker));
 }
 
 zxerr_t bytesAmountToExpertStringBalance(uint8_t *amount, uint8_t amount_len,
                                          char *out, uint8_t out_len,
-                                         int8_t chain_index) {
-  uint8_t tmpBuf[COIN_AMOUNT_MAXSIZE] = {0};
-
-  bignumBigEndian_to_bcd(tmpBuf, sizeof(tmpBuf), amount, amount_len);
-  bignumBigEndian_bcdprint(out, out_len, tmpBuf, sizeof(tmpBuf));
-
-  // Add expert ticker suffix
-  CHECK_ZXERR(
-      z_str3join(out, out_len, "", PIC(chains[chain_index].expert_ticker)))
-
-  return zxerr_ok;
+                                         const chain_info_t *chain) {
+  if (chain == NULL) {
+    return zxerr_no_data;
+  }
+  return bytesAmountToFixedPoint(amount, amount_len, out, out_len, 0,
+                                 PIC(chain->expertTicker));
 }
 
 zxerr_t format_amount(uint8_t *amount, uint8_t amount_len, char *out,
-                      uint8_t out_len, int8_t chain_index) {
+                      uint8_t out_len, const chain_info_t *chain) {
+  if (chain == NULL) {
+    return zxerr_no_data;
+  }
   // expert or not default chain
-  if (app_mode_expert() || chain_index != 0) {
+  if (app_mode_expert() || !chain->isDefault) {
     return bytesAmountToExpertStringBalance(amount, amount_len, out, out_len,
-                                            chain_index);
+                                            chain);
   } else {
-    return bytesAmountToStringBalance(amount, amount_len, out, out_len,
-                                      chain_index);
+    return bytesAmountToStringBalance(amount, amount_len, out, out_len, chain);
   }
 }
 
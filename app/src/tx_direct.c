@@ -0,0 +1,916 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "tx_direct.h"
+#include "app_mode.h"
+#include "chain_config.h"
+#include "coin.h"
+#include "common/parser.h"
+#include "formatting.h"
+#include "render_arena.h"
+#include <proto/proto_reader.h>
+#include <stdio.h>
+#include <string.h>
+#include <zxformat.h>
+#include <zxmacros.h>
+
+// Longest uint64 in decimal, and its terminator
+#define DIRECT_NUMBER_SIZE 21u
+
+typedef enum {
+  direct_field_string = 0,
+  // A single Coin
+  direct_field_coin,
+  // Repeated Coin, shown as a single item
+  direct_field_coins,
+} direct_field_kind_e;
+
+typedef struct {
+  uint8_t number;
+  uint8_t kind;
+  const char *label;
+} direct_field_schema_t;
+
+#define DIRECT_MAX_MSG_FIELDS 4u
+
+typedef struct {
+  const char *typeUrl;
+  const char *name;
+  // Field holding the delegator, grouped across messages. 0 if there is none
+  uint8_t fromField;
+  uint8_t numFields;
+  // Display order, which follows the sorted keys of the amino JSON
+  direct_field_schema_t fields[DIRECT_MAX_MSG_FIELDS];
+} direct_msg_schema_t;
+
+static const direct_msg_schema_t msg_schemas[] = {
+    {"/cosmos.bank.v1beta1.MsgSend",
+     "Send",
+     0,
+     3,
+     {{3, direct_field_coins, "Amount"},
+      {1, direct_field_string, "From"},
+      {2, direct_field_string, "To"}}},
+    {"/cosmos.staking.v1beta1.MsgDelegate",
+     "Delegate",
+     1,
+     3,
+     {{3, direct_field_coin, "Amount"},
+      {1, direct_field_string, "Delegator"},
+      {2, direct_field_string, "Validator"}}},
+    {"/cosmos.staking.v1beta1.MsgUndelegate",
+     "Undelegate",
+     1,
+     3,
+     {{3, direct_field_coin, "Amount"},
+      {1, direct_field_string, "Delegator"},
+      {2, direct_field_string, "Validator"}}},
+    {"/cosmos.staking.v1beta1.MsgBeginRedelegate",
+     "Redelegate",
+     1,
+     4,
+     {{4, direct_field_coin, "Amount"},
+      {1, direct_field_string, "Delegator"},
+      {3, direct_field_string, "Validator Dest"},
+      {2, direct_field_string, "Validator Source"}}},
+    {"/cosmos.distribution.v1beta1.MsgWithdrawDelegatorReward",
+     "Withdraw Reward",
+     1,
+     2,
+     {{1, direct_field_string, "Delegator"},
+      {2, direct_field_string, "Validator"}}},
+    {"/cosmos.distribution.v1beta1.MsgSetWithdrawAddress",
+     "Withdraw Set Address",
+     1,
+     2,
+     {{1, direct_field_string, "Delegator"},
+      {2, direct_field_string, "Withdraw Address"}}},
+    {"/cosmos.distribution.v1beta1.MsgWithdrawValidatorCommission",
+     "Withdraw Val. Commission",
+     0,
+     1,
+     {{1, direct_field_string, "Validator"}}},
+};
+
+typedef enum {
+  direct_item_chain_id = 0,
+  direct_item_account,
+  direct_item_sequence,
+  direct_item_msg_type,
+  direct_item_msg_field,
+  direct_item_memo,
+  direct_item_fee,
+  direct_item_gas,
+  direct_item_granter,
+  direct_item_payer,
+} direct_item_e;
+
+typedef struct {
+  direct_item_e kind;
+  uint8_t msg;
+  uint8_t field;
+} direct_item_t;
+
+typedef struct {
+  uint16_t target;
+  uint16_t count;
+  direct_item_t *item;
+} direct_walk_t;
+
+///////////////////////////////////////////////////////////////////////////////
+// Parsing
+///////////////////////////////////////////////////////////////////////////////
+
+__Z_INLINE parser_error_t direct_expectWire(const proto_field_t *field,
+                                            proto_wire_type_e wireType) {
+  return field->wireType == wireType ? parser_ok
+                                     : parser_proto_unexpected_wire_type;
+}
+
+// Every known field is singular unless stated otherwise. The last occurrence
+// would win for protobuf, so a repeated one could hide what is shown.
+__Z_INLINE parser_error_t direct_markSeen(uint32_t *seen, uint32_t number) {
+  if (number >= 32 || (*seen & (1u << number)) != 0) {
+    return parser_duplicated_field;
+  }
+  *seen |= 1u << number;
+  return parser_ok;
+}
+
+__Z_INLINE void direct_store(direct_bytes_t *out, const uint8_t *buffer,
+                             const proto_field_t *field) {
+  out->offset = (uint32_t)(field->ptr - buffer);
+  out->len = (uint32_t)field->len;
+}
+
+// Strings are shown as they are, so only printable ASCII is accepted
+static parser_error_t direct_checkText(const uint8_t *ptr, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (ptr[i] < 0x20 || ptr[i] > 0x7E) {
+      return parser_unexpected_characters;
+    }
+  }
+  return parser_ok;
+}
+
+static parser_error_t direct_readCoin(const uint8_t *ptr, size_t len,
+                                      proto_field_t *denom,
+                                      proto_field_t *amount) {
+  MEMZERO(denom, sizeof(*denom));
+  MEMZERO(amount, sizeof(*amount));
+
+  proto_reader_t reader;
+  proto_field_t field;
+  uint32_t seen = 0;
+  CHECK_PARSER_ERR(proto_reader_init(&reader, ptr, len))
+  while (!proto_reader_done(&reader)) {
+    CHECK_PARSER_ERR(proto_read_field(&reader, &field))
+    switch (field.number) {
+    case COIN_DENOM:
+      *denom = field;
+      break;
+    case COIN_AMOUNT:
+      *amount = field;
+      break;
+    default:
+      return parser_unexpected_field;
+    }
+    CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_len))
+    CHECK_PARSER_ERR(direct_markSeen(&seen, field.number))
+  }
+
+  if (denom->len == 0 || denom->len >= COIN_DENOM_MAXSIZE) {
+    return parser_unexpected_value;
+  }
+  if (amount->len == 0 || amount->len >= COIN_AMOUNT_MAXSIZE) {
+    return parser_unexpected_value;
+  }
+  CHECK_PARSER_ERR(direct_checkText(denom->ptr, denom->len))
+  for (size_t i = 0; i < amount->len; i++) {
+    if (amount->ptr[i] < '0' || amount->ptr[i] > '9') {
+      return parser_unexpected_characters;
+    }
+  }
+  return parser_ok;
+}
+
+static const direct_field_schema_t *
+direct_fieldSchema(const direct_msg_schema_t *schema, uint32_t number) {
+  for (uint8_t i = 0; i < schema->numFields; i++) {
+    if (schema->fields[i].number == number) {
+      return &schema->fields[i];
+    }
+  }
+  return NULL;
+}
+
+// Checks a message against its schema and returns its delegator, if any
+static parser_error_t direct_checkMsg(const direct_msg_schema_t *schema,
+                                      const uint8_t *ptr, size_t len,
+                                      const uint8_t **from, size_t *fromLen) {
+  proto_reader_t reader;
+  proto_field_t field;
+  uint32_t seen = 0;
+  CHECK_PARSER_ERR(proto_reader_init(&reader, ptr, len))
+  while (!proto_reader_done(&reader)) {
+    CHECK_PARSER_ERR(proto_read_field(&reader, &field))
+    const direct_field_schema_t *def = direct_fieldSchema(schema, field.number);
+    if (def == NULL) {
+      return parser_unexpected_field;
+    }
+    CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_len))
+
+    proto_field_t denom;
+    proto_field_t amount;
+    switch (def->kind) {
+    case direct_field_coins:
+      seen |= 1u << field.number;
+      CHECK_PARSER_ERR(direct_readCoin(field.ptr, field.len, &denom, &amount))
+      break;
+    case direct_field_coin:
+      CHECK_PARSER_ERR(direct_markSeen(&seen, field.number))
+      CHECK_PARSER_ERR(direct_readCoin(field.ptr, field.len, &denom, &amount))
+      break;
+    default:
+      CHECK_PARSER_ERR(direct_markSeen(&seen, field.number))
+      CHECK_PARSER_ERR(direct_checkText(field.ptr, field.len))
+      break;
+    }
+
+    if (field.number == schema->fromField) {
+      *from = field.ptr;
+      *fromLen = field.len;
+    }
+  }
+
+  // Every field of the schema is shown, so all of them must be there
+  for (uint8_t i = 0; i < schema->numFields; i++) {
+    if ((seen & (1u << schema->fields[i].number)) == 0) {
+      return parser_missing_field;
+    }
+  }
+  return parser_ok;
+}
+
+parser_error_t tx_direct_findSchema(const uint8_t *typeUrl, size_t typeUrlLen,
+                                    uint8_t *schema) {
+  if (typeUrl == NULL || schema == NULL) {
+    return parser_unexpected_value;
+  }
+  for (uint8_t i = 0; i < array_length(msg_schemas); i++) {
+    const char *url = (const char *)PIC(msg_schemas[i].typeUrl);
+    if (strlen(url) == typeUrlLen && memcmp(url, typeUrl, typeUrlLen) == 0) {
+      *schema = i;
+      return parser_ok;
+    }
+  }
+
+  // Messages without a schema cannot be shown
+  return parser_unexpected_type;
+}
+
+static parser_error_t direct_parseMsg(const uint8_t *buffer,
+                                      const proto_field_t *any,
+                                      direct_msg_t *msg) {
+  proto_reader_t reader;
+  proto_field_t field;
+  proto_field_t typeUrl = {0};
+  proto_field_t value = {0};
+  uint32_t seen = 0;
+  CHECK_PARSER_ERR(proto_reader_init(&reader, any->ptr, any->len))
+  while (!proto_reader_done(&reader)) {
+    CHECK_PARSER_ERR(proto_read_field(&reader, &field))
+    switch (field.number) {
+    case ANY_TYPE_URL:
+      typeUrl = field;
+      break;
+    case ANY_VALUE:
+      value = field;
+      break;
+    default:
+      return parser_unexpected_field;
+    }
+    CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_len))
+    CHECK_PARSER_ERR(direct_markSeen(&seen, field.number))
+  }
+  if (typeUrl.ptr == NULL || value.ptr == NULL) {
+    return parser_missing_field;
+  }
+
+  CHECK_PARSER_ERR(tx_direct_findSchema(typeUrl.ptr, typeUrl.len, &msg->schema))
+  direct_store(&msg->value, buffer, &value);
+  return parser_ok;
+}
+
+static parser_error_t direct_parseBody(const uint8_t *buffer,
+                                       const proto_field_t *body,
+                                       tx_direct_t *tx) {
+  proto_reader_t reader;
+  proto_field_t field;
+  uint32_t seen = 0;
+  CHECK_PARSER_ERR(proto_reader_init(&reader, body->ptr, body->len))
+  while (!proto_reader_done(&reader)) {
+    CHECK_PARSER_ERR(proto_read_field(&reader, &field))
+    switch (field.number) {
+    case TX_BODY_MESSAGES:
+      CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_len))
+      if (tx->numMsgs >= DIRECT_MAX_MSGS) {
+        return parser_unexpected_number_items;
+      }
+      CHECK_PARSER_ERR(direct_parseMsg(buffer, &field, &tx->msgs[tx->numMsgs]))
+      tx->numMsgs++;
+      continue;
+    case TX_BODY_MEMO:
+      CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_len))
+      direct_store(&tx->memo, buffer, &field);
+      break;
+    case TX_BODY_TIMEOUT_HEIGHT:
+      // Only narrows when the transaction is valid, it is not shown
+      CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_varint))
+      break;
+    default:
+      // Extension options change how the transaction is processed
+      return parser_unexpected_field;
+    }
+    CHECK_PARSER_ERR(direct_markSeen(&seen, field.number))
+  }
+  return parser_ok;
+}
+
+static parser_error_t direct_parseSignerInfo(const proto_field_t *info,
+                                             tx_direct_t *tx) {
+  proto_reader_t reader;
+  proto_field_t field;
+  uint32_t seen = 0;
+  CHECK_PARSER_ERR(proto_reader_init(&reader, info->ptr, info->len))
+  while (!proto_reader_done(&reader)) {
+    CHECK_PARSER_ERR(proto_read_field(&reader, &field))
+    switch (field.number) {
+    case SIGNER_INFO_PUBLIC_KEY:
+    case SIGNER_INFO_MODE_INFO:
+      CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_len))
+      break;
+    case SIGNER_INFO_SEQUENCE:
+      CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_varint))
+      tx->sequence = field.value;
+      break;
+    default:
+      return parser_unexpected_field;
+    }
+    CHECK_PARSER_ERR(direct_markSeen(&seen, field.number))
+  }
+  return parser_ok;
+}
+
+static parser_error_t direct_checkFee(const uint8_t *buffer,
+                                      tx_direct_t *tx) {
+  proto_reader_t reader;
+  proto_field_t field;
+  proto_field_t denom;
+  proto_field_t amount;
+  uint32_t seen = 0;
+  CHECK_PARSER_ERR(
+      proto_reader_init(&reader, buffer + tx->fee.offset, tx->fee.len))
+  while (!proto_reader_done(&reader)) {
+    CHECK_PARSER_ERR(proto_read_field(&reader, &field))
+    switch (field.number) {
+    case FEE_AMOUNT:
+      CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_len))
+      CHECK_PARSER_ERR(direct_readCoin(field.ptr, field.len, &denom, &amount))
+      continue;
+    case FEE_GAS_LIMIT:
+      CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_varint))
+      tx->gasLimit = field.value;
+      break;
+    case FEE_PAYER:
+    case FEE_GRANTER:
+      CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_len))
+      CHECK_PARSER_ERR(direct_checkText(field.ptr, field.len))
+      direct_store(field.number == FEE_PAYER ? &tx->payer : &tx->granter,
+                   buffer, &field);
+      break;
+    default:
+      return parser_unexpected_field;
+    }
+    CHECK_PARSER_ERR(direct_markSeen(&seen, field.number))
+  }
+  return parser_ok;
+}
+
+static parser_error_t direct_parseAuthInfo(const uint8_t *buffer,
+                                           const proto_field_t *authInfo,
+                                           tx_direct_t *tx) {
+  proto_reader_t reader;
+  proto_field_t field;
+  uint8_t signers = 0;
+  uint32_t seen = 0;
+  CHECK_PARSER_ERR(proto_reader_init(&reader, authInfo->ptr, authInfo->len))
+  while (!proto_reader_done(&reader)) {
+    CHECK_PARSER_ERR(proto_read_field(&reader, &field))
+    CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_len))
+    switch (field.number) {
+    case AUTH_INFO_SIGNER_INFOS:
+      // The sequence shown is the one of the only signer
+      if (signers++ > 0) {
+        return parser_unexpected_number_items;
+      }
+      CHECK_PARSER_ERR(direct_parseSignerInfo(&field, tx))
+      break;
+    case AUTH_INFO_FEE:
+      CHECK_PARSER_ERR(direct_markSeen(&seen, field.number))
+      direct_store(&tx->fee, buffer, &field);
+      break;
+    default:
+      // Tips are not supported
+      return parser_unexpected_field;
+    }
+  }
+
+  if (signers == 0 || (seen & (1u << AUTH_INFO_FEE)) == 0) {
+    return parser_missing_field;
+  }
+  return parser_ok;
+}
+
+static parser_error_t direct_checkChain(const uint8_t *buffer,
+                                        tx_direct_t *tx) {
+  tx->defaultChain = false;
+  if (tx->chainId.len == 0) {
+    return parser_missing_field;
+  }
+  if (tx->chainId.len > UINT8_MAX) {
+    return parser_value_out_of_range;
+  }
+
+  const char *chainId = (const char *)buffer + tx->chainId.offset;
+  const chain_info_t *chain =
+      chain_config_by_chain_id(chainId, (uint8_t)tx->chainId.len);
+  if (chain != NULL && chain->isDefault) {
+    tx->defaultChain = true;
+  } else if (tx->chainId.len == 1 && (chainId[0] == '0' || chainId[0] == '1')) {
+    return parser_unexpected_chain;
+  }
+  return parser_ok;
+}
+
+__Z_INLINE bool direct_inBuffer(direct_bytes_t bytes, size_t bufferLen) {
+  return bytes.offset <= bufferLen && bytes.len <= bufferLen - bytes.offset;
+}
+
+// Goes through the messages, checking them and finding what can be grouped
+static parser_error_t direct_checkMsgs(const uint8_t *buffer, size_t bufferLen,
+                                       const char *ownAddr, size_t ownAddrLen,
+                                       tx_direct_t *tx) {
+  if (tx->numMsgs == 0 || tx->numMsgs > DIRECT_MAX_MSGS) {
+    return parser_unexpected_number_items;
+  }
+
+  const uint8_t *refFrom = NULL;
+  size_t refFromLen = 0;
+  tx->typeGrouping = true;
+  tx->fromGrouping = false;
+  tx->fromMsg = 0;
+  for (uint8_t m = 0; m < tx->numMsgs; m++) {
+    const direct_msg_t *msg = &tx->msgs[m];
+    if (msg->schema >= array_length(msg_schemas) ||
+        !direct_inBuffer(msg->value, bufferLen)) {
+      return parser_unexpected_value;
+    }
+
+    const uint8_t *from = NULL;
+    size_t fromLen = 0;
+    CHECK_PARSER_ERR(direct_checkMsg(&msg_schemas[msg->schema],
+                                     buffer + msg->value.offset,
+                                     msg->value.len, &from, &fromLen))
+
+    if (msg->schema != tx->msgs[0].schema) {
+      tx->typeGrouping = false;
+    }
+    if (from == NULL) {
+      continue;
+    }
+    if (refFrom == NULL) {
+      refFrom = from;
+      refFromLen = fromLen;
+      tx->fromMsg = m;
+      tx->fromGrouping = true;
+    } else if (fromLen != refFromLen || memcmp(from, refFrom, fromLen) != 0) {
+      tx->fromGrouping = false;
+    }
+  }
+
+  tx->fromIsOwn = refFrom != NULL && ownAddr != NULL &&
+                  ownAddrLen == refFromLen &&
+                  memcmp(ownAddr, refFrom, refFromLen) == 0;
+  return parser_ok;
+}
+
+parser_error_t tx_direct_build(const uint8_t *buffer, size_t bufferLen,
+                               const char *ownAddr, size_t ownAddrLen,
+                               tx_direct_t *tx) {
+  if (buffer == NULL || tx == NULL) {
+    return parser_unexpected_value;
+  }
+  if (!direct_inBuffer(tx->chainId, bufferLen) ||
+      !direct_inBuffer(tx->memo, bufferLen) ||
+      !direct_inBuffer(tx->fee, bufferLen)) {
+    return parser_unexpected_value;
+  }
+
+  CHECK_PARSER_ERR(direct_checkMsgs(buffer, bufferLen, ownAddr, ownAddrLen, tx))
+  CHECK_PARSER_ERR(
+      direct_checkText(buffer + tx->chainId.offset, tx->chainId.len))
+  CHECK_PARSER_ERR(direct_checkText(buffer + tx->memo.offset, tx->memo.len))
+  tx->gasLimit = 0;
+  tx->payer = (direct_bytes_t){0};
+  tx->granter = (direct_bytes_t){0};
+  CHECK_PARSER_ERR(direct_checkFee(buffer, tx))
+  CHECK_PARSER_ERR(direct_checkChain(buffer, tx))
+
+  return parser_ok;
+}
+
+parser_error_t tx_direct_parse(const uint8_t *buffer, size_t bufferLen,
+                               const char *ownAddr, size_t ownAddrLen,
+                               tx_direct_t *tx) {
+  if (buffer == NULL || tx == NULL) {
+    return parser_unexpected_value;
+  }
+  MEMZERO(tx, sizeof(*tx));
+
+  proto_reader_t reader;
+  proto_field_t field;
+  proto_field_t body = {0};
+  proto_field_t authInfo = {0};
+  uint32_t seen = 0;
+  CHECK_PARSER_ERR(proto_reader_init(&reader, buffer, bufferLen))
+  while (!proto_reader_done(&reader)) {
+    CHECK_PARSER_ERR(proto_read_field(&reader, &field))
+    switch (field.number) {
+    case SIGN_DOC_BODY_BYTES:
+      CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_len))
+      body = field;
+      break;
+    case SIGN_DOC_AUTH_INFO_BYTES:
+      CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_len))
+      authInfo = field;
+      break;
+    case SIGN_DOC_CHAIN_ID:
+      CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_len))
+      direct_store(&tx->chainId, buffer, &field);
+      break;
+    case SIGN_DOC_ACCOUNT_NUMBER:
+      CHECK_PARSER_ERR(direct_expectWire(&field, proto_wire_varint))
+      tx->accountNumber = field.value;
+      break;
+    default:
+      return parser_unexpected_field;
+    }
+    CHECK_PARSER_ERR(direct_markSeen(&seen, field.number))
+  }
+
+  if (body.ptr == NULL || authInfo.ptr == NULL) {
+    return parser_missing_field;
+  }
+  CHECK_PARSER_ERR(direct_parseBody(buffer, &body, tx))
+  CHECK_PARSER_ERR(direct_parseAuthInfo(buffer, &authInfo, tx))
+
+  return tx_direct_build(buffer, bufferLen, ownAddr, ownAddrLen, tx);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Display
+///////////////////////////////////////////////////////////////////////////////
+
+__Z_INLINE bool direct_showDetails(const tx_direct_t *tx) {
+  return app_mode_expert() || !tx->defaultChain;
+}
+
+__Z_INLINE bool direct_visit(direct_walk_t *walk, direct_item_e kind,
+                             uint8_t msg, uint8_t field) {
+  if (walk->count == walk->target) {
+    walk->item->kind = kind;
+    walk->item->msg = msg;
+    walk->item->field = field;
+    return true;
+  }
+  walk->count++;
+  return false;
+}
+
+#define DIRECT_VISIT(WALK, KIND, MSG, FIELD)                                   \
+  if (direct_visit(WALK, KIND, MSG, FIELD)) {                                  \
+    return true;                                                               \
+  }
+
+// Goes through the items in display order, following the same rules as for
+// JSON. Stops at walk->target, otherwise count ends up as the number of items.
+static bool direct_walkItems(const tx_direct_t *tx, direct_walk_t *walk) {
+  const bool details = direct_showDetails(tx);
+  if (details) {
+    DIRECT_VISIT(walk, direct_item_chain_id, 0, 0)
+    DIRECT_VISIT(walk, direct_item_account, 0, 0)
+    DIRECT_VISIT(walk, direct_item_sequence, 0, 0)
+  }
+
+  const bool fromGrouping = tx->fromGrouping && !details;
+  for (uint8_t m = 0; m < tx->numMsgs && m < DIRECT_MAX_MSGS; m++) {
+    if (!tx->typeGrouping || m == 0) {
+      DIRECT_VISIT(walk, direct_item_msg_type, m, 0)
+    }
+
+    const direct_msg_schema_t *schema = &msg_schemas[tx->msgs[m].schema];
+    for (uint8_t f = 0; f < schema->numFields; f++) {
+      const bool groupedFrom =
+          fromGrouping && schema->fields[f].number == schema->fromField &&
+          (tx->fromIsOwn || m != tx->fromMsg);
+      if (groupedFrom) {
+        continue;
+      }
+      DIRECT_VISIT(walk, direct_item_msg_field, m, f)
+    }
+  }
+
+  if (tx->memo.len > 0) {
+    DIRECT_VISIT(walk, direct_item_memo, 0, 0)
+  }
+  DIRECT_VISIT(walk, direct_item_fee, 0, 0)
+  if (details) {
+    DIRECT_VISIT(walk, direct_item_gas, 0, 0)
+    if (tx->granter.len > 0) {
+      DIRECT_VISIT(walk, direct_item_granter, 0, 0)
+    }
+    if (tx->payer.len > 0) {
+      DIRECT_VISIT(walk, direct_item_payer, 0, 0)
+    }
+  }
+  return false;
+}
+
+parser_error_t tx_direct_numItems(const tx_direct_t *tx, uint8_t *numItems) {
+  if (tx == NULL || numItems == NULL) {
+    return parser_unexpected_value;
+  }
+
+  direct_item_t item;
+  direct_walk_t walk = {.target = UINT16_MAX, .count = 0, .item = &item};
+  (void)direct_walkItems(tx, &walk);
+  if (walk.count > UINT8_MAX) {
+    return parser_unexpected_number_items;
+  }
+  *numItems = (uint8_t)walk.count;
+  return parser_ok;
+}
+
+static parser_error_t direct_printText(const uint8_t *buffer,
+                                       direct_bytes_t text, char *outVal,
+                                       uint16_t outValLen, uint8_t pageIdx,
+                                       uint8_t *pageCount) {
+  // Empty strings still take a page
+  *pageCount = 1;
+  if (text.len > 0) {
+    pageStringExt(outVal, outValLen, (const char *)buffer + text.offset,
+                  text.len, pageIdx, pageCount);
+  }
+  return parser_ok;
+}
+
+static parser_error_t direct_printNumber(uint64_t value, char *outVal,
+                                         uint16_t outValLen, uint8_t pageIdx,
+                                         uint8_t *pageCount) {
+  char number[DIRECT_NUMBER_SIZE];
+  if (format_fixed_point_u64(number, sizeof(number), value, 0, 0, NULL, 0) !=
+      zxerr_ok) {
+    return parser_unexpected_value;
+  }
+  pageString(outVal, outValLen, number, pageIdx, pageCount);
+  return parser_ok;
+}
+
+static parser_error_t direct_formatCoin(const uint8_t *ptr, size_t len,
+                                        bool details, char *out,
+                                        uint16_t outLen) {
+  proto_field_t denom;
+  proto_field_t amount;
+  CHECK_PARSER_ERR(direct_readCoin(ptr, len, &denom, &amount))
+
+  // Raw amount and denomination unless it is the default one
+  const char *unit = (const char *)denom.ptr;
+  uint16_t unitLen = (uint16_t)denom.len;
+  uint8_t decimals = 0;
+  uint8_t minDecimals = 0;
+  if (!details && unitLen == strlen(COIN_DEFAULT_DENOM_BASE) &&
+      memcmp(unit, COIN_DEFAULT_DENOM_BASE, unitLen) == 0) {
+    unit = COIN_DEFAULT_DENOM_REPR;
+    unitLen = sizeof(COIN_DEFAULT_DENOM_REPR) - 1;
+    decimals = COIN_DEFAULT_DENOM_FACTOR;
+    minDecimals = COIN_DEFAULT_DENOM_TRIMMING;
+  }
+
+  if (format_fixed_point(out, outLen, (const char *)amount.ptr,
+                         (uint16_t)amount.len, decimals, minDecimals, unit,
+                         unitLen) != zxerr_ok) {
+    return parser_unexpected_buffer_end;
+  }
+  return parser_ok;
+}
+
+// Coins are shown one after the other, each on its own pages
+static parser_error_t direct_printCoinsWith(
+    char *bufferUI, uint16_t bufferUILen, const uint8_t *ptr, size_t len,
+    uint32_t number, bool details, char *outVal, uint16_t outValLen,
+    uint8_t pageIdx, uint8_t *pageCount) {
+  proto_reader_t reader;
+  proto_field_t field;
+  proto_field_t shown = {0};
+  uint8_t shownPage = 0;
+  uint8_t totalPages = 0;
+  CHECK_PARSER_ERR(proto_reader_init(&reader, ptr, len))
+  while (!proto_reader_done(&reader)) {
+    CHECK_PARSER_ERR(proto_read_field(&reader, &field))
+    if (field.number != number) {
+      continue;
+    }
+
+    uint8_t pages = 0;
+    CHECK_PARSER_ERR(
+        direct_formatCoin(field.ptr, field.len, details, bufferUI, bufferUILen))
+    pageString(outVal, outValLen, bufferUI, 0, &pages);
+    if (shown.ptr == NULL && pageIdx < (uint16_t)totalPages + pages) {
+      shown = field;
+      shownPage = pageIdx - totalPages;
+    }
+    if (totalPages > UINT8_MAX - pages) {
+      return parser_value_out_of_range;
+    }
+    totalPages += pages;
+  }
+
+  if (totalPages == 0) {
+    *pageCount = 1;
+    snprintf(outVal, outValLen, "Empty");
+    return parser_ok;
+  }
+  *pageCount = totalPages;
+  if (shown.ptr == NULL) {
+    return parser_display_page_out_of_range;
+  }
+
+  uint8_t pages = 0;
+  CHECK_PARSER_ERR(
+      direct_formatCoin(shown.ptr, shown.len, details, bufferUI, bufferUILen))
+  pageString(outVal, outValLen, bufferUI, shownPage, &pages);
+  return parser_ok;
+}
+
+static parser_error_t direct_printCoins(const uint8_t *buffer,
+                                        direct_bytes_t coins, uint32_t number,
+                                        bool details, char *outVal,
+                                        uint16_t outValLen, uint8_t pageIdx,
+                                        uint8_t *pageCount) {
+  render_arena_t *arena = render_arena_acquire(render_phase_amount);
+  if (arena == NULL) {
+    return parser_unexpected_error;
+  }
+  const parser_error_t err = direct_printCoinsWith(
+      arena->amount.bufferUI, sizeof(arena->amount.bufferUI),
+      buffer + coins.offset, coins.len, number, details, outVal, outValLen,
+      pageIdx, pageCount);
+  render_arena_release(render_phase_amount);
+  return err;
+}
+
+static parser_error_t direct_findField(const uint8_t *buffer,
+                                       direct_bytes_t msg, uint32_t number,
+                                       direct_bytes_t *out) {
+  proto_reader_t reader;
+  proto_field_t field;
+  CHECK_PARSER_ERR(
+      proto_reader_init(&reader, buffer + msg.offset, (size_t)msg.len))
+  while (!proto_reader_done(&reader)) {
+    CHECK_PARSER_ERR(proto_read_field(&reader, &field))
+    if (field.number == number) {
+      direct_store(out, buffer, &field);
+      return parser_ok;
+    }
+  }
+  return parser_missing_field;
+}
+
+static parser_error_t direct_printMsgField(const uint8_t *buffer,
+                                           const tx_direct_t *tx,
+                                           const direct_item_t *item,
+                                           char *outKey, uint16_t outKeyLen,
+                                           char *outVal, uint16_t outValLen,
+                                           uint8_t pageIdx,
+                                           uint8_t *pageCount) {
+  const direct_msg_t *msg = &tx->msgs[item->msg];
+  const direct_msg_schema_t *schema = &msg_schemas[msg->schema];
+  if (item->kind == direct_item_msg_type) {
+    snprintf(outKey, outKeyLen, "Type");
+    pageString(outVal, outValLen, (const char *)PIC(schema->name), pageIdx,
+               pageCount);
+    return parser_ok;
+  }
+
+  const direct_field_schema_t *def = &schema->fields[item->field];
+  snprintf(outKey, outKeyLen, "%s", (const char *)PIC(def->label));
+  if (def->kind != direct_field_string) {
+    return direct_printCoins(buffer, msg->value, def->number,
+                             direct_showDetails(tx), outVal, outValLen,
+                             pageIdx, pageCount);
+  }
+
+  direct_bytes_t text = {0};
+  CHECK_PARSER_ERR(direct_findField(buffer, msg->value, def->number, &text))
+  return direct_printText(buffer, text, outVal, outValLen, pageIdx, pageCount);
+}
+
+parser_error_t tx_direct_getItem(const uint8_t *buffer, const tx_direct_t *tx,
+                                 uint8_t displayIdx, char *outKey,
+                                 uint16_t outKeyLen, char *outVal,
+                                 uint16_t outValLen, uint8_t pageIdx,
+                                 uint8_t *pageCount) {
+  if (buffer == NULL || tx == NULL || pageCount == NULL) {
+    return parser_unexpected_value;
+  }
+
+  *pageCount = 0;
+  MEMZERO(outKey, outKeyLen);
+  MEMZERO(outVal, outValLen);
+
+  direct_item_t item;
+  direct_walk_t walk = {.target = displayIdx, .count = 0, .item = &item};
+  if (!direct_walkItems(tx, &walk)) {
+    return parser_display_idx_out_of_range;
+  }
+
+  switch (item.kind) {
+  case direct_item_chain_id:
+    snprintf(outKey, outKeyLen, "Chain ID");
+    CHECK_PARSER_ERR(direct_printText(buffer, tx->chainId, outVal, outValLen,
+                                      pageIdx, pageCount))
+    break;
+  case direct_item_account:
+    snprintf(outKey, outKeyLen, "Account");
+    CHECK_PARSER_ERR(direct_printNumber(tx->accountNumber, outVal, outValLen,
+                                        pageIdx, pageCount))
+    break;
+  case direct_item_sequence:
+    snprintf(outKey, outKeyLen, "Sequence");
+    CHECK_PARSER_ERR(direct_printNumber(tx->sequence, outVal, outValLen,
+                                        pageIdx, pageCount))
+    break;
+  case direct_item_msg_type:
+  case direct_item_msg_field:
+    CHECK_PARSER_ERR(direct_printMsgField(buffer, tx, &item, outKey, outKeyLen,
+                                          outVal, outValLen, pageIdx,
+                                          pageCount))
+    break;
+  case direct_item_memo:
+    snprintf(outKey, outKeyLen, "Memo");
+    CHECK_PARSER_ERR(direct_printText(buffer, tx->memo, outVal, outValLen,
+                                      pageIdx, pageCount))
+    break;
+  case direct_item_fee:
+    snprintf(outKey, outKeyLen, "Fee");
+    CHECK_PARSER_ERR(direct_printCoins(buffer, tx->fee, FEE_AMOUNT,
+                                       direct_showDetails(tx), outVal,
+                                       outValLen, pageIdx, pageCount))
+    break;
+  case direct_item_gas:
+    snprintf(outKey, outKeyLen, "Gas");
+    CHECK_PARSER_ERR(direct_printNumber(tx->gasLimit, outVal, outValLen,
+                                        pageIdx, pageCount))
+    break;
+  case direct_item_granter:
+    snprintf(outKey, outKeyLen, "Granter");
+    CHECK_PARSER_ERR(direct_printText(buffer, tx->granter, outVal, outValLen,
+                                      pageIdx, pageCount))
+    break;
+  case direct_item_payer:
+    snprintf(outKey, outKeyLen, "Payer");
+    CHECK_PARSER_ERR(direct_printText(buffer, tx->payer, outVal, outValLen,
+                                      pageIdx, pageCount))
+    break;
+  default:
+    return parser_unexpected_value;
+  }
+
+  if (pageIdx >= *pageCount) {
+    return parser_display_page_out_of_range;
+  }
+  return parser_ok;
+}
@@ -0,0 +1,94 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "parser_txdef.h"
+#include <common/parser_common.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// SIGN_MODE_DIRECT: the blob is a protobuf SignDoc, whose TxBody and AuthInfo
+// are decoded and checked while parsing. Only messages with a known schema
+// are accepted, and every field they carry must be shown.
+
+// cosmos.tx.v1beta1.SignDoc
+#define SIGN_DOC_BODY_BYTES 1u
+#define SIGN_DOC_AUTH_INFO_BYTES 2u
+#define SIGN_DOC_CHAIN_ID 3u
+#define SIGN_DOC_ACCOUNT_NUMBER 4u
+
+// cosmos.tx.v1beta1.TxBody
+#define TX_BODY_MESSAGES 1u
+#define TX_BODY_MEMO 2u
+#define TX_BODY_TIMEOUT_HEIGHT 3u
+
+// google.protobuf.Any
+#define ANY_TYPE_URL 1u
+#define ANY_VALUE 2u
+
+// cosmos.tx.v1beta1.AuthInfo
+#define AUTH_INFO_SIGNER_INFOS 1u
+#define AUTH_INFO_FEE 2u
+
+// cosmos.tx.v1beta1.SignerInfo
+#define SIGNER_INFO_PUBLIC_KEY 1u
+#define SIGNER_INFO_MODE_INFO 2u
+#define SIGNER_INFO_SEQUENCE 3u
+
+// cosmos.tx.v1beta1.Fee
+#define FEE_AMOUNT 1u
+#define FEE_GAS_LIMIT 2u
+#define FEE_PAYER 3u
+#define FEE_GRANTER 4u
+
+// cosmos.base.v1beta1.Coin
+#define COIN_DENOM 1u
+#define COIN_AMOUNT 2u
+
+/// Indexes the SignDoc held in buffer into tx. ownAddr is the address of the
+/// signing key, which is hidden when it is the delegator of every message.
+parser_error_t tx_direct_parse(const uint8_t *buffer, size_t bufferLen,
+                               const char *ownAddr, size_t ownAddrLen,
+                               tx_direct_t *tx);
+
+/// Finds the schema of a message from the type URL of its Any
+parser_error_t tx_direct_findSchema(const uint8_t *typeUrl, size_t typeUrlLen,
+                                    uint8_t *schema);
+
+/// Checks the fields indexed in tx against the buffer they point into, and
+/// works out how they are grouped. Both tx_direct_parse and the streaming
+/// parser end with it, so they accept the same transactions.
+parser_error_t tx_direct_build(const uint8_t *buffer, size_t bufferLen,
+                               const char *ownAddr, size_t ownAddrLen,
+                               tx_direct_t *tx);
+
+/// Number of items shown for the current mode
+parser_error_t tx_direct_numItems(const tx_direct_t *tx, uint8_t *numItems);
+
+/// Renders an item, with the same paging as the other formats
+parser_error_t tx_direct_getItem(const uint8_t *buffer, const tx_direct_t *tx,
+                                 uint8_t displayIdx, char *outKey,
+                                 uint16_t outKeyLen, char *outVal,
+                                 uint16_t outValLen, uint8_t pageIdx,
+                                 uint8_t *pageCount);
+
+#ifdef __cplusplus
+}
+#endif
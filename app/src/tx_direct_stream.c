@@ -0,0 +1,452 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "tx_direct_stream.h"
+#include "tx_direct.h"
+#include <proto/proto_reader.h>
+#include <string.h>
+#include <zxmacros.h>
+
+#define STREAM_VARINT_MAX_BYTES 10u
+
+typedef enum {
+  stream_frame_sign_doc = 0,
+  stream_frame_body,
+  stream_frame_any,
+  stream_frame_auth_info,
+  stream_frame_signer_info,
+} stream_frame_e;
+
+typedef enum {
+  stream_read_tag = 0,
+  stream_read_varint,
+  stream_read_length,
+  stream_read_payload,
+} stream_state_e;
+
+typedef enum {
+  // Kept, and indexed once complete
+  stream_keep = 0,
+  // Only hashed
+  stream_skip,
+  // Read into the type URL of the Any
+  stream_type_url,
+  // An embedded message, read field by field
+  stream_descend,
+} stream_action_e;
+
+typedef struct {
+  uint8_t action;
+  proto_wire_type_e wireType;
+  bool repeated;
+  // Frame pushed by stream_descend
+  uint8_t child;
+} stream_field_t;
+
+__Z_INLINE direct_stream_frame_t *stream_top(tx_direct_stream_t *stream) {
+  return &stream->frames[stream->depth];
+}
+
+// The fields read in each message, the same that tx_direct_parse accepts
+static parser_error_t stream_field(uint8_t frame, uint32_t number,
+                                   stream_field_t *field) {
+  MEMZERO(field, sizeof(*field));
+  field->wireType = proto_wire_len;
+  switch (frame) {
+  case stream_frame_sign_doc:
+    switch (number) {
+    case SIGN_DOC_BODY_BYTES:
+      field->action = stream_descend;
+      field->child = stream_frame_body;
+      return parser_ok;
+    case SIGN_DOC_AUTH_INFO_BYTES:
+      field->action = stream_descend;
+      field->child = stream_frame_auth_info;
+      return parser_ok;
+    case SIGN_DOC_CHAIN_ID:
+      field->action = stream_keep;
+      return parser_ok;
+    case SIGN_DOC_ACCOUNT_NUMBER:
+      field->wireType = proto_wire_varint;
+      return parser_ok;
+    default:
+      break;
+    }
+    break;
+  case stream_frame_body:
+    switch (number) {
+    case TX_BODY_MESSAGES:
+      field->action = stream_descend;
+      field->child = stream_frame_any;
+      field->repeated = true;
+      return parser_ok;
+    case TX_BODY_MEMO:
+      field->action = stream_keep;
+      return parser_ok;
+    case TX_BODY_TIMEOUT_HEIGHT:
+      field->wireType = proto_wire_varint;
+      return parser_ok;
+    default:
+      // Extension options change how the transaction is processed
+      break;
+    }
+    break;
+  case stream_frame_any:
+    switch (number) {
+    case ANY_TYPE_URL:
+      field->action = stream_type_url;
+      return parser_ok;
+    case ANY_VALUE:
+      field->action = stream_keep;
+      return parser_ok;
+    default:
+      break;
+    }
+    break;
+  case stream_frame_auth_info:
+    switch (number) {
+    case AUTH_INFO_SIGNER_INFOS:
+      field->action = stream_descend;
+      field->child = stream_frame_signer_info;
+      field->repeated = true;
+      return parser_ok;
+    case AUTH_INFO_FEE:
+      field->action = stream_keep;
+      return parser_ok;
+    default:
+      // Tips are not supported
+      break;
+    }
+    break;
+  case stream_frame_signer_info:
+    switch (number) {
+    case SIGNER_INFO_PUBLIC_KEY:
+    case SIGNER_INFO_MODE_INFO:
+      field->action = stream_skip;
+      return parser_ok;
+    case SIGNER_INFO_SEQUENCE:
+      field->wireType = proto_wire_varint;
+      return parser_ok;
+    default:
+      break;
+    }
+    break;
+  default:
+    return parser_unexpected_error;
+  }
+  return parser_unexpected_field;
+}
+
+static parser_error_t stream_markSeen(direct_stream_frame_t *frame,
+                                      uint32_t number) {
+  if (number >= 32 || (frame->seen & (1u << number)) != 0) {
+    return parser_duplicated_field;
+  }
+  frame->seen |= 1u << number;
+  return parser_ok;
+}
+
+static parser_error_t stream_onTag(tx_direct_stream_t *stream) {
+  const uint64_t number = stream->varint >> 3u;
+  if (number == 0 || number > PROTO_MAX_FIELD_NUMBER) {
+    return parser_unexpected_field;
+  }
+  stream->number = (uint32_t)number;
+
+  direct_stream_frame_t *frame = stream_top(stream);
+  stream_field_t field;
+  CHECK_PARSER_ERR(stream_field(frame->kind, stream->number, &field))
+  if ((stream->varint & 0x07u) != field.wireType) {
+    return parser_proto_unexpected_wire_type;
+  }
+  if (!field.repeated) {
+    CHECK_PARSER_ERR(stream_markSeen(frame, stream->number))
+  }
+
+  if (frame->kind == stream_frame_body &&
+      stream->number == TX_BODY_MESSAGES &&
+      stream->tx->numMsgs >= DIRECT_MAX_MSGS) {
+    return parser_unexpected_number_items;
+  }
+  // The sequence shown is the one of the only signer
+  if (frame->kind == stream_frame_auth_info &&
+      stream->number == AUTH_INFO_SIGNER_INFOS && stream->signers++ > 0) {
+    return parser_unexpected_number_items;
+  }
+
+  stream->action = field.action;
+  stream->state = field.wireType == proto_wire_varint ? stream_read_varint
+                                                      : stream_read_length;
+  return parser_ok;
+}
+
+static parser_error_t stream_onVarint(tx_direct_stream_t *stream) {
+  const direct_stream_frame_t *frame = stream_top(stream);
+  if (frame->kind == stream_frame_sign_doc &&
+      stream->number == SIGN_DOC_ACCOUNT_NUMBER) {
+    stream->tx->accountNumber = stream->varint;
+  } else if (frame->kind == stream_frame_signer_info &&
+             stream->number == SIGNER_INFO_SEQUENCE) {
+    stream->tx->sequence = stream->varint;
+  }
+  stream->state = stream_read_tag;
+  return parser_ok;
+}
+
+static parser_error_t stream_onPayloadDone(tx_direct_stream_t *stream) {
+  const direct_stream_frame_t *frame = stream_top(stream);
+  stream->state = stream_read_tag;
+  if (stream->action != stream_keep) {
+    return parser_ok;
+  }
+
+  const direct_bytes_t kept = {.offset = stream->payloadStart,
+                               .len = stream->stored - stream->payloadStart};
+  switch (frame->kind) {
+  case stream_frame_sign_doc:
+    stream->tx->chainId = kept;
+    break;
+  case stream_frame_body:
+    stream->tx->memo = kept;
+    break;
+  case stream_frame_any:
+    stream->msgValue = kept;
+    break;
+  case stream_frame_auth_info:
+    stream->tx->fee = kept;
+    break;
+  default:
+    return parser_unexpected_error;
+  }
+  return parser_ok;
+}
+
+static parser_error_t stream_onLength(tx_direct_stream_t *stream) {
+  const direct_stream_frame_t *frame = stream_top(stream);
+  if (stream->varint > frame->end - stream->offset) {
+    return stream->depth == 0 ? parser_transaction_too_big
+                              : parser_proto_unexpected_EOF;
+  }
+  const uint32_t len = (uint32_t)stream->varint;
+
+  if (stream->action == stream_descend) {
+    stream_field_t field;
+    CHECK_PARSER_ERR(stream_field(frame->kind, stream->number, &field))
+    if (stream->depth >= DIRECT_STREAM_MAX_DEPTH) {
+      return parser_unexpected_error;
+    }
+    stream->depth++;
+    direct_stream_frame_t *child = stream_top(stream);
+    child->kind = field.child;
+    child->seen = 0;
+    child->end = stream->offset + len;
+    if (child->kind == stream_frame_any) {
+      stream->typeUrlLen = 0;
+      MEMZERO(&stream->msgValue, sizeof(stream->msgValue));
+    }
+    stream->state = stream_read_tag;
+    return parser_ok;
+  }
+
+  // Longer type URLs have no schema
+  if (stream->action == stream_type_url &&
+      len > DIRECT_STREAM_TYPE_URL_SIZE) {
+    return parser_unexpected_type;
+  }
+  stream->payloadLeft = len;
+  stream->payloadStart = stream->stored;
+  stream->state = stream_read_payload;
+  if (len == 0) {
+    return stream_onPayloadDone(stream);
+  }
+  return parser_ok;
+}
+
+static parser_error_t stream_onPayload(tx_direct_stream_t *stream,
+                                       const uint8_t *data, uint32_t len) {
+  switch (stream->action) {
+  case stream_keep:
+    if (stream->stored > UINT32_MAX - len ||
+        stream->append(data, len) != len) {
+      return parser_transaction_too_big;
+    }
+    stream->stored += len;
+    return parser_ok;
+  case stream_type_url:
+    MEMCPY(stream->typeUrl + stream->typeUrlLen, data, len);
+    stream->typeUrlLen += (uint8_t)len;
+    return parser_ok;
+  default:
+    return parser_ok;
+  }
+}
+
+// Closes the messages that end at the current offset
+static parser_error_t stream_pop(tx_direct_stream_t *stream) {
+  while (stream->depth > 0 && stream->state == stream_read_tag &&
+         stream->varintBytes == 0 &&
+         stream->offset == stream_top(stream)->end) {
+    const direct_stream_frame_t *frame = stream_top(stream);
+    switch (frame->kind) {
+    case stream_frame_any: {
+      const uint32_t both = (1u << ANY_TYPE_URL) | (1u << ANY_VALUE);
+      if ((frame->seen & both) != both) {
+        return parser_missing_field;
+      }
+      direct_msg_t *msg = &stream->tx->msgs[stream->tx->numMsgs];
+      CHECK_PARSER_ERR(tx_direct_findSchema(
+          stream->typeUrl, stream->typeUrlLen, &msg->schema))
+      msg->value = stream->msgValue;
+      stream->tx->numMsgs++;
+      break;
+    }
+    case stream_frame_auth_info:
+      if (stream->signers == 0 ||
+          (frame->seen & (1u << AUTH_INFO_FEE)) == 0) {
+        return parser_missing_field;
+      }
+      break;
+    default:
+      break;
+    }
+    stream->depth--;
+  }
+  return parser_ok;
+}
+
+static parser_error_t stream_readVarint(tx_direct_stream_t *stream,
+                                        uint8_t byte, bool *done) {
+  if (stream->varintBytes == 0) {
+    stream->varint = 0;
+  }
+  // The tenth byte only holds the top bit of a 64 bit value
+  if (stream->varintBytes == STREAM_VARINT_MAX_BYTES - 1 && byte > 1) {
+    return parser_value_out_of_range;
+  }
+  stream->varint |= (uint64_t)(byte & 0x7Fu) << (7u * stream->varintBytes);
+  stream->varintBytes++;
+  *done = (byte & 0x80u) == 0;
+  if (*done) {
+    stream->varintBytes = 0;
+  }
+  return parser_ok;
+}
+
+static parser_error_t stream_read(tx_direct_stream_t *stream,
+                                  const uint8_t *data, size_t dataLen) {
+  size_t pos = 0;
+  while (pos < dataLen) {
+    CHECK_PARSER_ERR(stream_pop(stream))
+
+    // Nothing may go past the end of the message being read
+    if (stream->offset == stream_top(stream)->end) {
+      return stream->depth == 0 ? parser_transaction_too_big
+                                : parser_proto_unexpected_EOF;
+    }
+
+    if (stream->state == stream_read_payload) {
+      uint32_t len = stream->payloadLeft;
+      if (dataLen - pos < len) {
+        len = (uint32_t)(dataLen - pos);
+      }
+      CHECK_PARSER_ERR(stream_onPayload(stream, data + pos, len))
+      pos += len;
+      stream->offset += len;
+      stream->payloadLeft -= len;
+      if (stream->payloadLeft == 0) {
+        CHECK_PARSER_ERR(stream_onPayloadDone(stream))
+      }
+      continue;
+    }
+
+    bool done = false;
+    CHECK_PARSER_ERR(stream_readVarint(stream, data[pos], &done))
+    pos++;
+    stream->offset++;
+    if (!done) {
+      continue;
+    }
+
+    switch (stream->state) {
+    case stream_read_tag:
+      CHECK_PARSER_ERR(stream_onTag(stream))
+      break;
+    case stream_read_varint:
+      CHECK_PARSER_ERR(stream_onVarint(stream))
+      break;
+    case stream_read_length:
+      CHECK_PARSER_ERR(stream_onLength(stream))
+      break;
+    default:
+      return parser_unexpected_error;
+    }
+  }
+  return parser_ok;
+}
+
+void tx_direct_stream_init(tx_direct_stream_t *stream, tx_direct_t *tx,
+                           direct_stream_append_t append) {
+  if (stream == NULL) {
+    return;
+  }
+  MEMZERO(stream, sizeof(*stream));
+  stream->append = append;
+  stream->tx = tx;
+  stream->error = tx == NULL || append == NULL ? parser_unexpected_value
+                                               : parser_ok;
+  stream->frames[0].kind = stream_frame_sign_doc;
+  stream->frames[0].end = UINT32_MAX;
+  stream->state = stream_read_tag;
+  if (tx != NULL) {
+    MEMZERO(tx, sizeof(*tx));
+  }
+}
+
+parser_error_t tx_direct_stream_feed(tx_direct_stream_t *stream,
+                                     const uint8_t *data, size_t dataLen) {
+  if (stream == NULL || (data == NULL && dataLen > 0)) {
+    return parser_unexpected_value;
+  }
+  if (stream->error == parser_ok) {
+    stream->error = stream_read(stream, data, dataLen);
+  }
+  return stream->error;
+}
+
+parser_error_t tx_direct_stream_finish(tx_direct_stream_t *stream) {
+  if (stream == NULL) {
+    return parser_unexpected_value;
+  }
+  if (stream->error != parser_ok) {
+    return stream->error;
+  }
+
+  stream->error = stream_pop(stream);
+  if (stream->error != parser_ok) {
+    return stream->error;
+  }
+  if (stream->depth != 0 || stream->state != stream_read_tag ||
+      stream->varintBytes != 0) {
+    stream->error = parser_proto_unexpected_EOF;
+    return stream->error;
+  }
+
+  const uint32_t both =
+      (1u << SIGN_DOC_BODY_BYTES) | (1u << SIGN_DOC_AUTH_INFO_BYTES);
+  if ((stream->frames[0].seen & both) != both) {
+    stream->error = parser_missing_field;
+  }
+  return stream->error;
+}
@@ -0,0 +1,99 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "parser_txdef.h"
+#include <common/parser_common.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Streaming parser for SIGN_MODE_DIRECT. The SignDoc is read as its chunks
+// arrive and never held whole: only the fields that are shown are kept, and
+// the transaction is indexed over them the same way tx_direct_parse indexes a
+// buffer. Fields are length prefixed, so what is kept or skipped is known as
+// soon as a tag and its length have been read.
+//
+// Kept: message values, memo, fee and chain id. Skipped: type URLs, once
+// resolved to a schema, signer public keys and mode infos, and the framing
+// of every message. The signature covers the streamed bytes, which are hashed
+// by the caller as they arrive.
+
+// TxBody or AuthInfo, then Any or SignerInfo, below the SignDoc
+#define DIRECT_STREAM_MAX_DEPTH 3u
+#define DIRECT_STREAM_TYPE_URL_SIZE 64u
+
+/// Keeps bytes of a shown field, returns how many were taken
+typedef uint32_t (*direct_stream_append_t)(const uint8_t *data, uint32_t len);
+
+typedef struct {
+  uint8_t kind;
+  uint32_t seen;
+  // Stream offset where the message ends
+  uint32_t end;
+} direct_stream_frame_t;
+
+typedef struct {
+  direct_stream_append_t append;
+  tx_direct_t *tx;
+  // First error, the rest of the stream is ignored
+  parser_error_t error;
+
+  // Bytes read and bytes kept
+  uint32_t offset;
+  uint32_t stored;
+
+  // Messages being read, frames[0] is the SignDoc
+  direct_stream_frame_t frames[DIRECT_STREAM_MAX_DEPTH + 1];
+  uint8_t depth;
+
+  // Field being read, its tag, value or length may span chunks
+  uint8_t state;
+  uint8_t varintBytes;
+  uint64_t varint;
+  uint32_t number;
+  uint8_t action;
+  uint32_t payloadLeft;
+  uint32_t payloadStart;
+
+  // Any being read
+  uint8_t typeUrl[DIRECT_STREAM_TYPE_URL_SIZE];
+  uint8_t typeUrlLen;
+  direct_bytes_t msgValue;
+
+  uint8_t signers;
+} tx_direct_stream_t;
+
+/// Starts a stream whose shown fields are indexed into tx, with offsets into
+/// the bytes given to append
+void tx_direct_stream_init(tx_direct_stream_t *stream, tx_direct_t *tx,
+                           direct_stream_append_t append);
+
+/// Reads the next chunk. Errors are kept, and returned again by later calls.
+parser_error_t tx_direct_stream_feed(tx_direct_stream_t *stream,
+                                     const uint8_t *data, size_t dataLen);
+
+/// Checks that the SignDoc is complete. The index is then finished with
+/// tx_direct_build over the kept bytes.
+parser_error_t tx_direct_stream_finish(tx_direct_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
@@ -20,8 +20,11 @@
 
 #include "tx_display.h"
 #include "app_mode.h"
+#include "bech32/bech32_codec.h"
+#include "chain_config.h"
 #include "coin.h"
 #include "parser_impl.h"
+#include "render_arena.h"
 #include "tx_parser.h"
 #include "utf8.h"
 #include <zxformat.h>
@@ -126,9 +129,10 @@ __Z_INLINE parser_error_t calculate_is_default_chainid() {
       tx_getToken(ret_value_token_index, outVal, sizeof(outVal), 0, &pageCount))
 
   zemu_log_stack(outVal);
-  zemu_log_stack(COIN_DEFAULT_CHAINID);
 
-  if (strcmp(outVal, COIN_DEFAULT_CHAINID) == 0) {
+  const chain_info_t *chain =
+      chain_config_by_chain_id(outVal, (uint8_t)strlen(outVal));
+  if (chain != NULL && chain->isDefault) {
     // If we don't match the default chainid, switch to expert mode
     display_cache.is_default_chain = true;
     zemu_log_stack("DEFAULT Chain ");
@@ -165,11 +169,56 @@ __Z_INLINE bool address_matches_own(char *addr) {
   return true;
 }
 
-parser_error_t tx_indexRootFields() {
-  if (parser_tx_obj.tx_json.flags.cache_valid) {
+// Keys whose values are shown as addresses
+static const char *const address_fields[] = {
+    "fee/granter",
+    "fee/payer",
+    "tip/tipper",
+    "msgs/inputs/address",
+    "msgs/outputs/address",
+    "msgs/value/inputs/address",
+    "msgs/value/outputs/address",
+    "msgs/value/from_address",
+    "msgs/value/to_address",
+    "msgs/value/delegator_address",
+    "msgs/value/validator_address",
+    "msgs/value/withdraw_address",
+    "msgs/value/validator_src_address",
+    "msgs/value/validator_dst_address",
+    "msgs/value/proposer",
+    "msgs/value/depositor",
+    "msgs/value/voter",
+};
+
+__Z_INLINE bool is_address_field(const char *key) {
+  for (size_t i = 0; i < array_length(address_fields); i++) {
+    if (strcmp(key, (const char *)PIC(address_fields[i])) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Checks the checksum on the raw token, so addresses longer than a page are
+// checked whole while indexing
+static parser_error_t verify_address_token(uint16_t token_index) {
+  const jsmntok_t *token = &parser_tx_obj.tx_json.json.tokens[token_index];
+  if (token->type != JSMN_STRING) {
     return parser_ok;
   }
+  if (token->start > token->end) {
+    return parser_unexpected_buffer_end;
+  }
+
+  // Optional addresses, such as the fee granter, may be empty
+  const size_t len = (size_t)(token->end - token->start);
+  if (len > 0 && !bech32_verify(parser_tx_obj.tx_json.tx + token->start, len)) {
+    return parser_invalid_address;
+  }
+  return parser_ok;
+}
 
+static parser_error_t tx_indexRootFieldsWith(render_indexing_t *scratch) {
 #ifdef APP_TESTING
   zemu_log("tx_indexRootFields");
 #endif
@@ -177,16 +226,17 @@ parser_error_t tx_indexRootFields() {
   // Clear cache
   MEMZERO(&display_cache, sizeof(display_cache_t));
 
-  char tmp_key[INDEXING_TMP_KEYSIZE];
-  char tmp_val[INDEXING_TMP_VALUESIZE];
-  MEMZERO(&tmp_key, sizeof(tmp_key));
-  MEMZERO(&tmp_val, sizeof(tmp_val));
+  // Scratch buffers are not cleared, only terminated
+  char *tmp_key = scratch->tmp_key;
+  char *tmp_val = scratch->tmp_val;
+  tmp_key[0] = 0;
+  tmp_val[0] = 0;
 
   // Grouping references
-  char reference_msg_type[INDEXING_GROUPING_REF_TYPE_SIZE];
-  char reference_msg_from[INDEXING_GROUPING_REF_FROM_SIZE];
-  MEMZERO(&reference_msg_type, sizeof(reference_msg_type));
-  MEMZERO(&reference_msg_from, sizeof(reference_msg_from));
+  char *reference_msg_type = scratch->reference_msg_type;
+  char *reference_msg_from = scratch->reference_msg_from;
+  reference_msg_type[0] = 0;
+  reference_msg_from[0] = 0;
 
   parser_tx_obj.tx_json.filter_msg_type_count = 0;
   parser_tx_obj.tx_json.filter_msg_from_count = 0;
@@ -216,10 +266,13 @@ parser_error_t tx_indexRootFields() {
     display_cache.root_item_start_token_idx[root_item_idx] =
         req_root_item_key_token_idx;
 
-    // Now count how many items can be found in this root item
+    // Now count how many items can be found in this root item, each one
+    // searched for from the message the previous one was in
     int16_t current_item_idx = 0;
+    tx_traverse_mark_t mark = {0};
     while (err == parser_ok) {
-      INIT_QUERY_CONTEXT(tmp_key, sizeof(tmp_key), tmp_val, sizeof(tmp_val), 0,
+      INIT_QUERY_CONTEXT(tmp_key, sizeof(scratch->tmp_key), tmp_val,
+                         sizeof(scratch->tmp_val), 0,
                          get_root_max_level(root_item_idx))
 
       parser_tx_obj.tx_json.query.item_index = current_item_idx;
@@ -227,8 +280,8 @@ parser_error_t tx_indexRootFields() {
                 parser_tx_obj.tx_json.query.out_key_len);
 
       uint16_t ret_value_token_index;
-      err = tx_traverse_find(
-          display_cache.root_item_start_token_idx[root_item_idx],
+      err = tx_traverse_find_from(
+          display_cache.root_item_start_token_idx[root_item_idx], &mark,
           &ret_value_token_index);
       if (err != parser_ok) {
         continue;
@@ -242,6 +295,10 @@ parser_error_t tx_indexRootFields() {
       ZEMU_LOGF(200, "[ZEMU] %s : %s", tmp_key,
                 parser_tx_obj.tx_json.query.out_val)
 
+      if (is_address_field(tmp_key)) {
+        CHECK_PARSER_ERR(verify_address_token(ret_value_token_index))
+      }
+
       switch (root_item_idx) {
       case root_item_memo: {
         if (strlen(parser_tx_obj.tx_json.query.out_val) == 0) {
@@ -262,12 +319,12 @@ parser_error_t tx_indexRootFields() {
           // First message, initialize expected type
           if (parser_tx_obj.tx_json.filter_msg_type_count == 0) {
 
-            if (strlen(tmp_val) >= sizeof(reference_msg_type)) {
+            if (strlen(tmp_val) >= sizeof(scratch->reference_msg_type)) {
               return parser_unexpected_type;
             }
 
-            snprintf(reference_msg_type, sizeof(reference_msg_type), "%s",
-                     tmp_val);
+            snprintf(reference_msg_type, sizeof(scratch->reference_msg_type),
+                     "%s", tmp_val);
             parser_tx_obj.tx_json.filter_msg_type_valid_idx = current_item_idx;
           }
 
@@ -285,8 +342,8 @@ parser_error_t tx_indexRootFields() {
             is_msg_from_field(tmp_key)) {
           // First message, initialize expected from
           if (parser_tx_obj.tx_json.filter_msg_from_count == 0) {
-            snprintf(reference_msg_from, sizeof(reference_msg_from), "%s",
-                     tmp_val);
+            snprintf(reference_msg_from, sizeof(scratch->reference_msg_from),
+                     "%s", tmp_val);
             parser_tx_obj.tx_json.filter_msg_from_valid_idx = current_item_idx;
           }
 
@@ -342,6 +399,20 @@ parser_error_t tx_indexRootFields() {
   return parser_ok;
 }
 
+parser_error_t tx_indexRootFields() {
+  if (parser_tx_obj.tx_json.flags.cache_valid) {
+    return parser_ok;
+  }
+
+  render_arena_t *arena = render_arena_acquire(render_phase_indexing);
+  if (arena == NULL) {
+    return parser_unexpected_error;
+  }
+  const parser_error_t err = tx_indexRootFieldsWith(&arena->indexing);
+  render_arena_release(render_phase_indexing);
+  return err;
+}
+
 __Z_INLINE parser_error_t is_default_chainid(bool *is_default) {
   if (is_default == NULL) {
     return parser_unexpected_value;
@@ -441,40 +512,23 @@ __Z_INLINE parser_error_t retrieve_tree_indexes(uint8_t display_index,
   }
 
   // Find root index | display_index idx -> item_index
-  // consume indexed subpages until we get the item index in the subpage
+  // skip whole root items, empty ones included, until the index falls in one
   *root_item = 0;
   *subitem_index = 0;
-  uint8_t num_items;
-
-  CHECK_PARSER_ERR(get_subitem_count(*root_item, &num_items));
-  while (num_items == 0) {
-    (*root_item)++;
-    CHECK_PARSER_ERR(get_subitem_count(*root_item, &num_items));
-  }
-
-  for (uint16_t i = 0; i < display_index; i++) {
-    (*subitem_index)++;
-    uint8_t subitem_count = 0;
-    CHECK_PARSER_ERR(get_subitem_count(*root_item, &subitem_count));
-    if (*subitem_index >= subitem_count) {
-      // Advance root index and skip empty items
-      *subitem_index = 0;
-      (*root_item)++;
-
-      uint8_t num_items_2 = 0;
-      CHECK_PARSER_ERR(get_subitem_count(*root_item, &num_items_2));
-      while (num_items_2 == 0) {
-        (*root_item)++;
-        CHECK_PARSER_ERR(get_subitem_count(*root_item, &num_items_2));
-      }
+  uint16_t left = display_index;
+
+  for (root_item_e root = 0; root < NUM_REQUIRED_ROOT_PAGES; root++) {
+    uint8_t num_items = 0;
+    CHECK_PARSER_ERR(get_subitem_count(root, &num_items));
+    if (left < num_items) {
+      *root_item = root;
+      *subitem_index = (uint8_t)left;
+      return parser_ok;
     }
+    left -= num_items;
   }
 
-  if (*root_item > NUM_REQUIRED_ROOT_PAGES) {
-    return parser_no_data;
-  }
-
-  return parser_ok;
+  return parser_no_data;
 }
 
 parser_error_t tx_display_numItems(uint8_t *num_items) {
@@ -498,29 +552,69 @@ parser_error_t tx_display_numItems(uint8_t *num_items) {
   return parser_ok;
 }
 
-// This function assumes that the tx_ctx has been set properly
-parser_error_t tx_display_query(uint16_t displayIdx, char *outKey,
-                                uint16_t outKeyLen,
-                                uint16_t *ret_value_token_index) {
-  CHECK_PARSER_ERR(tx_indexRootFields())
+parser_error_t tx_display_cursor_init(tx_display_cursor_t *cursor,
+                                      uint8_t displayIdx) {
+  if (cursor == NULL) {
+    return parser_unexpected_value;
+  }
+  MEMZERO(cursor, sizeof(*cursor));
+
+  CHECK_PARSER_ERR(tx_display_numItems(&cursor->numItems))
+  if (displayIdx >= cursor->numItems) {
+    return parser_display_idx_out_of_range;
+  }
 
-  uint8_t num_items;
-  CHECK_PARSER_ERR(tx_display_numItems(&num_items))
+  cursor->displayIdx = displayIdx;
+  CHECK_PARSER_ERR(retrieve_tree_indexes(displayIdx, &cursor->rootItem,
+                                         &cursor->subitemIndex))
+  return get_subitem_count(cursor->rootItem, &cursor->subitemCount);
+}
 
-  if (displayIdx >= num_items) {
+parser_error_t tx_display_cursor_next(tx_display_cursor_t *cursor) {
+  if (cursor == NULL) {
+    return parser_unexpected_value;
+  }
+  if (cursor->displayIdx + 1 >= cursor->numItems) {
     return parser_display_idx_out_of_range;
   }
 
-  root_item_e root_index = 0;
-  uint8_t subitem_index = 0;
-  CHECK_PARSER_ERR(
-      retrieve_tree_indexes(displayIdx, &root_index, &subitem_index))
+  cursor->displayIdx++;
+  cursor->subitemIndex++;
+  if (cursor->subitemIndex < cursor->subitemCount) {
+    return parser_ok;
+  }
+
+  // Advance root index and skip empty items
+  cursor->subitemIndex = 0;
+  cursor->mark.valid = false;
+  do {
+    cursor->rootItem++;
+    if (cursor->rootItem >= NUM_REQUIRED_ROOT_PAGES) {
+      return parser_no_data;
+    }
+    CHECK_PARSER_ERR(
+        get_subitem_count(cursor->rootItem, &cursor->subitemCount))
+  } while (cursor->subitemCount == 0);
+
+  return parser_ok;
+}
+
+// This function assumes that the tx_ctx has been set properly
+parser_error_t tx_display_cursor_query(tx_display_cursor_t *cursor,
+                                       char *outKey, uint16_t outKeyLen,
+                                       uint16_t *ret_value_token_index) {
+  if (cursor == NULL) {
+    return parser_unexpected_value;
+  }
+  CHECK_PARSER_ERR(tx_indexRootFields())
+
+  const root_item_e root_index = cursor->rootItem;
 
   // Prepare query
   static char tmp_val[2];
   INIT_QUERY_CONTEXT(outKey, outKeyLen, tmp_val, sizeof(tmp_val), 0,
                      get_root_max_level(root_index))
-  parser_tx_obj.tx_json.query.item_index = subitem_index;
+  parser_tx_obj.tx_json.query.item_index = cursor->subitemIndex;
   parser_tx_obj.tx_json.query._item_index_current = 0;
 
   strncpy_s(outKey, get_required_root_item(root_index), outKeyLen);
@@ -529,13 +623,27 @@ parser_error_t tx_display_query(uint16_t displayIdx, char *outKey,
     return parser_no_data;
   }
 
-  CHECK_PARSER_ERR(
-      tx_traverse_find(display_cache.root_item_start_token_idx[root_index],
-                       ret_value_token_index))
+  // Items of a message are found from the message the previous item was in
+  CHECK_PARSER_ERR(tx_traverse_find_from(
+      display_cache.root_item_start_token_idx[root_index], &cursor->mark,
+      ret_value_token_index))
 
   return parser_ok;
 }
 
+parser_error_t tx_display_query(uint16_t displayIdx, char *outKey,
+                                uint16_t outKeyLen,
+                                uint16_t *ret_value_token_index) {
+  if (displayIdx > UINT8_MAX) {
+    return parser_display_idx_out_of_range;
+  }
+
+  tx_display_cursor_t cursor;
+  CHECK_PARSER_ERR(tx_display_cursor_init(&cursor, (uint8_t)displayIdx))
+  return tx_display_cursor_query(&cursor, outKey, outKeyLen,
+                                 ret_value_token_index);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -631,7 +739,10 @@ parser_error_t tx_display_translation(char *dst, uint16_t dstLen, char *src,
     return parser_unexpected_value;
   }
 
-  MEMZERO(dst, dstLen);
+  // The output is terminated explicitly, no need to clear it
+  if (dstLen > 0) {
+    dst[0] = 0;
+  }
 
   if (srcLen == 0) {
     return parser_ok;
@@ -641,13 +752,18 @@ parser_error_t tx_display_translation(char *dst, uint16_t dstLen, char *src,
   uint16_t count = 0;
 
   while (p < src + srcLen) {
-    size_t remaining = (size_t)((src + srcLen) - p);
-    size_t cp_size = utf8codepointcalcsize((const utf8_int8_t *)p);
-    if (cp_size > remaining) {
-      return parser_unexpected_characters;
-    }
     utf8_int32_t tmp_codepoint = 0;
-    p = utf8codepoint(p, &tmp_codepoint);
+    if ((uint8_t)*p < 0x80) {
+      // ASCII needs no decoding
+      tmp_codepoint = (uint8_t)*p++;
+    } else {
+      size_t remaining = (size_t)((src + srcLen) - p);
+      size_t cp_size = utf8codepointcalcsize((const utf8_int8_t *)p);
+      if (cp_size > remaining) {
+        return parser_unexpected_characters;
+      }
+      p = utf8codepoint(p, &tmp_codepoint);
+    }
 
     if (tmp_codepoint < 0x0F || tmp_codepoint == 0x5C) {
       bool found = false;
@@ -717,6 +833,62 @@ parser_error_t tx_display_translation(char *dst, uint16_t dstLen, char *src,
   return parser_ok;
 }
 
+parser_error_t tx_display_translation_len(const char *src, uint16_t srcLen,
+                                          uint16_t *len) {
+  if (src == NULL || len == NULL) {
+    return parser_unexpected_value;
+  }
+
+  *len = 0;
+  if (srcLen == 0) {
+    return parser_ok;
+  }
+
+  // Same walk as tx_display_translation, counting instead of writing
+  const char *p = src;
+  uint32_t count = 0;
+  while (p < src + srcLen) {
+    utf8_int32_t tmp_codepoint = 0;
+    if ((uint8_t)*p < 0x80) {
+      // ASCII needs no decoding
+      tmp_codepoint = (uint8_t)*p++;
+    } else {
+      size_t remaining = (size_t)((src + srcLen) - p);
+      size_t cp_size = utf8codepointcalcsize((const utf8_int8_t *)p);
+      if (cp_size > remaining) {
+        return parser_unexpected_characters;
+      }
+      p = utf8codepoint(p, &tmp_codepoint);
+    }
+
+    if (tmp_codepoint < 0x0F || tmp_codepoint == 0x5C) {
+      uint8_t escapeLen = HEX_ESCAPE_LEN;
+      for (size_t i = 0; i < array_length(ascii_substitutions); i++) {
+        if ((char)tmp_codepoint == ascii_substitutions[i].ascii_code) {
+          escapeLen = 2;
+          break;
+        }
+      }
+      count += escapeLen;
+    } else if (tmp_codepoint >= 32 && tmp_codepoint <= ((int32_t)0x7F)) {
+      count++;
+    } else {
+      // Backslash, 'u' and 4 hex digits, or 'U' and 8 above the BMP
+      count += tmp_codepoint > 0xFFFF ? 10 : 6;
+    }
+  }
+
+  if (src[srcLen - 1] == ' ' || src[srcLen - 1] == '@') {
+    count++;
+  }
+
+  if (count > UINT16_MAX) {
+    return parser_transaction_too_big;
+  }
+  *len = (uint16_t)count;
+  return parser_ok;
+}
+
 #ifdef __cplusplus
 #pragma clang diagnostic pop
 #endif
@@ -19,6 +19,7 @@
 #include "coin.h"
 #include "parser_impl.h"
 #include "parser_txdef.h"
+#include "tx_parser.h"
 #include <common/parser_common.h>
 #include <stdint.h>
 
@@ -45,12 +46,37 @@ parser_error_t tx_display_query(uint16_t displayIdx, char *outKey,
                                 uint16_t outKeyLen,
                                 uint16_t *ret_value_token_index);
 
+// Position of a display item in the tree, kept between consecutive items
+typedef struct {
+  uint8_t numItems;
+  uint8_t displayIdx;
+  root_item_e rootItem;
+  uint8_t subitemIndex;
+  uint8_t subitemCount;
+  tx_traverse_mark_t mark;
+} tx_display_cursor_t;
+
+parser_error_t tx_display_cursor_init(tx_display_cursor_t *cursor,
+                                      uint8_t displayIdx);
+
+// Moves to the next display item
+parser_error_t tx_display_cursor_next(tx_display_cursor_t *cursor);
+
+// tx_display_query for the item at the cursor
+parser_error_t tx_display_cursor_query(tx_display_cursor_t *cursor,
+                                       char *outKey, uint16_t outKeyLen,
+                                       uint16_t *ret_value_token_index);
+
 parser_error_t tx_display_numItems(uint8_t *num_items);
 
 parser_error_t tx_display_make_friendly();
 
 parser_error_t tx_display_translation(char *dst, uint16_t dstLen, char *src,
                                       uint16_t srcLen);
+
+// Length tx_display_translation would write, without the terminator
+parser_error_t tx_display_translation_len(const char *src, uint16_t srcLen,
+                                          uint16_t *len);
 //---------------------------------------------
 
 #ifdef __cplusplus
@@ -84,7 +84,10 @@ parser_error_t tx_getToken(uint16_t token_index, char *out_val,
   }
 
   *pageCount = 0;
-  MEMZERO(out_val, out_val_len);
+  // pageStringExt clears the output when there is something to write
+  if (out_val_len > 0) {
+    out_val[0] = 0;
+  }
 
   const int16_t token_start =
       parser_tx_obj.tx_json.json.tokens[token_index].start;
@@ -274,6 +277,70 @@ parser_error_t tx_traverse_find(uint16_t root_token_index,
   return parser_query_no_results;
 }
 
+parser_error_t tx_traverse_find_from(uint16_t root_token_index,
+                                     tx_traverse_mark_t *mark,
+                                     uint16_t *ret_value_token_index) {
+  if (mark == NULL || ret_value_token_index == NULL) {
+    return parser_unexpected_value;
+  }
+
+  const jsmntype_t token_type =
+      parser_tx_obj.tx_json.json.tokens[root_token_index].type;
+  if (parser_tx_obj.tx_json.tx == NULL || token_type != JSMN_ARRAY ||
+      parser_tx_obj.tx_json.query.max_level <= 0 ||
+      parser_tx_obj.tx_json.query.max_depth <= 0) {
+    mark->valid = false;
+    return tx_traverse_find(root_token_index, ret_value_token_index);
+  }
+
+  // The elements before the mark only moved the counters, which are
+  // restored as they were when it was entered
+  const parsed_json_t *json = &parser_tx_obj.tx_json.json;
+  const int16_t item_index = parser_tx_obj.tx_json.query.item_index;
+  uint16_t element_index = root_token_index + 1;
+  if (mark->valid &&
+      mark->max_level == parser_tx_obj.tx_json.query.max_level) {
+    element_index = mark->element;
+    parser_tx_obj.tx_json.query._item_index_current = mark->leaves;
+    parser_tx_obj.tx_json.query.item_index += mark->skipped;
+  }
+  mark->valid = false;
+
+  // Elements are walked as siblings, rather than looked up from the start
+  // of the array each
+  const int array_end = json->tokens[root_token_index].end;
+  while (element_index < json->numberOfTokens &&
+         json->tokens[element_index].start <= array_end) {
+    const uint16_t leaves = parser_tx_obj.tx_json.query._item_index_current;
+    const int16_t skipped = parser_tx_obj.tx_json.query.item_index - item_index;
+
+    parser_tx_obj.tx_json.query.max_depth--;
+    const parser_error_t err =
+        tx_traverse_find(element_index, ret_value_token_index);
+    parser_tx_obj.tx_json.query.max_depth++;
+    CHECK_APP_CANARY()
+
+    if (err == parser_ok) {
+      mark->valid = true;
+      mark->max_level = parser_tx_obj.tx_json.query.max_level;
+      mark->element = element_index;
+      mark->leaves = leaves;
+      mark->skipped = skipped;
+      return parser_ok;
+    }
+
+    // Skip the tokens nested in the element
+    const int element_end = json->tokens[element_index].end;
+    element_index++;
+    while (element_index < json->numberOfTokens &&
+           json->tokens[element_index].start <= element_end) {
+      element_index++;
+    }
+  }
+
+  return parser_query_no_results;
+}
+
 #ifdef __cplusplus
 #pragma clang diagnostic pop
 #endif
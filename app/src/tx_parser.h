@@ -41,8 +41,9 @@ extern bool extraDepthLevel;
   parser_tx_obj.tx_json.query.item_index = 0;                                  \
   parser_tx_obj.tx_json.query.page_index = (_PAGE_IDX);                        \
                                                                                \
-  MEMZERO(_KEY, (_KEY_LEN));                                                   \
-  MEMZERO(_VAL, (_VAL_LEN));                                                   \
+  /* Results are written as terminated strings, no need to clear them */      \
+  (_KEY)[0] = 0;                                                               \
+  (_VAL)[0] = 0;                                                               \
   parser_tx_obj.tx_json.query.out_key = _KEY;                                  \
   parser_tx_obj.tx_json.query.out_val = _VAL;                                  \
   parser_tx_obj.tx_json.query.out_key_len = (_KEY_LEN);                        \
@@ -51,6 +52,26 @@ extern bool extraDepthLevel;
 parser_error_t tx_traverse_find(uint16_t root_token_index,
                                 uint16_t *ret_value_token_index);
 
+// Where in an array root the last match was found, so that a query for a
+// later item can skip the elements before it
+typedef struct {
+  bool valid;
+  // max_level the position was counted with
+  uint8_t max_level;
+  // Token of the element
+  uint16_t element;
+  // _item_index_current when the element was entered
+  uint16_t leaves;
+  // item_index increase from the fields skipped before the element
+  int16_t skipped;
+} tx_traverse_mark_t;
+
+// tx_traverse_find, resuming an array root at the element in mark. The query
+// must ask for an item at or after the one that set the mark.
+parser_error_t tx_traverse_find_from(uint16_t root_token_index,
+                                     tx_traverse_mark_t *mark,
+                                     uint16_t *ret_value_token_index);
+
 // Traverses transaction data and fills tx_context
 parser_error_t tx_traverse(int16_t root_token_index, uint8_t *numChunks);
 
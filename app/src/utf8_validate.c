@@ -0,0 +1,92 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "utf8_validate.h"
+#include <zxmacros.h>
+
+#define ASCII_WORD_MASK 0x8080808080808080ULL
+
+typedef struct {
+  uint8_t leadMin;
+  uint8_t leadMax;
+  uint8_t continuations;
+  // Range of the first continuation byte, the others are always 0x80..0xBF
+  uint8_t secondMin;
+  uint8_t secondMax;
+} utf8_range_t;
+
+// Well formed sequences, as listed in table 3-7 of the Unicode standard.
+// Lead bytes not covered here (0x80..0xC1, 0xF5..0xFF) are never valid.
+static const utf8_range_t utf8_ranges[] = {
+    {0xC2, 0xDF, 1, 0x80, 0xBF}, {0xE0, 0xE0, 2, 0xA0, 0xBF},
+    {0xE1, 0xEC, 2, 0x80, 0xBF}, {0xED, 0xED, 2, 0x80, 0x9F},
+    {0xEE, 0xEF, 2, 0x80, 0xBF}, {0xF0, 0xF0, 3, 0x90, 0xBF},
+    {0xF1, 0xF3, 3, 0x80, 0xBF}, {0xF4, 0xF4, 3, 0x80, 0x8F},
+};
+
+parser_error_t utf8_validate(const uint8_t *data, size_t dataLen,
+                             bool *isAscii) {
+  if ((data == NULL && dataLen > 0) || isAscii == NULL) {
+    return parser_unexpected_value;
+  }
+
+  *isAscii = true;
+  size_t i = 0;
+  while (i < dataLen) {
+    // ASCII runs are checked a word at a time
+    while (dataLen - i >= sizeof(uint64_t)) {
+      uint64_t word;
+      MEMCPY(&word, data + i, sizeof(word));
+      if ((word & ASCII_WORD_MASK) != 0) {
+        break;
+      }
+      i += sizeof(word);
+    }
+    if (i == dataLen) {
+      break;
+    }
+
+    const uint8_t lead = data[i];
+    if (lead < 0x80) {
+      i++;
+      continue;
+    }
+
+    *isAscii = false;
+    const utf8_range_t *range = NULL;
+    for (size_t r = 0; r < array_length(utf8_ranges); r++) {
+      if (lead >= utf8_ranges[r].leadMin && lead <= utf8_ranges[r].leadMax) {
+        range = &utf8_ranges[r];
+        break;
+      }
+    }
+    if (range == NULL || dataLen - i <= range->continuations) {
+      return parser_unexpected_characters;
+    }
+
+    const uint8_t second = data[i + 1];
+    if (second < range->secondMin || second > range->secondMax) {
+      return parser_unexpected_characters;
+    }
+    for (uint8_t k = 2; k <= range->continuations; k++) {
+      if ((data[i + k] & 0xC0) != 0x80) {
+        return parser_unexpected_characters;
+      }
+    }
+    i += 1u + range->continuations;
+  }
+
+  return parser_ok;
+}
@@ -0,0 +1,34 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <common/parser_common.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Checks that data is well formed UTF-8: no overlong forms, surrogates or
+/// code points above U+10FFFF. isAscii tells whether every byte is below 0x80.
+parser_error_t utf8_validate(const uint8_t *data, size_t dataLen,
+                             bool *isAscii);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,124 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+// Latency of the signing path on the host crypto backend: address
+// derivation, with and without the address cache, ranges of addresses and
+// signatures. The backend is not the secure element, so only relative costs
+// carry over to the device. Build with -DENABLE_BENCHMARKS=ON and run
+// bench-crypto [iterations].
+
+#include "crypto.h"
+#include "lib_standard_app/swap_lib_calls.h"
+#include "swap/swap.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+const uint32_t kPath[HDPATH_LEN_DEFAULT] = {0x8000002C, 0x80000076,
+                                            0x80000000, 0, 0};
+const uint8_t kRangeCount = 5;
+
+template <typename F> double usPerCall(size_t iterations, F call) {
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    call(i);
+  }
+  const std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / (double)iterations;
+}
+
+void report(const char *name, double us) {
+  printf("%-32s %9.1f us  %8.0f /s\n", name, us, 1e6 / us);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  const size_t iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200;
+  if (iterations == 0) {
+    fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  memcpy(hdPath, kPath, sizeof(hdPath));
+  strcpy(bech32_hrp, "cosmos");
+  bech32_hrp_len = (uint8_t)strlen(bech32_hrp);
+  encoding = BECH32_COSMOS;
+
+  uint8_t buffer[250];
+  uint16_t len = 0;
+  zxerr_t err = zxerr_ok;
+
+  report("crypto_fillAddress", usPerCall(iterations, [&](size_t i) {
+           crypto_addrCacheClear();
+           hdPath[HDPATH_INDEX_LEVEL] = (uint32_t)i;
+           err = crypto_fillAddress(buffer, sizeof(buffer), &len);
+         }));
+  report("crypto_fillAddress, cached", usPerCall(iterations, [&](size_t) {
+           err = crypto_fillAddress(buffer, sizeof(buffer), &len);
+         }));
+
+  const double range = usPerCall(iterations, [&](size_t i) {
+    crypto_addrCacheClear();
+    uint32_t path[HDPATH_LEN_DEFAULT];
+    memcpy(path, kPath, sizeof(path));
+    path[HDPATH_INDEX_LEVEL] = (uint32_t)(i * kRangeCount);
+    err = crypto_fillAddressRange(buffer, sizeof(buffer), path,
+                                  HDPATH_INDEX_LEVEL, kRangeCount, &len);
+  });
+  report("crypto_fillAddressRange, 5", range);
+  report("  per address", range / kRangeCount);
+
+  report("sign, 1 KB transaction", usPerCall(iterations, [&](size_t i) {
+           uint8_t tx[1024];
+           memset(tx, (int)i, sizeof(tx));
+           crypto_signSessionStart();
+           crypto_digestStart();
+           crypto_digestUpdate(tx, sizeof(tx));
+           crypto_digestFinish();
+           err = crypto_sign(buffer, sizeof(buffer), &len);
+         }));
+
+  // Checked against the address derived by the first benchmark
+  crypto_addrCacheClear();
+  hdPath[HDPATH_INDEX_LEVEL] = 0;
+  crypto_fillAddress(buffer, sizeof(buffer), &len);
+  char address[100] = {0};
+  memcpy(address, buffer + PK_LEN_SECP256K1, len - PK_LEN_SECP256K1);
+  uint8_t coinConfig[] = {6, 'c', 'o', 's', 'm', 'o', 's'};
+  uint8_t addressParams[1 + 4 * HDPATH_LEN_DEFAULT] = {HDPATH_LEN_DEFAULT};
+  for (uint8_t i = 0; i < HDPATH_LEN_DEFAULT; i++) {
+    for (uint8_t b = 0; b < 4; b++) {
+      addressParams[1 + 4 * i + b] = (uint8_t)(kPath[i] >> (24 - 8 * b));
+    }
+  }
+  check_address_parameters_t params = {};
+  params.coin_configuration = coinConfig;
+  params.coin_configuration_length = sizeof(coinConfig);
+  params.address_parameters = addressParams;
+  params.address_parameters_length = sizeof(addressParams);
+  params.address_to_check = address;
+  report("handle_check_address", usPerCall(iterations, [&](size_t) {
+           crypto_addrCacheClear();
+           handle_check_address(&params);
+         }));
+
+  printf("last error = %d, check = %d\n", err, params.result);
+  return err == zxerr_ok && params.result == 1 ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// Keccak-256 throughput over uncompressed public keys, the input of
+// BECH32_ETH address derivation. Build with -DENABLE_BENCHMARKS=ON and run
+// bench-keccak [iterations].
+
+#include "keccak.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+// Uncompressed public key without its 0x04 prefix
+const size_t kPubkeyLen = 64;
+
+template <typename F> double nsPerCall(size_t iterations, F call) {
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    call(i);
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / (double)iterations;
+}
+
+void report(const char *name, double ns) {
+  printf("%-28s %9.1f ns  %10.0f /s\n", name, ns, 1e9 / ns);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  const size_t iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+  if (iterations == 0) {
+    fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  // Distinct keys, so each hash depends on the previous digest
+  std::vector<uint8_t> keys(256 * kPubkeyLen);
+  for (size_t i = 0; i < keys.size(); i++) {
+    keys[i] = (uint8_t)(i * 131 + 7);
+  }
+  uint8_t digest[32] = {0};
+
+  report("keccak_hash, 64 bytes", nsPerCall(iterations, [&](size_t i) {
+           uint8_t *key = &keys[(i % 256) * kPubkeyLen];
+           key[0] ^= digest[0];
+           keccak_hash(key, kPubkeyLen, digest, sizeof(digest));
+         }));
+
+  report("update x4 + final, 64 bytes", nsPerCall(iterations, [&](size_t i) {
+           uint8_t *key = &keys[(i % 256) * kPubkeyLen];
+           key[0] ^= digest[0];
+           keccak_ctx_t ctx;
+           keccak_init(&ctx, 256);
+           for (size_t off = 0; off < kPubkeyLen; off += 16) {
+             keccak_update(&ctx, key + off, 16);
+           }
+           keccak_final(&ctx, digest, sizeof(digest));
+         }));
+
+  // Long input: one permutation per 136 byte block
+  std::vector<uint8_t> block(KECCAK256_RATE * 64, 0x5A);
+  const size_t blockIterations = iterations / 64 + 1;
+  const double ns = nsPerCall(blockIterations, [&](size_t) {
+    block[0] ^= digest[0];
+    keccak_hash(block.data(), block.size(), digest, sizeof(digest));
+  });
+  printf("%-28s %9.1f ns  %10.1f MB/s\n", "keccak_hash, 8704 bytes", ns,
+         (double)block.size() * 1e3 / ns);
+
+  printf("digest[0] = %02x\n", digest[0]);
+  return 0;
+}
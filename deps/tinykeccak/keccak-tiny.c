@@ -14,139 +14,214 @@
 #include <string.h>
 
 /******** The Keccak-f[1600] permutation ********/
-#if 1
-/*** Constants. ***/
-static const uint8_t rho[24] = \
-  { 1,  3,   6, 10, 15, 21,
-    28, 36, 45, 55,  2, 14,
-    27, 41, 56,  8, 25, 43,
-    62, 18, 39, 61, 20, 44};
-static const uint8_t pi[24] = \
-  {10,  7, 11, 17, 18, 3,
-    5, 16,  8, 21, 24, 4,
-   15, 23, 19, 13, 12, 2,
-   20, 14, 22,  9, 6,  1};
-static const uint64_t RC[24] = \
-  {1ULL, 0x8082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
-   0x808bULL, 0x80000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
-   0x8aULL, 0x88ULL, 0x80008009ULL, 0x8000000aULL,
-   0x8000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
-   0x8000000000008002ULL, 0x8000000000000080ULL, 0x800aULL, 0x800000008000000aULL,
-   0x8000000080008081ULL, 0x8000000000008080ULL, 0x80000001ULL, 0x8000000080008008ULL};
-
-/*** Helper macros to unroll the permutation. ***/
-#define rol(x, s) (((x) << s) | ((x) >> (64 - s)))
-#define REPEAT6(e) e e e e e e
-#define REPEAT24(e) REPEAT6(e e e e)
-#define REPEAT5(e) e e e e e
-
-#define FOR5(v, s, e) \
-  v = 0;            \
-  REPEAT5(e; v += s;)
-
-
-
-/*** Keccak-f[1600] ***/
-static inline void keccakf(void* state) {
-  uint64_t* a = (uint64_t*)state;
-  uint64_t b[5] = {0};
-  uint64_t t = 0;
-  uint8_t x, y;
-
-  for (int i = 0; i < 24; i++) {
-    // Theta
-    FOR5(x, 1,
-         b[x] = 0;
-         FOR5(y, 5,
-              b[x] ^= a[x + y]; ))
-    FOR5(x, 1,
-         FOR5(y, 5,
-              a[y + x] ^= b[(x + 4) % 5] ^ rol(b[(x + 1) % 5], 1); ))
-    // Rho and pi
-    t = a[1];
-    x = 0;
-    REPEAT24(b[0] = a[pi[x]];
-             a[pi[x]] = rol(t, rho[x]);
-             t = b[0];
-             x++; )
-    // Chi
-    FOR5(y,
-       5,
-       FOR5(x, 1,
-            b[x] = a[y + x];)
-       FOR5(x, 1,
-            a[y + x] = b[x] ^ ((~b[(x + 1) % 5]) & b[(x + 2) % 5]); ))
-    // Iota
-    a[0] ^= RC[i];
+static const uint64_t RC[24] = {
+    1ULL, 0x8082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x808bULL, 0x80000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x8aULL, 0x88ULL, 0x80008009ULL, 0x8000000aULL,
+    0x8000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x80000001ULL, 0x8000000080008008ULL};
+
+#define ROL64(x, s) (((x) << (s)) | ((x) >> (64 - (s))))
+
+// Lanes kept complemented during the permutation (lane complementing, from
+// the Keccak team's optimized implementation). With them inverted, chi needs
+// one NOT per plane instead of five.
+static const uint8_t complemented[6] = {1, 2, 8, 12, 17, 20};
+
+/*** One round without iota, lane x + 5y of a to e. Theta, rho and pi are
+ * fused: each output plane gathers its five lanes, already rotated, and
+ * applies chi. ***/
+static inline void keccak_round(const uint64_t *a, uint64_t *e) {
+  uint64_t b0, b1, b2, b3, b4;
+  const uint64_t c0 = a[0] ^ a[5] ^ a[10] ^ a[15] ^ a[20];
+  const uint64_t c1 = a[1] ^ a[6] ^ a[11] ^ a[16] ^ a[21];
+  const uint64_t c2 = a[2] ^ a[7] ^ a[12] ^ a[17] ^ a[22];
+  const uint64_t c3 = a[3] ^ a[8] ^ a[13] ^ a[18] ^ a[23];
+  const uint64_t c4 = a[4] ^ a[9] ^ a[14] ^ a[19] ^ a[24];
+  const uint64_t d0 = c4 ^ ROL64(c1, 1);
+  const uint64_t d1 = c0 ^ ROL64(c2, 1);
+  const uint64_t d2 = c1 ^ ROL64(c3, 1);
+  const uint64_t d3 = c2 ^ ROL64(c4, 1);
+  const uint64_t d4 = c3 ^ ROL64(c0, 1);
+
+  b0 = a[0] ^ d0;
+  b1 = ROL64(a[6] ^ d1, 44);
+  b2 = ROL64(a[12] ^ d2, 43);
+  b3 = ROL64(a[18] ^ d3, 21);
+  b4 = ROL64(a[24] ^ d4, 14);
+  e[0] = b0 ^ (b1 | b2);
+  e[1] = b1 ^ (~b2 | b3);
+  e[2] = b2 ^ (b3 & b4);
+  e[3] = b3 ^ (b4 | b0);
+  e[4] = b4 ^ (b0 & b1);
+
+  b0 = ROL64(a[3] ^ d3, 28);
+  b1 = ROL64(a[9] ^ d4, 20);
+  b2 = ROL64(a[10] ^ d0, 3);
+  b3 = ROL64(a[16] ^ d1, 45);
+  b4 = ROL64(a[22] ^ d2, 61);
+  e[5] = b0 ^ (b1 | b2);
+  e[6] = b1 ^ (b2 & b3);
+  e[7] = b2 ^ (b3 | ~b4);
+  e[8] = b3 ^ (b4 | b0);
+  e[9] = b4 ^ (b0 & b1);
+
+  b0 = ROL64(a[1] ^ d1, 1);
+  b1 = ROL64(a[7] ^ d2, 6);
+  b2 = ROL64(a[13] ^ d3, 25);
+  b3 = ROL64(a[19] ^ d4, 8);
+  b4 = ROL64(a[20] ^ d0, 18);
+  e[10] = b0 ^ (b1 | b2);
+  e[11] = b1 ^ (b2 & b3);
+  e[12] = b2 ^ (~b3 & b4);
+  e[13] = ~b3 ^ (b4 | b0);
+  e[14] = b4 ^ (b0 & b1);
+
+  b0 = ROL64(a[4] ^ d4, 27);
+  b1 = ROL64(a[5] ^ d0, 36);
+  b2 = ROL64(a[11] ^ d1, 10);
+  b3 = ROL64(a[17] ^ d2, 15);
+  b4 = ROL64(a[23] ^ d3, 56);
+  e[15] = b0 ^ (b1 & b2);
+  e[16] = b1 ^ (b2 | b3);
+  e[17] = b2 ^ (~b3 | b4);
+  e[18] = ~b3 ^ (b4 & b0);
+  e[19] = b4 ^ (b0 | b1);
+
+  b0 = ROL64(a[2] ^ d2, 62);
+  b1 = ROL64(a[8] ^ d3, 55);
+  b2 = ROL64(a[14] ^ d4, 39);
+  b3 = ROL64(a[15] ^ d0, 41);
+  b4 = ROL64(a[21] ^ d1, 2);
+  e[20] = b0 ^ (~b1 & b2);
+  e[21] = ~b1 ^ (b2 | b3);
+  e[22] = b2 ^ (b3 & b4);
+  e[23] = b3 ^ (b4 | b0);
+  e[24] = b4 ^ (b0 & b1);
+
+}
+
+/*** Keccak-f[1600], unrolled into rounds that ping-pong between two local
+ * states so the lanes stay in registers. ***/
+static void keccakf(uint64_t *state) {
+  uint64_t a[KECCAK_STATE_LANES];
+  uint64_t e[KECCAK_STATE_LANES];
+
+  memcpy(a, state, sizeof(a));
+  for (size_t i = 0; i < sizeof(complemented); i++) {
+    a[complemented[i]] = ~a[complemented[i]];
   }
+  for (size_t i = 0; i < 24; i += 2) {
+    keccak_round(a, e);
+    e[0] ^= RC[i];
+    keccak_round(e, a);
+    a[0] ^= RC[i + 1];
+  }
+  for (size_t i = 0; i < sizeof(complemented); i++) {
+    a[complemented[i]] = ~a[complemented[i]];
+  }
+  memcpy(state, a, sizeof(a));
 }
 
-/******** The FIPS202-defined functions. ********/
+/******** The sponge ********/
 
-/*** Some helper macros. ***/
+static inline uint64_t load64(const uint8_t *in) {
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; i--) {
+    v = (v << 8) | in[i];
+  }
+  return v;
+}
 
-#define _(S) do { S } while (0)
-#define FOR(i, ST, L, S) \
-  _(for (size_t i = 0; i < L; i += ST) { S; })
-#define mkapply_ds(NAME, S)                                          \
-  static inline void NAME(uint8_t* dst,                              \
-                          const uint8_t* src,                        \
-                          size_t len) {                              \
-    FOR(i, 1, len, S);                                               \
+static inline void store64(uint8_t *out, uint64_t v) {
+  for (int i = 0; i < 8; i++) {
+    out[i] = (uint8_t)(v >> (8 * i));
   }
-#define mkapply_sd(NAME, S)                                          \
-  static inline void NAME(const uint8_t* src,                        \
-                          uint8_t* dst,                              \
-                          size_t len) {                              \
-    FOR(i, 1, len, S);                                               \
+}
+
+static inline void xor_byte(keccak_ctx_t *ctx, size_t pos, uint8_t byte) {
+  ctx->state[pos / 8] ^= (uint64_t)byte << (8 * (pos % 8));
+}
+
+zxerr_t keccak_init(keccak_ctx_t *ctx, unsigned int outBits) {
+  if (ctx == NULL || (outBits != 224 && outBits != 256 && outBits != 384 &&
+                      outBits != 512)) {
+    return zxerr_invalid_crypto_settings;
   }
+  memset(ctx, 0, sizeof(*ctx));
+  ctx->rate = (uint8_t)(200 - outBits / 4);
+  return zxerr_ok;
+}
 
-mkapply_ds(xorin, dst[i] ^= src[i])  // xorin
-mkapply_sd(setout, dst[i] = src[i])  // setout
+zxerr_t keccak_update(keccak_ctx_t *ctx, const unsigned char *in,
+                      unsigned int inLen) {
+  if (ctx == NULL || ctx->rate == 0 || (in == NULL && inLen != 0)) {
+    return zxerr_invalid_crypto_settings;
+  }
 
-#define P keccakf
-#define Plen 200
+  while (inLen > 0) {
+    if (ctx->pos % 8 == 0 && inLen >= 8) {
+      // Whole lanes up to the end of the block or of the input
+      size_t lanes = (size_t)(ctx->rate - ctx->pos) / 8;
+      if (lanes > inLen / 8) {
+        lanes = inLen / 8;
+      }
+      uint64_t *lane = &ctx->state[ctx->pos / 8];
+      for (size_t i = 0; i < lanes; i++) {
+        lane[i] ^= load64(in + 8 * i);
+      }
+      in += 8 * lanes;
+      inLen -= 8 * lanes;
+      ctx->pos += 8 * lanes;
+    } else {
+      xor_byte(ctx, ctx->pos++, *in++);
+      inLen--;
+    }
 
-// Fold P*F over the full blocks of an input.
-#define foldP(I, L, F) \
-  while (L >= rate) {  \
-    F(a, I, rate);     \
-    P(a);              \
-    I += rate;         \
-    L -= rate;         \
+    if (ctx->pos == ctx->rate) {
+      keccakf(ctx->state);
+      ctx->pos = 0;
+    }
   }
+  return zxerr_ok;
+}
 
+zxerr_t keccak_final(keccak_ctx_t *ctx, unsigned char *out,
+                     unsigned int outLen) {
+  if (ctx == NULL || ctx->rate == 0 || out == NULL) {
+    return zxerr_invalid_crypto_settings;
+  }
 
+  // Original Keccak padding, not the SHA-3 domain separator
+  xor_byte(ctx, ctx->pos, 0x01);
+  xor_byte(ctx, ctx->rate - 1, 0x80);
+  keccakf(ctx->state);
 
-#endif
+  for (size_t i = 0, pos = 0; i < outLen; pos = 0) {
+    if (i > 0) {
+      keccakf(ctx->state);
+    }
+    for (; pos + 8 <= ctx->rate && outLen - i >= 8; pos += 8, i += 8) {
+      store64(out + i, ctx->state[pos / 8]);
+    }
+    for (; pos < ctx->rate && i < outLen; pos++, i++) {
+      out[i] = (uint8_t)(ctx->state[pos / 8] >> (8 * (pos % 8)));
+    }
+  }
+  memset(ctx, 0, sizeof(*ctx));
+  return zxerr_ok;
+}
 
-/** The sponge-based hash construction. **/
 zxerr_t keccak_hash(const unsigned char *in, unsigned int inLen,
                     unsigned char *out, unsigned int outLen) {
-    if ((out == NULL) || ((in == NULL) && inLen != 0)) {
-        return zxerr_invalid_crypto_settings;
-    }
+  if ((out == NULL) || ((in == NULL) && inLen != 0)) {
+    return zxerr_invalid_crypto_settings;
+  }
 
-    // Parameters are based on
-    // https://github.com/ethereum/solidity/blob/6bbedab383f7c8799ef7bcf4cad2bb008a7fcf2c/libdevcore/Keccak256.cpp
-    const size_t rate = 200 - 256/4;
-    const uint8_t delim = 0x01;
-
-    uint8_t a[Plen] = {0};
-    // Absorb input.
-    foldP(in, inLen, xorin);
-    // Xor in the DS and pad frame.
-    a[inLen] ^= delim;
-    a[rate - 1] ^= 0x80;
-    // Xor in the last block.
-    xorin(a, in, inLen);
-    // Apply P
-    P(a);
-    // Squeeze output.
-    foldP(out, outLen, setout);
-    setout(a, out, outLen);
-    memset(a, 0, 200);
-
-    return zxerr_ok;
+  keccak_ctx_t ctx;
+  keccak_init(&ctx, 256);
+  keccak_update(&ctx, in, inLen);
+  return keccak_final(&ctx, out, outLen);
 }
-
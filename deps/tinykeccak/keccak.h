@@ -13,6 +13,30 @@ extern "C" {
 // Parameters are based on
 // https://github.com/ethereum/solidity/blob/6bbedab383f7c8799ef7bcf4cad2bb008a7fcf2c/libdevcore/Keccak256.cpp
 
+#define KECCAK_STATE_LANES 25u
+// Rate of Keccak-256, the Ethereum hash
+#define KECCAK256_RATE 136u
+
+typedef struct {
+  uint64_t state[KECCAK_STATE_LANES];
+  // Bytes per block, 200 minus twice the digest size
+  uint8_t rate;
+  // Bytes absorbed into the current block
+  uint8_t pos;
+} keccak_ctx_t;
+
+/// Starts a hash with a 224, 256, 384 or 512 bit capacity half
+zxerr_t keccak_init(keccak_ctx_t *ctx, unsigned int outBits);
+
+/// Absorbs the next bytes of input
+zxerr_t keccak_update(keccak_ctx_t *ctx, const unsigned char *in,
+                      unsigned int inLen);
+
+/// Pads the input and squeezes outLen bytes, then clears the context
+zxerr_t keccak_final(keccak_ctx_t *ctx, unsigned char *out,
+                     unsigned int outLen);
+
+/// Keccak-256 of in, squeezing outLen bytes
 zxerr_t keccak_hash(const unsigned char *in, unsigned int inLen,
                     unsigned char *out, unsigned int outLen);
 
@@ -0,0 +1,60 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "../tests/textual_cbor_reference.h"
+#include "cbor/textual_cbor.h"
+#include "parser.h"
+
+#ifdef NDEBUG
+#error                                                                         \
+    "This fuzz target won't work correctly with NDEBUG defined, which will cause asserts to be eliminated"
+#endif
+
+using std::size_t;
+
+// Differential target: any input accepted by the specialized textual decoder
+// must be accepted by tinycbor and decode to the same screens
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  std::vector<screen_arg_t> screens;
+
+  textual_cbor_t decoder;
+  if (textual_cbor_init(&decoder, data, size) != parser_ok) {
+    return 0;
+  }
+  uint8_t count = 0;
+  if (textual_cbor_enter_screens(&decoder, &count) != parser_ok) {
+    return 0;
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    screen_arg_t screen;
+    if (textual_cbor_read_screen(&decoder, &screen) != parser_ok) {
+      return 0;
+    }
+    screens.push_back(screen);
+  }
+  if (textual_cbor_finish(&decoder) != parser_ok) {
+    return 0;
+  }
+
+  std::vector<screen_arg_t> expected;
+  const bool accepted = textual_reference::decode(data, size, &expected);
+  if (!accepted || expected.size() != screens.size()) {
+    (void)fprintf(stderr, "tinycbor disagrees on an accepted input\n");
+    assert(false);
+  }
+
+  for (size_t i = 0; i < screens.size(); i++) {
+    const screen_arg_t &a = screens[i];
+    const screen_arg_t &b = expected[i];
+    if (a.titlePtr != b.titlePtr || a.titleLen != b.titleLen ||
+        a.contentPtr != b.contentPtr || a.contentLen != b.contentLen ||
+        a.indent != b.indent || a.expert != b.expert) {
+      (void)fprintf(stderr, "screen %u decodes differently\n", (unsigned)i);
+      assert(false);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "keccak.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Host stand-in for the parts of the Ledger cryptography library used by the
+// app, with the same names and signatures, so crypto.c builds and runs off
+// device. None of it is constant time: it must never be linked into firmware.
+
+typedef uint32_t cx_err_t;
+
+#define CX_OK 0x00000000u
+#define CX_INTERNAL_ERROR 0xFFFFFF85u
+#define CX_INVALID_PARAMETER 0xFFFFFF84u
+
+#define CX_LAST (1u << 0)
+#define CX_RND_RFC6979 (3u << 9)
+
+#define CX_ECCINFO_PARITY_ODD 1u
+#define CX_ECCINFO_xGTn 2u
+
+#define CX_SHA256_SIZE 32u
+#define CX_SHA512_SIZE 64u
+#define CX_RIPEMD160_SIZE 20u
+
+typedef enum {
+  CX_CURVE_256K1 = 0x21,
+} cx_curve_t;
+
+typedef enum {
+  CX_NONE = 0,
+  CX_RIPEMD160 = 1,
+  CX_SHA256 = 3,
+  CX_SHA512 = 5,
+  CX_KECCAK = 6,
+} cx_md_t;
+
+/// First member of every hash context, telling cx_hash_no_throw which one it
+/// is given
+typedef struct {
+  cx_md_t algo;
+} cx_hash_t;
+
+typedef struct {
+  cx_hash_t header;
+  uint64_t length;
+  uint32_t state[8];
+  uint8_t block[64];
+} cx_sha256_t;
+
+typedef struct {
+  cx_hash_t header;
+  uint64_t length;
+  uint64_t state[8];
+  uint8_t block[128];
+} cx_sha512_t;
+
+typedef struct {
+  cx_hash_t header;
+  keccak_ctx_t ctx;
+} cx_sha3_t;
+
+typedef struct {
+  cx_curve_t curve;
+  size_t d_len;
+  uint8_t d[32];
+} cx_ecfp_private_key_t;
+
+typedef struct {
+  cx_curve_t curve;
+  size_t W_len;
+  uint8_t W[65];
+} cx_ecfp_public_key_t;
+
+// Hashes
+
+cx_err_t cx_sha256_init_no_throw(cx_sha256_t *hash);
+cx_err_t cx_sha512_init_no_throw(cx_sha512_t *hash);
+cx_err_t cx_keccak_init_no_throw(cx_sha3_t *hash, size_t size);
+
+/// Hashes len bytes of in, then writes the digest to out when mode has
+/// CX_LAST
+cx_err_t cx_hash_no_throw(cx_hash_t *hash, uint32_t mode, const uint8_t *in,
+                          size_t len, uint8_t *out, size_t out_len);
+
+size_t cx_hash_sha256(const uint8_t *in, size_t len, uint8_t *out,
+                      size_t out_len);
+cx_err_t cx_ripemd160_hash(const uint8_t *in, size_t len, uint8_t *out);
+cx_err_t cx_keccak_256_hash(const uint8_t *in, size_t len, uint8_t *out);
+
+/// HMACs, returning the size of the MAC or 0
+size_t cx_hmac_sha256(const uint8_t *key, size_t key_len, const uint8_t *in,
+                      size_t len, uint8_t *mac, size_t mac_len);
+size_t cx_hmac_sha512(const uint8_t *key, size_t key_len, const uint8_t *in,
+                      size_t len, uint8_t *mac, size_t mac_len);
+
+// Big endian arithmetic over len bytes
+
+cx_err_t cx_math_cmp_no_throw(const uint8_t *a, const uint8_t *b, size_t len,
+                              int *diff);
+cx_err_t cx_math_is_zero_no_throw(const uint8_t *a, size_t len, bool *zero);
+/// r = a + b mod m, with a and b below m
+cx_err_t cx_math_addm_no_throw(uint8_t *r, const uint8_t *a, const uint8_t *b,
+                               const uint8_t *m, size_t len);
+
+// secp256k1
+
+cx_err_t cx_ecfp_init_private_key_no_throw(cx_curve_t curve,
+                                           const uint8_t *raw_key,
+                                           size_t key_len,
+                                           cx_ecfp_private_key_t *pvkey);
+cx_err_t cx_ecfp_init_public_key_no_throw(cx_curve_t curve,
+                                          const uint8_t *raw_key,
+                                          size_t key_len,
+                                          cx_ecfp_public_key_t *key);
+/// Computes the uncompressed public key of the private key
+cx_err_t cx_ecfp_generate_pair_no_throw(cx_curve_t curve,
+                                        cx_ecfp_public_key_t *pubkey,
+                                        cx_ecfp_private_key_t *privkey,
+                                        bool keepprivate);
+
+/// Signs a digest with a deterministic nonce, writing a DER signature with a
+/// low S. info gets the parity of R.
+cx_err_t cx_ecdsa_sign_no_throw(const cx_ecfp_private_key_t *pvkey,
+                                uint32_t mode, cx_md_t hashID,
+                                const uint8_t *hash, size_t hash_len,
+                                uint8_t *sig, size_t *sig_len, uint32_t *info);
+
+/// Checks a DER signature of a digest
+bool cx_ecdsa_verify_no_throw(const cx_ecfp_public_key_t *pukey,
+                              const uint8_t *hash, size_t hash_len,
+                              const uint8_t *sig, size_t sig_len);
+
+#ifdef __cplusplus
+}
+#endif
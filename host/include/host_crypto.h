@@ -0,0 +1,42 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HOST_SEED_LEN 64u
+
+/// Mnemonic of the Zemu simulator, so keys and addresses match its snapshots
+#define HOST_TEST_MNEMONIC                                                     \
+  "equip will roof matter pink blind book anxiety banner elbow sun young"
+
+/// BIP39 seed of a mnemonic and passphrase
+void host_crypto_mnemonic_to_seed(const char *mnemonic,
+                                  const char *passphrase,
+                                  uint8_t seed[HOST_SEED_LEN]);
+
+/// Sets the seed keys are derived from. Until then, it is the seed of
+/// HOST_TEST_MNEMONIC without a passphrase.
+void host_crypto_set_seed(const uint8_t *seed, size_t seedLen);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,55 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Host stand-in for the parameters the exchange app passes to the swap
+// handlers, with the fields of the standard app library
+
+#define MAX_PRINTABLE_AMOUNT_SIZE 50
+
+typedef struct {
+  uint8_t *coin_configuration;
+  uint8_t coin_configuration_length;
+  uint8_t *address_parameters;
+  uint8_t address_parameters_length;
+  char *address_to_check;
+  char *extra_id_to_check;
+  int result;
+} check_address_parameters_t;
+
+typedef struct {
+  uint8_t *coin_configuration;
+  uint8_t coin_configuration_length;
+  uint8_t *amount;
+  uint8_t amount_length;
+  bool is_fee;
+  char printable_amount[MAX_PRINTABLE_AMOUNT_SIZE];
+} get_printable_amount_parameters_t;
+
+typedef struct {
+  uint8_t *coin_configuration;
+  uint8_t coin_configuration_length;
+  uint8_t *amount;
+  uint8_t amount_length;
+  uint8_t *fee_amount;
+  uint8_t fee_amount_length;
+  char *destination_address;
+  char *destination_address_extra_id;
+  uint8_t result;
+} create_transaction_parameters_t;
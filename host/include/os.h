@@ -0,0 +1,125 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "cx.h"
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Host stand-in for the operating system calls used by the app. Keys are
+// derived from a seed set with host_crypto_set_seed, see host_crypto.h.
+
+#define HDW_NORMAL 0u
+
+// Reported by INS_GET_VERSION, the host runs with the sizes of a Nano S Plus
+#define TARGET_ID 0x33100004u
+
+#define BOLOS_TRUE 0xAAu
+#define BOLOS_FALSE 0x55u
+#define BOLOS_UX_OK 0xAAu
+
+typedef uint8_t bolos_bool_t;
+
+/// BOLOS_TRUE unless the device was locked with host_os_set_locked
+bolos_bool_t os_global_pin_is_validated(void);
+
+/// Locks or unlocks the device. The app notices on its next APDU or ticker
+/// event.
+void host_os_set_locked(bool locked);
+
+// Exceptions, as setjmp contexts chained the way the SDK does
+
+#define EXCEPTION_IO_RESET 0x10u
+
+typedef unsigned short exception_t;
+
+typedef struct try_context_s try_context_t;
+struct try_context_s {
+  jmp_buf jmp_buf;
+  try_context_t *previous;
+  exception_t ex;
+};
+
+try_context_t *try_context_get(void);
+try_context_t *try_context_set(try_context_t *context);
+
+/// Jumps to the innermost TRY, or aborts outside of any
+void __attribute__((noreturn)) os_longjmp(unsigned int exception);
+
+#define BEGIN_TRY                                                              \
+  {                                                                            \
+    try_context_t __try_context;
+
+#define TRY                                                                    \
+  __try_context.ex = 0;                                                        \
+  __try_context.previous = try_context_set(&__try_context);                    \
+  if ((__try_context.ex = (exception_t)setjmp(__try_context.jmp_buf)) == 0) {
+
+#define CATCH(x)                                                               \
+  goto __FINALLY;                                                              \
+  }                                                                            \
+  else if (__try_context.ex == (x)) {                                          \
+    __try_context.ex = 0;                                                      \
+    try_context_set(__try_context.previous);
+
+#define CATCH_OTHER(e)                                                         \
+  goto __FINALLY;                                                              \
+  }                                                                            \
+  else {                                                                       \
+    exception_t e = __try_context.ex;                                          \
+    __try_context.ex = 0;                                                      \
+    try_context_set(__try_context.previous);
+
+#define FINALLY                                                                \
+  goto __FINALLY;                                                              \
+  }                                                                            \
+  __FINALLY:                                                                   \
+  if (try_context_get() == &__try_context) {                                   \
+    try_context_set(__try_context.previous);                                   \
+  }
+
+#define END_TRY                                                                \
+  if (__try_context.ex != 0) {                                                 \
+    os_longjmp(__try_context.ex);                                              \
+  }                                                                            \
+  }
+
+#define THROW(x) os_longjmp(x)
+
+#define IO_APDU_BUFFER_SIZE (5u + 255u)
+
+extern uint8_t G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+
+/// Derives the private key of a BIP32 path, from seed or else from the host
+/// seed. raw_privkey gets the key in its first 32 bytes.
+cx_err_t os_derive_bip32_with_seed_no_throw(unsigned int derivation_mode,
+                                            cx_curve_t curve,
+                                            const uint32_t *path,
+                                            size_t path_len,
+                                            uint8_t raw_privkey[64],
+                                            uint8_t *chain_code,
+                                            unsigned char *seed,
+                                            size_t seed_len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,41 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "os.h"
+#include <stdint.h>
+
+// Host stand-in for the APDU transport. io_exchange is defined by the
+// program driving the app, see host/sim.
+
+#define CHANNEL_APDU 0x00u
+#define IO_ASYNCH_REPLY 0x10u
+#define IO_RETURN_AFTER_TX 0x20u
+
+/// Sends tx_len bytes of G_io_apdu_buffer as the reply to the pending APDU
+unsigned short io_exchange(unsigned char channel_and_flags,
+                           unsigned short tx_len);
+
+/// Defined by the app, called on every ticker event, lock screen included
+void app_ticker_event_callback(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,150 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "apdu_session.h"
+#include "app_mode.h"
+#include "sim_device.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+bool parseHex(const std::string &hex, bytes_t *out) {
+  if (hex.size() % 2 != 0) {
+    return false;
+  }
+  out->clear();
+  for (size_t i = 0; i < hex.size(); i += 2) {
+    if (!isxdigit((unsigned char)hex[i]) ||
+        !isxdigit((unsigned char)hex[i + 1])) {
+      return false;
+    }
+    out->push_back((uint8_t)strtol(hex.substr(i, 2).c_str(), nullptr, 16));
+  }
+  return true;
+}
+
+std::string toHex(const bytes_t &data) {
+  std::string out;
+  char byte[3];
+  for (uint8_t b : data) {
+    snprintf(byte, sizeof(byte), "%02x", b);
+    out += byte;
+  }
+  return out;
+}
+
+namespace {
+std::string stripSpaces(const std::string &s) {
+  std::string out;
+  for (char c : s) {
+    if (!isspace((unsigned char)c)) {
+      out += c;
+    }
+  }
+  return out;
+}
+
+bool readStep(const std::string &line, std::vector<ApduStep> *steps,
+              std::string *source) {
+  if (line.compare(0, 2, "=>") == 0) {
+    ApduStep step = {false, false, bytes_t(), bytes_t()};
+    if (!parseHex(stripSpaces(line.substr(2)), &step.apdu)) {
+      return false;
+    }
+    steps->push_back(step);
+    return true;
+  }
+  if (line.compare(0, 2, "<=") == 0) {
+    return !steps->empty() &&
+           parseHex(stripSpaces(line.substr(2)), &steps->back().reply);
+  }
+  if (line.empty() || line[0] != '{') {
+    // Comments and other output in logs
+    return true;
+  }
+
+  const nlohmann::json obj = nlohmann::json::parse(line, nullptr, false);
+  if (obj.is_discarded()) {
+    return false;
+  }
+  if (obj.contains("source")) {
+    if (!steps->empty() || !source->empty() || !obj["source"].is_string()) {
+      return false;
+    }
+    *source = obj["source"].get<std::string>();
+    return true;
+  }
+
+  ApduStep step = {false, false, bytes_t(), bytes_t()};
+  if (obj.contains("expert")) {
+    step.setsExpert = true;
+    step.expert = obj["expert"].get<bool>();
+  } else if (!obj.contains("apdu") ||
+             !parseHex(obj["apdu"].get<std::string>(), &step.apdu) ||
+             (obj.contains("reply") &&
+              !parseHex(obj["reply"].get<std::string>(), &step.reply))) {
+    return false;
+  }
+  steps->push_back(step);
+  return true;
+}
+} // namespace
+
+bool loadSession(const std::string &file, std::vector<ApduStep> *steps,
+                 std::string *source, std::string *error) {
+  std::ifstream in(file);
+  if (!in.is_open()) {
+    *error = "cannot open " + file;
+    return false;
+  }
+
+  steps->clear();
+  source->clear();
+  std::string line;
+  size_t lineNumber = 0;
+  while (std::getline(in, line)) {
+    lineNumber++;
+    if (!readStep(line, steps, source)) {
+      *error = file + ":" + std::to_string(lineNumber) + ": " + line;
+      return false;
+    }
+  }
+  return true;
+}
+
+void replaySession(const std::vector<ApduStep> &steps, ReplayResult *result) {
+  sim_reset();
+  stage_reset();
+  result->replies.clear();
+
+  const uint64_t start = stage_now();
+  for (const auto &step : steps) {
+    if (step.setsExpert) {
+      app_mode_set_expert(step.expert);
+      continue;
+    }
+    uint8_t reply[SIM_REPLY_SIZE];
+    uint16_t replyLen = 0;
+    sim_exchange(step.apdu.data(), (uint16_t)step.apdu.size(), reply,
+                 &replyLen);
+    result->replies.push_back(bytes_t(reply, reply + replyLen));
+  }
+  result->totalNs = stage_now() - start;
+  result->stages = *stage_totals();
+}
@@ -0,0 +1,58 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#include "stage_timer.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// APDU sessions under tests/apdu_sessions. The first line tells where the
+// replies come from, and so does the prefix of the file name: zemu_*.jsonl
+// holds {"source": "zemu"}, saved from the Zemu suites by
+// tests_zemu/tests/recorder.ts, and host_*.jsonl holds {"source": "host"},
+// fixtures whose replies were produced by the host build. Each other line is an
+// exchange, {"apdu": "<hex>", "reply": "<hex>"}, or a change of expert mode,
+// {"expert": true}. Logs with "=> <hex>" and "<= <hex>" lines are read too,
+// and have no source.
+
+typedef std::vector<uint8_t> bytes_t;
+
+struct ApduStep {
+  bool setsExpert;
+  bool expert;
+  bytes_t apdu;
+  // Empty when the reply was not saved
+  bytes_t reply;
+};
+
+struct ReplayResult {
+  // One per exchange, in order
+  std::vector<bytes_t> replies;
+  stage_totals_t stages;
+  uint64_t totalNs;
+};
+
+bool parseHex(const std::string &hex, bytes_t *out);
+std::string toHex(const bytes_t &data);
+
+/// Reads a session and its source, empty if it has none. On failure, error
+/// tells the line that could not be read.
+bool loadSession(const std::string &file, std::vector<ApduStep> *steps,
+                 std::string *source, std::string *error);
+
+/// Replays a session on an app in the state it starts in
+void replaySession(const std::vector<ApduStep> &steps, ReplayResult *result);
@@ -0,0 +1,342 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// Drives handleApdu end to end on the host, with the host crypto backend, an
+// in-memory NVM and a headless view that approves every review. Reports where
+// the time goes between the first APDU of a request and its reply, for the
+// corpus transactions in order of size, or for a recorded session.
+//
+//   apdu-sim [--repeat N] [--value-line N] [--items-per-page N] [-v]
+//   apdu-sim --replay FILE
+//
+// FILE is a session of tests/apdu_sessions, or a log with "=> <hex>" lines,
+// see apdu_session.h. Replies that differ from the saved ones are reported.
+// --items-per-page renders reviews as Stax and Flex do, several items to a
+// screen.
+
+#include "apdu_session.h"
+#include "app_main.h"
+#include "app_mode.h"
+#include "coin.h"
+#include "sim_device.h"
+#include "stage_timer.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+const uint32_t kPath[HDPATH_LEN_DEFAULT] = {0x8000002C, 0x80000076,
+                                            0x80000000, 0, 0};
+const char kHrp[] = "cosmos";
+const size_t kChunkSize = 250;
+
+struct Transaction {
+  std::string name;
+  tx_type_e type;
+  bytes_t data;
+  bool expert;
+};
+
+struct Options {
+  int repeat = 5;
+  uint16_t valueLine = 40;
+  uint8_t itemsPerPage = 1;
+  bool verbose = false;
+  std::string replay;
+};
+
+bool readJson(const std::string &file, nlohmann::json *obj) {
+  std::ifstream in(std::string(TESTVECTORS_DIR) + file);
+  if (!in.is_open()) {
+    return false;
+  }
+  in >> *obj;
+  return true;
+}
+
+// Serialized the way tests/testcases.cpp does, which is what the vectors
+// were checked with
+void addAminoVectors(std::vector<Transaction> *corpus) {
+  nlohmann::json obj;
+  if (!readJson("testcases/manual.json", &obj)) {
+    return;
+  }
+  for (const auto &v : obj) {
+    if (v["parsingErr"] != "No error" || v["validationErr"] != "No error") {
+      continue;
+    }
+    const std::string tx =
+        v["tx"].dump(-1, ' ', true, nlohmann::json::error_handler_t::replace);
+    const bool expert = v.contains("expert") && v["expert"].get<bool>();
+    corpus->push_back(Transaction{v["name"].get<std::string>(), tx_json,
+                                  bytes_t(tx.begin(), tx.end()), expert});
+  }
+}
+
+void addTextualVectors(std::vector<Transaction> *corpus) {
+  nlohmann::json obj;
+  if (!readJson("testcases/textual.json", &obj)) {
+    return;
+  }
+  for (const auto &v : obj) {
+    Transaction tx{v["name"].get<std::string>(), tx_textual, bytes_t(), false};
+    if (parseHex(v["blob"].get<std::string>(), &tx.data)) {
+      corpus->push_back(tx);
+    }
+  }
+}
+
+// Batches of reward withdrawals, growing up to the size of the flash buffer
+void addMultiMessageTxs(std::vector<Transaction> *corpus) {
+  const char *validators[] = {
+      "cosmosvaloper1qwl879nx9t6kef4supyazayf7vjhennyh568ys",
+      "cosmosvaloper1x88j7vp2xnw3zec8ur3g4waxycyz7m0mahdv3p",
+      "cosmosvaloper1grgelyng2v6v3t8z87wu3sxgt9m5s03xfytvz7",
+      "cosmosvaloper1sjllsnramtg3ewxqwwrwjxfgc4n4ef9u2lcnj0",
+  };
+  for (size_t numMsgs : {1u, 5u, 10u, 20u, 40u}) {
+    std::string tx = "{\"account_number\":\"108\",\"chain_id\":"
+                     "\"cosmoshub-4\",\"fee\":{\"amount\":[{\"amount\":"
+                     "\"600\",\"denom\":\"uatom\"}],\"gas\":\"200000\"},"
+                     "\"memo\":\"\",\"msgs\":[";
+    for (size_t i = 0; i < numMsgs; i++) {
+      tx += i == 0 ? "" : ",";
+      tx += "{\"type\":\"cosmos-sdk/MsgWithdrawDelegationReward\",\"value\":{"
+            "\"delegator_address\":\""
+            "cosmos14lultfckehtszvzw4ehu0apvsr77afvyhgqhwh\","
+            "\"validator_address\":\"";
+      tx += validators[i % 4];
+      tx += "\"}}";
+    }
+    tx += "],\"sequence\":\"106\"}";
+    corpus->push_back(Transaction{"withdraw x" + std::to_string(numMsgs),
+                                  tx_json, bytes_t(tx.begin(), tx.end()),
+                                  false});
+  }
+}
+
+// As sent by the JS client: the path and HRP first, then the transaction in
+// chunks of 250 bytes
+std::vector<bytes_t> signApdus(const Transaction &tx) {
+  std::vector<bytes_t> apdus;
+  bytes_t init = {CLA, INS_SIGN_SECP256K1, P1_INIT, (uint8_t)tx.type, 0};
+  for (uint32_t level : kPath) {
+    for (int shift = 0; shift < 32; shift += 8) {
+      init.push_back((uint8_t)(level >> shift));
+    }
+  }
+  init.push_back((uint8_t)strlen(kHrp));
+  init.insert(init.end(), kHrp, kHrp + strlen(kHrp));
+  init[OFFSET_DATA_LEN] = (uint8_t)(init.size() - OFFSET_DATA);
+  apdus.push_back(init);
+
+  for (size_t offset = 0; offset < tx.data.size(); offset += kChunkSize) {
+    const size_t len = std::min(kChunkSize, tx.data.size() - offset);
+    const bool last = offset + len == tx.data.size();
+    bytes_t chunk = {CLA, INS_SIGN_SECP256K1,
+                     (uint8_t)(last ? P1_LAST : P1_ADD), (uint8_t)tx.type,
+                     (uint8_t)len};
+    chunk.insert(chunk.end(), tx.data.begin() + offset,
+                 tx.data.begin() + offset + len);
+    apdus.push_back(chunk);
+  }
+  return apdus;
+}
+
+// Sends the APDUs in order, stopping at the first error. Returns the status
+// word of the last reply.
+uint16_t sendAll(const std::vector<bytes_t> &apdus, std::string *error) {
+  uint8_t reply[SIM_REPLY_SIZE];
+  uint16_t sw = 0;
+  for (const auto &apdu : apdus) {
+    uint16_t replyLen = 0;
+    const zxerr_t err =
+        sim_exchange(apdu.data(), (uint16_t)apdu.size(), reply, &replyLen);
+    if (replyLen < 2) {
+      *error = "no reply";
+      return 0;
+    }
+    sw = (uint16_t)((reply[replyLen - 2] << 8) | reply[replyLen - 1]);
+    if (err != zxerr_ok) {
+      *error = "screen could not be rendered";
+      return sw;
+    }
+    if (sw != APDU_CODE_OK) {
+      // The handler replies with the parser error ahead of the status
+      error->assign((const char *)reply, replyLen - 2);
+      return sw;
+    }
+  }
+  return sw;
+}
+
+void printHeader() {
+  printf("%-28s %6s %5s %7s", "transaction", "bytes", "apdus", "screens");
+  for (int s = 0; s < STAGE_COUNT; s++) {
+    printf(" %8s", stage_name((stage_e)s));
+  }
+  printf(" %9s\n", "total us");
+}
+
+void printStages(const uint64_t *ns, uint64_t totalNs, int runs) {
+  for (int s = 0; s < STAGE_COUNT; s++) {
+    printf(" %8.1f", (double)ns[s] / runs / 1000.0);
+  }
+  printf(" %9.1f\n", (double)totalNs / runs / 1000.0);
+}
+
+void printScreens() {
+  uint16_t numScreens = 0;
+  const sim_screen_t *screens = sim_screens(&numScreens);
+  for (uint16_t i = 0; i < numScreens && i < SIM_MAX_SCREENS; i++) {
+    if (screens[i].numItems > 1) {
+      printf("    items %3u-%-3u    %8.1f us\n", screens[i].item,
+             screens[i].item + screens[i].numItems - 1,
+             (double)screens[i].ns / 1000.0);
+      continue;
+    }
+    printf("    item %3u page %u/%u %8.1f us\n", screens[i].item,
+           screens[i].page + 1, screens[i].pageCount,
+           (double)screens[i].ns / 1000.0);
+  }
+}
+
+int runCorpus(const Options &options) {
+  std::vector<Transaction> corpus;
+  addAminoVectors(&corpus);
+  addTextualVectors(&corpus);
+  addMultiMessageTxs(&corpus);
+  std::stable_sort(corpus.begin(), corpus.end(),
+                   [](const Transaction &a, const Transaction &b) {
+                     return a.data.size() < b.data.size();
+                   });
+
+  printHeader();
+  int failures = 0;
+  for (const auto &tx : corpus) {
+    const std::vector<bytes_t> apdus = signApdus(tx);
+    app_mode_set_expert(tx.expert);
+
+    uint64_t ns[STAGE_COUNT] = {0};
+    uint64_t totalNs = 0;
+    uint16_t sw = 0;
+    std::string error;
+    for (int run = 0; run < options.repeat; run++) {
+      stage_reset();
+      const uint64_t start = stage_now();
+      sw = sendAll(apdus, &error);
+      totalNs += stage_now() - start;
+      for (int s = 0; s < STAGE_COUNT; s++) {
+        ns[s] += stage_totals()->ns[s];
+      }
+      if (sw != APDU_CODE_OK) {
+        break;
+      }
+    }
+
+    uint16_t numScreens = 0;
+    sim_screens(&numScreens);
+    printf("%-28.28s %6zu %5zu %7u", tx.name.c_str(), tx.data.size(),
+           apdus.size(), numScreens);
+    if (sw != APDU_CODE_OK) {
+      printf(" error %04x %s\n", sw, error.c_str());
+      failures++;
+      continue;
+    }
+    printStages(ns, totalNs, options.repeat);
+    if (options.verbose) {
+      printScreens();
+    }
+  }
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int runReplay(const Options &options) {
+  std::vector<ApduStep> steps;
+  std::string source;
+  std::string error;
+  if (!loadSession(options.replay, &steps, &source, &error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return EXIT_FAILURE;
+  }
+  if (!source.empty()) {
+    printf("replies from %s\n", source.c_str());
+  }
+
+  ReplayResult result;
+  replaySession(steps, &result);
+
+  size_t exchange = 0;
+  size_t mismatches = 0;
+  for (const auto &step : steps) {
+    if (step.setsExpert) {
+      printf("expert mode %s\n", step.expert ? "on" : "off");
+      continue;
+    }
+    const bytes_t &reply = result.replies[exchange++];
+    printf("=> %s\n<= %s\n", toHex(step.apdu).c_str(), toHex(reply).c_str());
+    if (!step.reply.empty() && step.reply != reply) {
+      printf("!= %s\n", toHex(step.reply).c_str());
+      mismatches++;
+    }
+  }
+
+  printf("\n%zu APDUs, %zu replies differ\n", exchange, mismatches);
+  for (int s = 0; s < STAGE_COUNT; s++) {
+    printf("%-10s %10.1f us %6u calls\n", stage_name((stage_e)s),
+           (double)result.stages.ns[s] / 1000.0, result.stages.calls[s]);
+  }
+  printf("%-10s %10.1f us\n", "total", (double)result.totalNs / 1000.0);
+  return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "-v") {
+      options.verbose = true;
+    } else if (arg == "--repeat" && i + 1 < argc) {
+      options.repeat = std::max(1, atoi(argv[++i]));
+    } else if (arg == "--value-line" && i + 1 < argc) {
+      options.valueLine = (uint16_t)std::max(2, atoi(argv[++i]));
+    } else if (arg == "--items-per-page" && i + 1 < argc) {
+      options.itemsPerPage = (uint8_t)std::min<int>(
+          SIM_MAX_ITEMS_PER_PAGE, std::max(1, atoi(argv[++i])));
+    } else if (arg == "--replay" && i + 1 < argc) {
+      options.replay = argv[++i];
+    } else {
+      fprintf(stderr,
+              "usage: %s [--repeat N] [--value-line N] "
+              "[--items-per-page N] [-v] [--replay FILE]\n",
+              argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  sim_set_line_sizes(40, options.valueLine);
+  sim_set_items_per_page(options.itemsPerPage);
+  return options.replay.empty() ? runCorpus(options) : runReplay(options);
+}
@@ -0,0 +1,232 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "sim_device.h"
+#include "actions.h"
+#include "app_main.h"
+#include "app_mode.h"
+#include "crypto.h"
+#include "stage_timer.h"
+#include "tx.h"
+#include "view.h"
+#include <os.h>
+#include <os_io_seproxyhal.h>
+#include <string.h>
+
+#define SIM_LINE_SIZE_MAX 4096u
+
+static uint16_t keyLineSize = 40;
+static uint16_t valueLineSize = 40;
+static char keyLine[SIM_LINE_SIZE_MAX];
+static char valueLine[SIM_LINE_SIZE_MAX];
+
+// Lines of a screen that shows several items
+static uint8_t itemsPerPage = 1;
+static char keyLines[SIM_MAX_ITEMS_PER_PAGE][SIM_LINE_SIZE_MAX];
+static char valueLines[SIM_MAX_ITEMS_PER_PAGE][SIM_LINE_SIZE_MAX];
+
+static viewfunc_getItem_t review_getItem = NULL;
+static viewfunc_getNumItems_t review_getNumItems = NULL;
+static viewfunc_accept_t review_accept = NULL;
+static bool review_pending = false;
+
+static sim_screen_t screens[SIM_MAX_SCREENS];
+static uint16_t numScreens = 0;
+
+// Reply sent with io_exchange, by a review once approved
+static uint8_t asyncReply[IO_APDU_BUFFER_SIZE];
+static uint16_t asyncReplyLen = 0;
+
+unsigned short io_exchange(unsigned char channel_and_flags,
+                           unsigned short tx_len) {
+  (void)channel_and_flags;
+  if (tx_len > sizeof(asyncReply)) {
+    tx_len = sizeof(asyncReply);
+  }
+  memcpy(asyncReply, G_io_apdu_buffer, tx_len);
+  asyncReplyLen = tx_len;
+  return 0;
+}
+
+void view_review_init(viewfunc_getItem_t viewfuncGetItem,
+                      viewfunc_getNumItems_t viewfuncGetNumItems,
+                      viewfunc_accept_t viewfuncAccept) {
+  review_getItem = viewfuncGetItem;
+  review_getNumItems = viewfuncGetNumItems;
+  review_accept = viewfuncAccept;
+}
+
+void view_review_show(review_type_e reviewKind) {
+  (void)reviewKind;
+  review_pending = true;
+}
+
+void view_custom_error_show(const char *upper, const char *lower) {
+  (void)upper;
+  (void)lower;
+}
+
+void sim_reset(void) {
+  host_os_set_locked(false);
+  g_tx_state = TX_STATE_IDLE;
+  crypto_digestStop();
+  crypto_signSessionEnd();
+  crypto_addrCacheClear();
+  app_mode_set_expert(false);
+  review_pending = false;
+}
+
+void sim_tick(void) { app_ticker_event_callback(); }
+
+void sim_set_line_sizes(uint16_t keyLen, uint16_t valueLen) {
+  keyLineSize = keyLen < SIM_LINE_SIZE_MAX ? keyLen : SIM_LINE_SIZE_MAX;
+  valueLineSize = valueLen < SIM_LINE_SIZE_MAX ? valueLen : SIM_LINE_SIZE_MAX;
+}
+
+void sim_set_items_per_page(uint8_t n) {
+  itemsPerPage = n == 0 ? 1 : n;
+  if (itemsPerPage > SIM_MAX_ITEMS_PER_PAGE) {
+    itemsPerPage = SIM_MAX_ITEMS_PER_PAGE;
+  }
+}
+
+const sim_screen_t *sim_screens(uint16_t *count) {
+  if (count != NULL) {
+    *count = numScreens;
+  }
+  return screens;
+}
+
+static void add_screen(uint8_t item, uint8_t numItems, uint8_t page,
+                       uint8_t pageCount, uint64_t start) {
+  if (numScreens < SIM_MAX_SCREENS) {
+    screens[numScreens].item = item;
+    screens[numScreens].numItems = numItems;
+    screens[numScreens].page = page;
+    screens[numScreens].pageCount = pageCount;
+    screens[numScreens].ns = stage_now() - start;
+  }
+  numScreens++;
+}
+
+// Pages of one item, from firstPage on
+static zxerr_t render_pages(uint8_t item, uint8_t firstPage) {
+  uint8_t pageCount = firstPage + 1;
+  for (uint8_t page = firstPage; page < pageCount; page++) {
+    const uint64_t start = stage_now();
+    stage_enter(STAGE_RENDER);
+    const zxerr_t err =
+        review_getItem((int8_t)item, keyLine, keyLineSize, valueLine,
+                       valueLineSize, page, &pageCount);
+    stage_leave();
+    CHECK_ZXERR(err)
+    add_screen(item, 1, page, pageCount, start);
+  }
+  return zxerr_ok;
+}
+
+// First pages of the items from item on, read at once
+static zxerr_t render_run(uint8_t item, uint8_t count) {
+  parser_item_t items[SIM_MAX_ITEMS_PER_PAGE];
+  for (uint8_t i = 0; i < count; i++) {
+    items[i].key = keyLines[i];
+    items[i].keyLen = keyLineSize;
+    items[i].val = valueLines[i];
+    items[i].valLen = valueLineSize;
+    items[i].pageIdx = 0;
+    items[i].pageCount = 0;
+  }
+
+  const uint64_t start = stage_now();
+  stage_enter(STAGE_RENDER);
+  const zxerr_t err = tx_getItems(item, count, items);
+  stage_leave();
+  CHECK_ZXERR(err)
+  add_screen(item, count, 0, 1, start);
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (items[i].pageCount > 1) {
+      CHECK_ZXERR(render_pages(item + i, 1))
+    }
+  }
+  return zxerr_ok;
+}
+
+// Walks every page of every item, as a user scrolling to the approve screen
+static zxerr_t review_render(void) {
+  uint8_t numItems = 0;
+  stage_enter(STAGE_RENDER);
+  const zxerr_t err = review_getNumItems(&numItems);
+  stage_leave();
+  CHECK_ZXERR(err)
+
+  for (uint16_t item = 0; item < numItems; item += itemsPerPage) {
+    if (itemsPerPage == 1) {
+      CHECK_ZXERR(render_pages((uint8_t)item, 0))
+      continue;
+    }
+    const uint16_t left = numItems - item;
+    CHECK_ZXERR(render_run((uint8_t)item,
+                           left < itemsPerPage ? (uint8_t)left : itemsPerPage))
+  }
+  return zxerr_ok;
+}
+
+zxerr_t sim_exchange(const uint8_t *apdu, uint16_t apduLen, uint8_t *reply,
+                     uint16_t *replyLen) {
+  if (apdu == NULL || reply == NULL || replyLen == NULL ||
+      apduLen > IO_APDU_BUFFER_SIZE) {
+    return zxerr_out_of_bounds;
+  }
+
+  memcpy(G_io_apdu_buffer, apdu, apduLen);
+  review_pending = false;
+  asyncReplyLen = 0;
+  numScreens = 0;
+
+  volatile uint32_t flags = 0;
+  volatile uint32_t tx = 0;
+  stage_enter(STAGE_APDU);
+  handleApdu(&flags, &tx, apduLen);
+  stage_leave();
+
+  if ((flags & IO_ASYNCH_REPLY) == 0 || !review_pending) {
+    if (tx > SIM_REPLY_SIZE) {
+      return zxerr_buffer_too_small;
+    }
+    memcpy(reply, G_io_apdu_buffer, tx);
+    *replyLen = (uint16_t)tx;
+    return zxerr_ok;
+  }
+
+  // A screen that cannot be rendered stops the review, which the user can
+  // then only reject
+  review_pending = false;
+  stage_enter(STAGE_APDU);
+  const zxerr_t err = review_render();
+  if (err == zxerr_ok) {
+    review_accept();
+  } else {
+    app_reject();
+  }
+  stage_leave();
+
+  if (asyncReplyLen > SIM_REPLY_SIZE) {
+    return zxerr_buffer_too_small;
+  }
+  memcpy(reply, asyncReply, asyncReplyLen);
+  *replyLen = asyncReplyLen;
+  return err;
+}
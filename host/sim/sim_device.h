@@ -0,0 +1,71 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "zxerror.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// The app as the host sees it: an APDU in, a reply out. The view is headless
+// and approves every review, once all of its screens have been rendered.
+
+#define SIM_MAX_SCREENS 512u
+#define SIM_REPLY_SIZE 260u
+#define SIM_MAX_ITEMS_PER_PAGE 8u
+
+typedef struct {
+  // First item of the screen, and how many it shows
+  uint8_t item;
+  uint8_t numItems;
+  uint8_t page;
+  uint8_t pageCount;
+  // Time to render the screen
+  uint64_t ns;
+} sim_screen_t;
+
+/// Returns the app to the state it starts in: unlocked, idle, out of expert
+/// mode and with no address cached
+void sim_reset(void);
+
+/// Sends the app a ticker event, as the device does about every 100 ms
+void sim_tick(void);
+
+/// Sizes of the key and value lines each screen is rendered into
+void sim_set_line_sizes(uint16_t keyLen, uint16_t valueLen);
+
+/// Items shown per screen, as on Stax and Flex where a page lists several.
+/// Above 1, they are read with tx_getItems, and the further pages of long
+/// values one at a time. Defaults to 1.
+void sim_set_items_per_page(uint8_t itemsPerPage);
+
+/// Runs one APDU through handleApdu, and through the review it starts if
+/// any. reply holds SIM_REPLY_SIZE bytes, replyLen includes the status word.
+/// A review with a screen that cannot be rendered is rejected, its reply is
+/// returned with the error.
+zxerr_t sim_exchange(const uint8_t *apdu, uint16_t apduLen, uint8_t *reply,
+                     uint16_t *replyLen);
+
+/// Screens rendered by the last review. numScreens counts the ones that did
+/// not fit in SIM_MAX_SCREENS too.
+const sim_screen_t *sim_screens(uint16_t *numScreens);
+
+#ifdef __cplusplus
+}
+#endif
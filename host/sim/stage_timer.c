@@ -0,0 +1,73 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "stage_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define STAGE_MAX_DEPTH 8u
+
+static const char *const stage_names[STAGE_COUNT] = {
+    "apdu",  "upload", "hash",  "key",    "address",
+    "parse", "validate", "index", "render", "sign",
+};
+
+static stage_totals_t totals;
+static stage_e stack[STAGE_MAX_DEPTH];
+static uint8_t depth = 0;
+static uint64_t mark = 0;
+
+uint64_t stage_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void stage_reset(void) {
+  memset(&totals, 0, sizeof(totals));
+  depth = 0;
+}
+
+void stage_enter(stage_e stage) {
+  const uint64_t now = stage_now();
+  if (depth > 0) {
+    totals.ns[stack[depth - 1]] += now - mark;
+  }
+  if (depth >= STAGE_MAX_DEPTH || stage >= STAGE_COUNT) {
+    fprintf(stderr, "stage_enter: too deep or unknown stage\n");
+    abort();
+  }
+  stack[depth++] = stage;
+  totals.calls[stage]++;
+  mark = now;
+}
+
+void stage_leave(void) {
+  const uint64_t now = stage_now();
+  if (depth == 0) {
+    fprintf(stderr, "stage_leave: no stage entered\n");
+    abort();
+  }
+  totals.ns[stack[--depth]] += now - mark;
+  mark = now;
+}
+
+const stage_totals_t *stage_totals(void) { return &totals; }
+
+const char *stage_name(stage_e stage) {
+  return stage < STAGE_COUNT ? stage_names[stage] : "?";
+}
@@ -0,0 +1,65 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Time spent in each stage of a request, for the APDU simulator. Stages
+// nest: time is charged to the innermost stage entered, so the totals add up
+// to the time of the outermost one.
+
+typedef enum {
+  // Handler code outside of the stages below
+  STAGE_APDU = 0,
+  // Staging chunks in RAM and writing them to flash
+  STAGE_UPLOAD,
+  STAGE_HASH,
+  // Deriving the signing key, and the address shown with it
+  STAGE_KEY,
+  STAGE_ADDRESS,
+  STAGE_PARSE,
+  STAGE_VALIDATE,
+  // Counting the screens of a transaction
+  STAGE_INDEX,
+  STAGE_RENDER,
+  STAGE_SIGN,
+  STAGE_COUNT,
+} stage_e;
+
+typedef struct {
+  uint64_t ns[STAGE_COUNT];
+  uint32_t calls[STAGE_COUNT];
+} stage_totals_t;
+
+/// Clears the totals, stages must not be open
+void stage_reset(void);
+
+void stage_enter(stage_e stage);
+void stage_leave(void);
+
+const stage_totals_t *stage_totals(void);
+const char *stage_name(stage_e stage);
+
+/// Monotonic time in nanoseconds
+uint64_t stage_now(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,175 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// Stage boundaries, as wrappers of the functions that start each stage. The
+// simulator links with -Wl,--wrap=<function> for each of them, which routes
+// the calls made from other files through __wrap_<function>. The app itself
+// is not changed.
+
+#include "common/parser.h"
+#include "compress/lz_decoder.h"
+#include "crypto.h"
+#include "nvm/nvm_cache.h"
+#include "stage_timer.h"
+#include "tx_direct.h"
+#include "tx_direct_stream.h"
+#include "tx_display.h"
+
+uint32_t __real_nvm_cache_append(nvm_cache_t *cache, const uint8_t *data,
+                                 uint32_t len);
+void __real_nvm_cache_flush(nvm_cache_t *cache);
+parser_error_t __real_lz_decode(lz_decoder_t *decoder, const uint8_t *in,
+                                size_t inLen, size_t *consumed,
+                                const uint8_t *history, size_t historyLen,
+                                uint8_t *out, size_t outLen, size_t *produced);
+zxerr_t __real_crypto_digestUpdate(const uint8_t *data, uint32_t len);
+zxerr_t __real_crypto_digestFinish(void);
+zxerr_t __real_crypto_signSessionStart(void);
+zxerr_t __real_crypto_fillAddress(uint8_t *buffer, uint16_t bufferLen,
+                                  uint16_t *addrResponseLen);
+parser_error_t __real_tx_direct_stream_feed(tx_direct_stream_t *stream,
+                                            const uint8_t *data,
+                                            size_t dataLen);
+parser_error_t __real_parser_parse(parser_context_t *ctx, const uint8_t *data,
+                                   size_t dataLen, parser_tx_t *tx_obj);
+parser_error_t __real_parser_parseDirectStream(parser_context_t *ctx,
+                                               const uint8_t *data,
+                                               size_t dataLen,
+                                               tx_direct_stream_t *stream,
+                                               parser_tx_t *tx_obj);
+parser_error_t __real_parser_validate(const parser_context_t *ctx);
+parser_error_t __real_tx_display_numItems(uint8_t *num_items);
+parser_error_t __real_tx_direct_numItems(const tx_direct_t *tx,
+                                         uint8_t *numItems);
+zxerr_t __real_crypto_sign(uint8_t *signature, uint16_t signatureMaxlen,
+                           uint16_t *signatureLen);
+
+uint32_t __wrap_nvm_cache_append(nvm_cache_t *cache, const uint8_t *data,
+                                 uint32_t len) {
+  stage_enter(STAGE_UPLOAD);
+  const uint32_t added = __real_nvm_cache_append(cache, data, len);
+  stage_leave();
+  return added;
+}
+
+void __wrap_nvm_cache_flush(nvm_cache_t *cache) {
+  stage_enter(STAGE_UPLOAD);
+  __real_nvm_cache_flush(cache);
+  stage_leave();
+}
+
+parser_error_t __wrap_lz_decode(lz_decoder_t *decoder, const uint8_t *in,
+                                size_t inLen, size_t *consumed,
+                                const uint8_t *history, size_t historyLen,
+                                uint8_t *out, size_t outLen, size_t *produced) {
+  stage_enter(STAGE_UPLOAD);
+  const parser_error_t err =
+      __real_lz_decode(decoder, in, inLen, consumed, history, historyLen, out,
+                       outLen, produced);
+  stage_leave();
+  return err;
+}
+
+zxerr_t __wrap_crypto_digestUpdate(const uint8_t *data, uint32_t len) {
+  stage_enter(STAGE_HASH);
+  const zxerr_t err = __real_crypto_digestUpdate(data, len);
+  stage_leave();
+  return err;
+}
+
+zxerr_t __wrap_crypto_digestFinish(void) {
+  stage_enter(STAGE_HASH);
+  const zxerr_t err = __real_crypto_digestFinish();
+  stage_leave();
+  return err;
+}
+
+zxerr_t __wrap_crypto_signSessionStart(void) {
+  stage_enter(STAGE_KEY);
+  const zxerr_t err = __real_crypto_signSessionStart();
+  stage_leave();
+  return err;
+}
+
+zxerr_t __wrap_crypto_fillAddress(uint8_t *buffer, uint16_t bufferLen,
+                                  uint16_t *addrResponseLen) {
+  stage_enter(STAGE_ADDRESS);
+  const zxerr_t err =
+      __real_crypto_fillAddress(buffer, bufferLen, addrResponseLen);
+  stage_leave();
+  return err;
+}
+
+parser_error_t __wrap_tx_direct_stream_feed(tx_direct_stream_t *stream,
+                                            const uint8_t *data,
+                                            size_t dataLen) {
+  stage_enter(STAGE_PARSE);
+  const parser_error_t err =
+      __real_tx_direct_stream_feed(stream, data, dataLen);
+  stage_leave();
+  return err;
+}
+
+parser_error_t __wrap_parser_parse(parser_context_t *ctx, const uint8_t *data,
+                                   size_t dataLen, parser_tx_t *tx_obj) {
+  stage_enter(STAGE_PARSE);
+  const parser_error_t err = __real_parser_parse(ctx, data, dataLen, tx_obj);
+  stage_leave();
+  return err;
+}
+
+parser_error_t __wrap_parser_parseDirectStream(parser_context_t *ctx,
+                                               const uint8_t *data,
+                                               size_t dataLen,
+                                               tx_direct_stream_t *stream,
+                                               parser_tx_t *tx_obj) {
+  stage_enter(STAGE_PARSE);
+  const parser_error_t err =
+      __real_parser_parseDirectStream(ctx, data, dataLen, stream, tx_obj);
+  stage_leave();
+  return err;
+}
+
+parser_error_t __wrap_parser_validate(const parser_context_t *ctx) {
+  stage_enter(STAGE_VALIDATE);
+  const parser_error_t err = __real_parser_validate(ctx);
+  stage_leave();
+  return err;
+}
+
+parser_error_t __wrap_tx_display_numItems(uint8_t *num_items) {
+  stage_enter(STAGE_INDEX);
+  const parser_error_t err = __real_tx_display_numItems(num_items);
+  stage_leave();
+  return err;
+}
+
+parser_error_t __wrap_tx_direct_numItems(const tx_direct_t *tx,
+                                         uint8_t *numItems) {
+  stage_enter(STAGE_INDEX);
+  const parser_error_t err = __real_tx_direct_numItems(tx, numItems);
+  stage_leave();
+  return err;
+}
+
+zxerr_t __wrap_crypto_sign(uint8_t *signature, uint16_t signatureMaxlen,
+                           uint16_t *signatureLen) {
+  stage_enter(STAGE_SIGN);
+  const zxerr_t err =
+      __real_crypto_sign(signature, signatureMaxlen, signatureLen);
+  stage_leave();
+  return err;
+}
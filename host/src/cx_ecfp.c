@@ -0,0 +1,569 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "cx.h"
+#include <string.h>
+
+// secp256k1 over 64 bit limbs, least significant first. Points are kept in
+// Jacobian coordinates and only made affine for output.
+
+#define LIMBS 4u
+#define SCALAR_LEN 32u
+#define DER_MAX_LEN 72u
+
+typedef unsigned __int128 uint128_t;
+
+// Moduli are 2^256 - c, so the high half of a product reduces as a multiple
+// of c
+typedef struct {
+  uint64_t m[LIMBS];
+  uint64_t c[3];
+} modulus_t;
+
+static const modulus_t field_p = {
+    {0xFFFFFFFEFFFFFC2F, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF,
+     0xFFFFFFFFFFFFFFFF},
+    {0x00000001000003D1, 0, 0}};
+
+static const modulus_t order_n = {
+    {0xBFD25E8CD0364141, 0xBAAEDCE6AF48A03B, 0xFFFFFFFFFFFFFFFE,
+     0xFFFFFFFFFFFFFFFF},
+    {0x402DA1732FC9BEBF, 0x4551231950B75FC4, 0x0000000000000001}};
+
+typedef struct {
+  uint64_t x[LIMBS];
+  uint64_t y[LIMBS];
+} affine_t;
+
+// Z == 0 is the point at infinity
+typedef struct {
+  uint64_t x[LIMBS];
+  uint64_t y[LIMBS];
+  uint64_t z[LIMBS];
+} jacobian_t;
+
+static const affine_t generator = {
+    {0x59F2815B16F81798, 0x029BFCDB2DCE28D9, 0x55A06295CE870B07,
+     0x79BE667EF9DCBBAC},
+    {0x9C47D08FFB10D4B8, 0xFD17B448A6855419, 0x5DA4FBFC0E1108A8,
+     0x483ADA7726A3C465}};
+
+static void u256_from_bytes(uint64_t r[LIMBS], const uint8_t *in) {
+  for (uint8_t i = 0; i < LIMBS; i++) {
+    uint64_t limb = 0;
+    for (uint8_t j = 0; j < 8; j++) {
+      limb = (limb << 8) | in[8 * (LIMBS - 1 - i) + j];
+    }
+    r[i] = limb;
+  }
+}
+
+static void u256_to_bytes(uint8_t *out, const uint64_t a[LIMBS]) {
+  for (uint8_t i = 0; i < LIMBS; i++) {
+    for (uint8_t j = 0; j < 8; j++) {
+      out[8 * (LIMBS - 1 - i) + j] = (uint8_t)(a[i] >> (56 - 8 * j));
+    }
+  }
+}
+
+static bool u256_is_zero(const uint64_t a[LIMBS]) {
+  return (a[0] | a[1] | a[2] | a[3]) == 0;
+}
+
+static int u256_cmp(const uint64_t a[LIMBS], const uint64_t b[LIMBS]) {
+  for (uint8_t i = LIMBS; i > 0; i--) {
+    if (a[i - 1] != b[i - 1]) {
+      return a[i - 1] < b[i - 1] ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+static uint64_t u256_add(uint64_t r[LIMBS], const uint64_t a[LIMBS],
+                         const uint64_t b[LIMBS]) {
+  uint128_t carry = 0;
+  for (uint8_t i = 0; i < LIMBS; i++) {
+    carry += (uint128_t)a[i] + b[i];
+    r[i] = (uint64_t)carry;
+    carry >>= 64;
+  }
+  return (uint64_t)carry;
+}
+
+static uint64_t u256_sub(uint64_t r[LIMBS], const uint64_t a[LIMBS],
+                         const uint64_t b[LIMBS]) {
+  uint64_t borrow = 0;
+  for (uint8_t i = 0; i < LIMBS; i++) {
+    const uint64_t d = a[i] - b[i];
+    const uint64_t nextBorrow = (a[i] < b[i]) | (d < borrow);
+    r[i] = d - borrow;
+    borrow = nextBorrow;
+  }
+  return borrow;
+}
+
+// Moduli are above 2^255, a single subtraction brings any value below them
+static void mod_normalize(uint64_t r[LIMBS], const modulus_t *m) {
+  if (u256_cmp(r, m->m) >= 0) {
+    u256_sub(r, r, m->m);
+  }
+}
+
+static void mod_add(uint64_t r[LIMBS], const uint64_t a[LIMBS],
+                    const uint64_t b[LIMBS], const modulus_t *m) {
+  if (u256_add(r, a, b) != 0 || u256_cmp(r, m->m) >= 0) {
+    u256_sub(r, r, m->m);
+  }
+}
+
+static void mod_sub(uint64_t r[LIMBS], const uint64_t a[LIMBS],
+                    const uint64_t b[LIMBS], const modulus_t *m) {
+  if (u256_sub(r, a, b) != 0) {
+    u256_add(r, r, m->m);
+  }
+}
+
+static void mod_mul(uint64_t r[LIMBS], const uint64_t a[LIMBS],
+                    const uint64_t b[LIMBS], const modulus_t *m) {
+  uint64_t t[2 * LIMBS] = {0};
+  for (uint8_t i = 0; i < LIMBS; i++) {
+    uint64_t carry = 0;
+    for (uint8_t j = 0; j < LIMBS; j++) {
+      const uint128_t acc = (uint128_t)a[i] * b[j] + t[i + j] + carry;
+      t[i + j] = (uint64_t)acc;
+      carry = (uint64_t)(acc >> 64);
+    }
+    t[i + LIMBS] = carry;
+  }
+
+  // hi * 2^256 + lo = hi * c + lo, until the high half is gone
+  while ((t[4] | t[5] | t[6] | t[7]) != 0) {
+    uint64_t u[2 * LIMBS] = {t[0], t[1], t[2], t[3], 0, 0, 0, 0};
+    for (uint8_t i = 0; i < LIMBS; i++) {
+      uint64_t carry = 0;
+      uint8_t k = i;
+      for (uint8_t j = 0; j < 3; j++, k++) {
+        const uint128_t acc =
+            (uint128_t)t[LIMBS + i] * m->c[j] + u[k] + carry;
+        u[k] = (uint64_t)acc;
+        carry = (uint64_t)(acc >> 64);
+      }
+      for (; carry != 0 && k < 2 * LIMBS; k++) {
+        u[k] += carry;
+        carry = u[k] < carry;
+      }
+    }
+    memcpy(t, u, sizeof(t));
+  }
+  memcpy(r, t, LIMBS * sizeof(uint64_t));
+  mod_normalize(r, m);
+}
+
+// a^(m - 2), the inverse of a by Fermat's little theorem
+static void mod_inv(uint64_t r[LIMBS], const uint64_t a[LIMBS],
+                    const modulus_t *m) {
+  uint64_t e[LIMBS];
+  memcpy(e, m->m, sizeof(e));
+  e[0] -= 2;
+
+  uint64_t acc[LIMBS] = {1, 0, 0, 0};
+  for (int bit = 255; bit >= 0; bit--) {
+    mod_mul(acc, acc, acc, m);
+    if (((e[bit / 64] >> (bit % 64)) & 1u) != 0) {
+      mod_mul(acc, acc, a, m);
+    }
+  }
+  memcpy(r, acc, sizeof(acc));
+}
+
+/////////////////////////////////////////////
+// Points
+
+#define FMUL(r, a, b) mod_mul((r), (a), (b), &field_p)
+#define FADD(r, a, b) mod_add((r), (a), (b), &field_p)
+#define FSUB(r, a, b) mod_sub((r), (a), (b), &field_p)
+
+static void point_double(jacobian_t *r, const jacobian_t *p) {
+  if (u256_is_zero(p->z) || u256_is_zero(p->y)) {
+    memset(r, 0, sizeof(*r));
+    return;
+  }
+  // dbl-2009-l, for a = 0
+  uint64_t a[LIMBS], b[LIMBS], c[LIMBS], d[LIMBS], e[LIMBS], f[LIMBS];
+  uint64_t t[LIMBS];
+  FMUL(a, p->x, p->x);
+  FMUL(b, p->y, p->y);
+  FMUL(c, b, b);
+  FADD(t, p->x, b);
+  FMUL(d, t, t);
+  FSUB(d, d, a);
+  FSUB(d, d, c);
+  FADD(d, d, d);
+  FADD(e, a, a);
+  FADD(e, e, a);
+  FMUL(f, e, e);
+
+  uint64_t z[LIMBS];
+  FMUL(z, p->y, p->z);
+  FADD(r->z, z, z);
+  FSUB(r->x, f, d);
+  FSUB(r->x, r->x, d);
+  FSUB(t, d, r->x);
+  FMUL(r->y, e, t);
+  FADD(c, c, c);
+  FADD(c, c, c);
+  FADD(c, c, c);
+  FSUB(r->y, r->y, c);
+}
+
+static void point_add_affine(jacobian_t *r, const jacobian_t *p,
+                             const affine_t *q) {
+  if (u256_is_zero(p->z)) {
+    memcpy(r->x, q->x, sizeof(r->x));
+    memcpy(r->y, q->y, sizeof(r->y));
+    memset(r->z, 0, sizeof(r->z));
+    r->z[0] = 1;
+    return;
+  }
+  // madd-2007-bl
+  uint64_t z1z1[LIMBS], u2[LIMBS], s2[LIMBS], h[LIMBS], hh[LIMBS];
+  uint64_t i[LIMBS], j[LIMBS], rr[LIMBS], v[LIMBS], t[LIMBS];
+  FMUL(z1z1, p->z, p->z);
+  FMUL(u2, q->x, z1z1);
+  FMUL(s2, q->y, p->z);
+  FMUL(s2, s2, z1z1);
+  FSUB(h, u2, p->x);
+  FSUB(rr, s2, p->y);
+  if (u256_is_zero(h)) {
+    if (u256_is_zero(rr)) {
+      point_double(r, p);
+    } else {
+      memset(r, 0, sizeof(*r));
+    }
+    return;
+  }
+  FADD(rr, rr, rr);
+  FMUL(hh, h, h);
+  FADD(i, hh, hh);
+  FADD(i, i, i);
+  FMUL(j, h, i);
+  FMUL(v, p->x, i);
+
+  jacobian_t out;
+  FMUL(out.x, rr, rr);
+  FSUB(out.x, out.x, j);
+  FSUB(out.x, out.x, v);
+  FSUB(out.x, out.x, v);
+  FSUB(t, v, out.x);
+  FMUL(out.y, rr, t);
+  FMUL(t, p->y, j);
+  FSUB(out.y, out.y, t);
+  FSUB(out.y, out.y, t);
+  FADD(t, p->z, h);
+  FMUL(out.z, t, t);
+  FSUB(out.z, out.z, z1z1);
+  FSUB(out.z, out.z, hh);
+  memcpy(r, &out, sizeof(out));
+}
+
+static void point_mul(jacobian_t *r, const uint64_t k[LIMBS],
+                      const affine_t *p) {
+  jacobian_t acc;
+  memset(&acc, 0, sizeof(acc));
+  for (int bit = 255; bit >= 0; bit--) {
+    point_double(&acc, &acc);
+    if (((k[bit / 64] >> (bit % 64)) & 1u) != 0) {
+      point_add_affine(&acc, &acc, p);
+    }
+  }
+  memcpy(r, &acc, sizeof(acc));
+}
+
+// False for the point at infinity
+static bool point_to_affine(affine_t *r, const jacobian_t *p) {
+  if (u256_is_zero(p->z)) {
+    return false;
+  }
+  uint64_t zi[LIMBS], zi2[LIMBS];
+  mod_inv(zi, p->z, &field_p);
+  FMUL(zi2, zi, zi);
+  FMUL(r->x, p->x, zi2);
+  FMUL(zi2, zi2, zi);
+  FMUL(r->y, p->y, zi2);
+  return true;
+}
+
+/////////////////////////////////////////////
+// Keys
+
+// Private keys must be in [1, n - 1]
+static bool scalar_is_valid(const uint64_t d[LIMBS]) {
+  return !u256_is_zero(d) && u256_cmp(d, order_n.m) < 0;
+}
+
+cx_err_t cx_ecfp_init_private_key_no_throw(cx_curve_t curve,
+                                           const uint8_t *raw_key,
+                                           size_t key_len,
+                                           cx_ecfp_private_key_t *pvkey) {
+  if (curve != CX_CURVE_256K1 || pvkey == NULL ||
+      (raw_key != NULL && key_len != SCALAR_LEN)) {
+    return CX_INVALID_PARAMETER;
+  }
+  memset(pvkey, 0, sizeof(*pvkey));
+  pvkey->curve = curve;
+  if (raw_key != NULL) {
+    memcpy(pvkey->d, raw_key, SCALAR_LEN);
+    pvkey->d_len = SCALAR_LEN;
+  }
+  return CX_OK;
+}
+
+cx_err_t cx_ecfp_init_public_key_no_throw(cx_curve_t curve,
+                                          const uint8_t *raw_key,
+                                          size_t key_len,
+                                          cx_ecfp_public_key_t *key) {
+  if (curve != CX_CURVE_256K1 || key == NULL ||
+      (raw_key != NULL && key_len != sizeof(key->W))) {
+    return CX_INVALID_PARAMETER;
+  }
+  memset(key, 0, sizeof(*key));
+  key->curve = curve;
+  if (raw_key != NULL) {
+    memcpy(key->W, raw_key, sizeof(key->W));
+    key->W_len = sizeof(key->W);
+  }
+  return CX_OK;
+}
+
+cx_err_t cx_ecfp_generate_pair_no_throw(cx_curve_t curve,
+                                        cx_ecfp_public_key_t *pubkey,
+                                        cx_ecfp_private_key_t *privkey,
+                                        bool keepprivate) {
+  // The host has no source of randomness, keys come from BIP32
+  if (curve != CX_CURVE_256K1 || pubkey == NULL || privkey == NULL ||
+      !keepprivate || privkey->d_len != SCALAR_LEN) {
+    return CX_INVALID_PARAMETER;
+  }
+  uint64_t d[LIMBS];
+  u256_from_bytes(d, privkey->d);
+  if (!scalar_is_valid(d)) {
+    return CX_INVALID_PARAMETER;
+  }
+
+  jacobian_t point;
+  affine_t affine;
+  point_mul(&point, d, &generator);
+  memset(d, 0, sizeof(d));
+  if (!point_to_affine(&affine, &point)) {
+    return CX_INTERNAL_ERROR;
+  }
+
+  pubkey->curve = curve;
+  pubkey->W_len = sizeof(pubkey->W);
+  pubkey->W[0] = 0x04;
+  u256_to_bytes(pubkey->W + 1, affine.x);
+  u256_to_bytes(pubkey->W + 1 + SCALAR_LEN, affine.y);
+  return CX_OK;
+}
+
+/////////////////////////////////////////////
+// ECDSA
+
+static size_t der_integer(uint8_t *out, const uint8_t value[SCALAR_LEN]) {
+  size_t skip = 0;
+  while (skip < SCALAR_LEN - 1 && value[skip] == 0) {
+    skip++;
+  }
+  const size_t pad = (value[skip] & 0x80u) != 0 ? 1 : 0;
+  const size_t len = SCALAR_LEN - skip + pad;
+  if (out != NULL) {
+    out[0] = 0x02;
+    out[1] = (uint8_t)len;
+    out[2] = 0;
+    memcpy(out + 2 + pad, value + skip, SCALAR_LEN - skip);
+  }
+  return 2 + len;
+}
+
+static bool der_read_integer(const uint8_t **in, const uint8_t *end,
+                             uint64_t r[LIMBS]) {
+  if (end - *in < 2 || (*in)[0] != 0x02) {
+    return false;
+  }
+  size_t len = (*in)[1];
+  const uint8_t *value = *in + 2;
+  if (len == 0 || (size_t)(end - value) < len) {
+    return false;
+  }
+  *in = value + len;
+  if (len == SCALAR_LEN + 1 && value[0] == 0) {
+    value++;
+    len--;
+  }
+  if (len > SCALAR_LEN) {
+    return false;
+  }
+  uint8_t bytes[SCALAR_LEN] = {0};
+  memcpy(bytes + SCALAR_LEN - len, value, len);
+  u256_from_bytes(r, bytes);
+  return true;
+}
+
+cx_err_t cx_ecdsa_sign_no_throw(const cx_ecfp_private_key_t *pvkey,
+                                uint32_t mode, cx_md_t hashID,
+                                const uint8_t *hash, size_t hash_len,
+                                uint8_t *sig, size_t *sig_len, uint32_t *info) {
+  // Only RFC 6979 nonces, with the HMAC of SHA-256
+  if (pvkey == NULL || hash == NULL || sig == NULL || sig_len == NULL ||
+      pvkey->curve != CX_CURVE_256K1 || pvkey->d_len != SCALAR_LEN ||
+      hash_len != CX_SHA256_SIZE || hashID != CX_SHA256 ||
+      (mode & CX_RND_RFC6979) != CX_RND_RFC6979) {
+    return CX_INVALID_PARAMETER;
+  }
+
+  uint64_t d[LIMBS], z[LIMBS], k[LIMBS], r[LIMBS], s[LIMBS];
+  u256_from_bytes(d, pvkey->d);
+  if (!scalar_is_valid(d)) {
+    return CX_INVALID_PARAMETER;
+  }
+  u256_from_bytes(z, hash);
+  mod_normalize(z, &order_n);
+
+  // V, K, then V || 0x00 || key || digest, per section 3.2
+  uint8_t v[CX_SHA256_SIZE];
+  uint8_t key[CX_SHA256_SIZE];
+  uint8_t buf[CX_SHA256_SIZE + 1 + 2 * SCALAR_LEN];
+  memset(v, 0x01, sizeof(v));
+  memset(key, 0x00, sizeof(key));
+  memcpy(buf + CX_SHA256_SIZE + 1, pvkey->d, SCALAR_LEN);
+  u256_to_bytes(buf + CX_SHA256_SIZE + 1 + SCALAR_LEN, z);
+  for (uint8_t round = 0; round < 2; round++) {
+    memcpy(buf, v, sizeof(v));
+    buf[CX_SHA256_SIZE] = round;
+    cx_hmac_sha256(key, sizeof(key), buf, sizeof(buf), key, sizeof(key));
+    cx_hmac_sha256(key, sizeof(key), v, sizeof(v), v, sizeof(v));
+  }
+
+  uint32_t parity = 0;
+  for (;;) {
+    cx_hmac_sha256(key, sizeof(key), v, sizeof(v), v, sizeof(v));
+    u256_from_bytes(k, v);
+    if (scalar_is_valid(k)) {
+      jacobian_t point;
+      affine_t affine;
+      point_mul(&point, k, &generator);
+      if (point_to_affine(&affine, &point)) {
+        memcpy(r, affine.x, sizeof(r));
+        parity = (uint32_t)(affine.y[0] & 1u);
+        if (u256_cmp(r, order_n.m) >= 0) {
+          parity |= CX_ECCINFO_xGTn;
+        }
+        mod_normalize(r, &order_n);
+
+        // s = (z + r * d) / k
+        mod_mul(s, r, d, &order_n);
+        mod_add(s, s, z, &order_n);
+        mod_inv(k, k, &order_n);
+        mod_mul(s, s, k, &order_n);
+        if (!u256_is_zero(r) && !u256_is_zero(s)) {
+          break;
+        }
+      }
+    }
+    memcpy(buf, v, sizeof(v));
+    buf[CX_SHA256_SIZE] = 0;
+    cx_hmac_sha256(key, sizeof(key), buf, CX_SHA256_SIZE + 1, key,
+                   sizeof(key));
+    cx_hmac_sha256(key, sizeof(key), v, sizeof(v), v, sizeof(v));
+  }
+  memset(d, 0, sizeof(d));
+  memset(k, 0, sizeof(k));
+  memset(key, 0, sizeof(key));
+  memset(v, 0, sizeof(v));
+  memset(buf, 0, sizeof(buf));
+
+  // Low S, as the device does, flipping the parity of R
+  uint64_t halfOrder[LIMBS];
+  for (uint8_t i = 0; i < LIMBS; i++) {
+    halfOrder[i] = (order_n.m[i] >> 1) |
+                   (i + 1u < LIMBS ? order_n.m[i + 1] << 63 : 0);
+  }
+  if (u256_cmp(s, halfOrder) > 0) {
+    u256_sub(s, order_n.m, s);
+    parity ^= CX_ECCINFO_PARITY_ODD;
+  }
+
+  uint8_t rBytes[SCALAR_LEN];
+  uint8_t sBytes[SCALAR_LEN];
+  u256_to_bytes(rBytes, r);
+  u256_to_bytes(sBytes, s);
+  const size_t seqLen = der_integer(NULL, rBytes) + der_integer(NULL, sBytes);
+  if (*sig_len < 2 + seqLen) {
+    return CX_INVALID_PARAMETER;
+  }
+  sig[0] = 0x30;
+  sig[1] = (uint8_t)seqLen;
+  const size_t rLen = der_integer(sig + 2, rBytes);
+  der_integer(sig + 2 + rLen, sBytes);
+  *sig_len = 2 + seqLen;
+  if (info != NULL) {
+    *info = parity;
+  }
+  return CX_OK;
+}
+
+bool cx_ecdsa_verify_no_throw(const cx_ecfp_public_key_t *pukey,
+                              const uint8_t *hash, size_t hash_len,
+                              const uint8_t *sig, size_t sig_len) {
+  if (pukey == NULL || hash == NULL || sig == NULL ||
+      pukey->curve != CX_CURVE_256K1 || pukey->W_len != sizeof(pukey->W) ||
+      pukey->W[0] != 0x04 || hash_len != CX_SHA256_SIZE || sig_len < 2 ||
+      sig_len > DER_MAX_LEN || sig[0] != 0x30 || sig[1] != sig_len - 2) {
+    return false;
+  }
+
+  uint64_t r[LIMBS], s[LIMBS], z[LIMBS];
+  const uint8_t *cursor = sig + 2;
+  const uint8_t *end = sig + sig_len;
+  if (!der_read_integer(&cursor, end, r) ||
+      !der_read_integer(&cursor, end, s) || cursor != end ||
+      !scalar_is_valid(r) || !scalar_is_valid(s)) {
+    return false;
+  }
+  u256_from_bytes(z, hash);
+  mod_normalize(z, &order_n);
+
+  // z / s * G + r / s * Q has r as x coordinate
+  uint64_t w[LIMBS], u1[LIMBS], u2[LIMBS];
+  mod_inv(w, s, &order_n);
+  mod_mul(u1, z, w, &order_n);
+  mod_mul(u2, r, w, &order_n);
+
+  affine_t q;
+  u256_from_bytes(q.x, pukey->W + 1);
+  u256_from_bytes(q.y, pukey->W + 1 + SCALAR_LEN);
+  jacobian_t p1, p2;
+  affine_t a2, sum;
+  point_mul(&p1, u1, &generator);
+  point_mul(&p2, u2, &q);
+  if (point_to_affine(&a2, &p2)) {
+    point_add_affine(&p1, &p1, &a2);
+  }
+  if (!point_to_affine(&sum, &p1)) {
+    return false;
+  }
+  mod_normalize(sum.x, &order_n);
+  return u256_cmp(sum.x, r) == 0;
+}
@@ -0,0 +1,548 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "cx.h"
+#include <string.h>
+
+#define SHA256_BLOCK_LEN 64u
+#define SHA512_BLOCK_LEN 128u
+
+#define ROR32(x, n) (((x) >> (n)) | ((x) << (32u - (n))))
+#define ROR64(x, n) (((x) >> (n)) | ((x) << (64u - (n))))
+#define ROL32(x, n) (((x) << (n)) | ((x) >> (32u - (n))))
+
+static uint32_t load32_be(const uint8_t *in) {
+  return ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) |
+         ((uint32_t)in[2] << 8) | in[3];
+}
+
+static uint64_t load64_be(const uint8_t *in) {
+  return ((uint64_t)load32_be(in) << 32) | load32_be(in + 4);
+}
+
+static uint32_t load32_le(const uint8_t *in) {
+  return ((uint32_t)in[3] << 24) | ((uint32_t)in[2] << 16) |
+         ((uint32_t)in[1] << 8) | in[0];
+}
+
+static void store32_be(uint8_t *out, uint32_t v) {
+  out[0] = (uint8_t)(v >> 24);
+  out[1] = (uint8_t)(v >> 16);
+  out[2] = (uint8_t)(v >> 8);
+  out[3] = (uint8_t)v;
+}
+
+static void store64_be(uint8_t *out, uint64_t v) {
+  store32_be(out, (uint32_t)(v >> 32));
+  store32_be(out + 4, (uint32_t)v);
+}
+
+static void store32_le(uint8_t *out, uint32_t v) {
+  out[0] = (uint8_t)v;
+  out[1] = (uint8_t)(v >> 8);
+  out[2] = (uint8_t)(v >> 16);
+  out[3] = (uint8_t)(v >> 24);
+}
+
+/////////////////////////////////////////////
+// SHA-256, FIPS 180-4
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+static void sha256_compress(uint32_t state[8], const uint8_t *block) {
+  uint32_t w[64];
+  for (uint8_t i = 0; i < 16; i++) {
+    w[i] = load32_be(block + 4 * i);
+  }
+  for (uint8_t i = 16; i < 64; i++) {
+    const uint32_t s0 =
+        ROR32(w[i - 15], 7) ^ ROR32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    const uint32_t s1 =
+        ROR32(w[i - 2], 17) ^ ROR32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+  uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+  for (uint8_t i = 0; i < 64; i++) {
+    const uint32_t s1 = ROR32(e, 6) ^ ROR32(e, 11) ^ ROR32(e, 25);
+    const uint32_t t1 = h + s1 + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+    const uint32_t s0 = ROR32(a, 2) ^ ROR32(a, 13) ^ ROR32(a, 22);
+    const uint32_t t2 = s0 + ((a & b) ^ (a & c) ^ (b & c));
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+cx_err_t cx_sha256_init_no_throw(cx_sha256_t *hash) {
+  static const uint32_t iv[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                                 0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                 0x1f83d9ab, 0x5be0cd19};
+  if (hash == NULL) {
+    return CX_INVALID_PARAMETER;
+  }
+  memset(hash, 0, sizeof(*hash));
+  hash->header.algo = CX_SHA256;
+  memcpy(hash->state, iv, sizeof(iv));
+  return CX_OK;
+}
+
+static void sha256_update(cx_sha256_t *hash, const uint8_t *in, size_t len) {
+  size_t used = hash->length % SHA256_BLOCK_LEN;
+  hash->length += len;
+  while (len > 0) {
+    const size_t n =
+        len < SHA256_BLOCK_LEN - used ? len : SHA256_BLOCK_LEN - used;
+    memcpy(hash->block + used, in, n);
+    in += n;
+    len -= n;
+    used += n;
+    if (used == SHA256_BLOCK_LEN) {
+      sha256_compress(hash->state, hash->block);
+      used = 0;
+    }
+  }
+}
+
+static void sha256_final(cx_sha256_t *hash, uint8_t *out) {
+  const uint64_t bits = hash->length * 8;
+  const size_t used = hash->length % SHA256_BLOCK_LEN;
+  uint8_t pad[SHA256_BLOCK_LEN + 8] = {0x80};
+  const size_t padLen = (used < 56 ? 56 : 120) - used;
+  store64_be(pad + padLen, bits);
+  sha256_update(hash, pad, padLen + 8);
+  for (uint8_t i = 0; i < 8; i++) {
+    store32_be(out + 4 * i, hash->state[i]);
+  }
+  memset(hash, 0, sizeof(*hash));
+}
+
+/////////////////////////////////////////////
+// SHA-512, FIPS 180-4
+
+static const uint64_t sha512_k[80] = {
+    0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f,
+    0xe9b5dba58189dbbc, 0x3956c25bf348b538, 0x59f111f1b605d019,
+    0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242,
+    0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+    0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
+    0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3,
+    0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65, 0x2de92c6f592b0275,
+    0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+    0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f,
+    0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+    0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc,
+    0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+    0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6,
+    0x92722c851482353b, 0xa2bfe8a14cf10364, 0xa81a664bbc423001,
+    0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218,
+    0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+    0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99,
+    0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb,
+    0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc,
+    0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+    0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915,
+    0xc67178f2e372532b, 0xca273eceea26619c, 0xd186b8c721c0c207,
+    0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba,
+    0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+    0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
+    0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a,
+    0x5fcb6fab3ad6faec, 0x6c44198c4a475817};
+
+static void sha512_compress(uint64_t state[8], const uint8_t *block) {
+  uint64_t w[80];
+  for (uint8_t i = 0; i < 16; i++) {
+    w[i] = load64_be(block + 8 * i);
+  }
+  for (uint8_t i = 16; i < 80; i++) {
+    const uint64_t s0 =
+        ROR64(w[i - 15], 1) ^ ROR64(w[i - 15], 8) ^ (w[i - 15] >> 7);
+    const uint64_t s1 =
+        ROR64(w[i - 2], 19) ^ ROR64(w[i - 2], 61) ^ (w[i - 2] >> 6);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint64_t a = state[0], b = state[1], c = state[2], d = state[3];
+  uint64_t e = state[4], f = state[5], g = state[6], h = state[7];
+  for (uint8_t i = 0; i < 80; i++) {
+    const uint64_t s1 = ROR64(e, 14) ^ ROR64(e, 18) ^ ROR64(e, 41);
+    const uint64_t t1 = h + s1 + ((e & f) ^ (~e & g)) + sha512_k[i] + w[i];
+    const uint64_t s0 = ROR64(a, 28) ^ ROR64(a, 34) ^ ROR64(a, 39);
+    const uint64_t t2 = s0 + ((a & b) ^ (a & c) ^ (b & c));
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+cx_err_t cx_sha512_init_no_throw(cx_sha512_t *hash) {
+  static const uint64_t iv[8] = {
+      0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b,
+      0xa54ff53a5f1d36f1, 0x510e527fade682d1, 0x9b05688c2b3e6c1f,
+      0x1f83d9abfb41bd6b, 0x5be0cd19137e2179};
+  if (hash == NULL) {
+    return CX_INVALID_PARAMETER;
+  }
+  memset(hash, 0, sizeof(*hash));
+  hash->header.algo = CX_SHA512;
+  memcpy(hash->state, iv, sizeof(iv));
+  return CX_OK;
+}
+
+static void sha512_update(cx_sha512_t *hash, const uint8_t *in, size_t len) {
+  size_t used = hash->length % SHA512_BLOCK_LEN;
+  hash->length += len;
+  while (len > 0) {
+    const size_t n =
+        len < SHA512_BLOCK_LEN - used ? len : SHA512_BLOCK_LEN - used;
+    memcpy(hash->block + used, in, n);
+    in += n;
+    len -= n;
+    used += n;
+    if (used == SHA512_BLOCK_LEN) {
+      sha512_compress(hash->state, hash->block);
+      used = 0;
+    }
+  }
+}
+
+static void sha512_final(cx_sha512_t *hash, uint8_t *out) {
+  // Lengths above 2^64 bits are not needed here, the high half stays zero
+  const uint64_t bits = hash->length * 8;
+  const size_t used = hash->length % SHA512_BLOCK_LEN;
+  uint8_t pad[SHA512_BLOCK_LEN + 16] = {0x80};
+  const size_t padLen = (used < 112 ? 112 : 240) - used;
+  store64_be(pad + padLen + 8, bits);
+  sha512_update(hash, pad, padLen + 16);
+  for (uint8_t i = 0; i < 8; i++) {
+    store64_be(out + 8 * i, hash->state[i]);
+  }
+  memset(hash, 0, sizeof(*hash));
+}
+
+/////////////////////////////////////////////
+// RIPEMD-160
+
+static const uint8_t ripemd_r[80] = {
+    0, 1, 2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15,
+    7, 4, 13, 1,  10, 6,  15, 3,  12, 0,  9,  5,  2,  14, 11, 8,
+    3, 10, 14, 4,  9,  15, 8,  1,  2,  7,  0,  6,  13, 11, 5,  12,
+    1, 9, 11, 10, 0,  8,  12, 4,  13, 3,  7,  15, 14, 5,  6,  2,
+    4, 0, 5,  9,  7,  12, 2,  10, 14, 1,  3,  8,  11, 6,  15, 13};
+static const uint8_t ripemd_rp[80] = {
+    5,  14, 7,  0, 9, 2,  11, 4,  13, 6,  15, 8,  1,  10, 3,  12,
+    6,  11, 3,  7, 0, 13, 5,  10, 14, 15, 8,  12, 4,  9,  1,  2,
+    15, 5,  1,  3, 7, 14, 6,  9,  11, 8,  12, 2,  10, 0,  4,  13,
+    8,  6,  4,  1, 3, 11, 15, 0,  5,  12, 2,  13, 9,  7,  10, 14,
+    12, 15, 10, 4, 1, 5,  8,  7,  6,  2,  13, 14, 0,  3,  9,  11};
+static const uint8_t ripemd_s[80] = {
+    11, 14, 15, 12, 5,  8,  7,  9,  11, 13, 14, 15, 6,  7,  9,  8,
+    7,  6,  8,  13, 11, 9,  7,  15, 7,  12, 15, 9,  11, 7,  13, 12,
+    11, 13, 6,  7,  14, 9,  13, 15, 14, 8,  13, 6,  5,  12, 7,  5,
+    11, 12, 14, 15, 14, 15, 9,  8,  9,  14, 5,  6,  8,  6,  5,  12,
+    9,  15, 5,  11, 6,  8,  13, 12, 5,  12, 13, 14, 11, 8,  5,  6};
+static const uint8_t ripemd_sp[80] = {
+    8,  9,  9,  11, 13, 15, 15, 5,  7,  7,  8,  11, 14, 14, 12, 6,
+    9,  13, 15, 7,  12, 8,  9,  11, 7,  7,  12, 7,  6,  15, 13, 11,
+    9,  7,  15, 11, 8,  6,  6,  14, 12, 13, 5,  14, 13, 13, 7,  5,
+    15, 5,  8,  11, 14, 14, 6,  14, 6,  9,  12, 9,  12, 5,  15, 8,
+    8,  5,  12, 9,  12, 5,  14, 6,  8,  13, 6,  5,  15, 13, 11, 11};
+static const uint32_t ripemd_k[5] = {0x00000000, 0x5a827999, 0x6ed9eba1,
+                                     0x8f1bbcdc, 0xa953fd4e};
+static const uint32_t ripemd_kp[5] = {0x50a28be6, 0x5c4dd124, 0x6d703ef3,
+                                      0x7a6d76e9, 0x00000000};
+
+static uint32_t ripemd_f(uint8_t round, uint32_t x, uint32_t y, uint32_t z) {
+  switch (round) {
+  case 0:
+    return x ^ y ^ z;
+  case 1:
+    return (x & y) | (~x & z);
+  case 2:
+    return (x | ~y) ^ z;
+  case 3:
+    return (x & z) | (y & ~z);
+  default:
+    return x ^ (y | ~z);
+  }
+}
+
+static void ripemd160_compress(uint32_t state[5], const uint8_t *block) {
+  uint32_t x[16];
+  for (uint8_t i = 0; i < 16; i++) {
+    x[i] = load32_le(block + 4 * i);
+  }
+
+  uint32_t al = state[0], bl = state[1], cl = state[2], dl = state[3],
+           el = state[4];
+  uint32_t ar = al, br = bl, cr = cl, dr = dl, er = el;
+  for (uint8_t j = 0; j < 80; j++) {
+    const uint8_t round = j / 16;
+    uint32_t t = al + ripemd_f(round, bl, cl, dl) + x[ripemd_r[j]] +
+                 ripemd_k[round];
+    t = ROL32(t, ripemd_s[j]) + el;
+    al = el;
+    el = dl;
+    dl = ROL32(cl, 10);
+    cl = bl;
+    bl = t;
+
+    t = ar + ripemd_f(4 - round, br, cr, dr) + x[ripemd_rp[j]] +
+        ripemd_kp[round];
+    t = ROL32(t, ripemd_sp[j]) + er;
+    ar = er;
+    er = dr;
+    dr = ROL32(cr, 10);
+    cr = br;
+    br = t;
+  }
+
+  const uint32_t t = state[1] + cl + dr;
+  state[1] = state[2] + dl + er;
+  state[2] = state[3] + el + ar;
+  state[3] = state[4] + al + br;
+  state[4] = state[0] + bl + cr;
+  state[0] = t;
+}
+
+cx_err_t cx_ripemd160_hash(const uint8_t *in, size_t len, uint8_t *out) {
+  if ((in == NULL && len > 0) || out == NULL) {
+    return CX_INVALID_PARAMETER;
+  }
+  uint32_t state[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476,
+                       0xc3d2e1f0};
+  const uint64_t bits = (uint64_t)len * 8;
+  for (; len >= 64; in += 64, len -= 64) {
+    ripemd160_compress(state, in);
+  }
+
+  uint8_t block[2 * 64] = {0};
+  memcpy(block, in, len);
+  block[len] = 0x80;
+  const size_t blocks = len < 56 ? 1 : 2;
+  store32_le(block + 64 * blocks - 8, (uint32_t)bits);
+  store32_le(block + 64 * blocks - 4, (uint32_t)(bits >> 32));
+  for (size_t i = 0; i < blocks; i++) {
+    ripemd160_compress(state, block + 64 * i);
+  }
+  for (uint8_t i = 0; i < 5; i++) {
+    store32_le(out + 4 * i, state[i]);
+  }
+  return CX_OK;
+}
+
+/////////////////////////////////////////////
+// Keccak, through tinykeccak
+
+cx_err_t cx_keccak_init_no_throw(cx_sha3_t *hash, size_t size) {
+  if (hash == NULL) {
+    return CX_INVALID_PARAMETER;
+  }
+  memset(hash, 0, sizeof(*hash));
+  hash->header.algo = CX_KECCAK;
+  if (keccak_init(&hash->ctx, (unsigned int)size) != zxerr_ok) {
+    return CX_INVALID_PARAMETER;
+  }
+  return CX_OK;
+}
+
+cx_err_t cx_keccak_256_hash(const uint8_t *in, size_t len, uint8_t *out) {
+  if ((in == NULL && len > 0) || out == NULL) {
+    return CX_INVALID_PARAMETER;
+  }
+  if (keccak_hash(in, (unsigned int)len, out, 32) != zxerr_ok) {
+    return CX_INTERNAL_ERROR;
+  }
+  return CX_OK;
+}
+
+/////////////////////////////////////////////
+
+cx_err_t cx_hash_no_throw(cx_hash_t *hash, uint32_t mode, const uint8_t *in,
+                          size_t len, uint8_t *out, size_t out_len) {
+  if (hash == NULL || (in == NULL && len > 0)) {
+    return CX_INVALID_PARAMETER;
+  }
+  const bool last = (mode & CX_LAST) != 0;
+
+  switch (hash->algo) {
+  case CX_SHA256: {
+    cx_sha256_t *sha256 = (cx_sha256_t *)hash;
+    if (last && (out == NULL || out_len < CX_SHA256_SIZE)) {
+      return CX_INVALID_PARAMETER;
+    }
+    sha256_update(sha256, in, len);
+    if (last) {
+      sha256_final(sha256, out);
+    }
+    return CX_OK;
+  }
+  case CX_SHA512: {
+    cx_sha512_t *sha512 = (cx_sha512_t *)hash;
+    if (last && (out == NULL || out_len < CX_SHA512_SIZE)) {
+      return CX_INVALID_PARAMETER;
+    }
+    sha512_update(sha512, in, len);
+    if (last) {
+      sha512_final(sha512, out);
+    }
+    return CX_OK;
+  }
+  case CX_KECCAK: {
+    cx_sha3_t *sha3 = (cx_sha3_t *)hash;
+    const size_t digestLen = (200u - sha3->ctx.rate) / 2u;
+    if (last && (out == NULL || out_len < digestLen)) {
+      return CX_INVALID_PARAMETER;
+    }
+    if (len > 0 &&
+        keccak_update(&sha3->ctx, in, (unsigned int)len) != zxerr_ok) {
+      return CX_INTERNAL_ERROR;
+    }
+    if (last && keccak_final(&sha3->ctx, out, (unsigned int)digestLen) !=
+                    zxerr_ok) {
+      return CX_INTERNAL_ERROR;
+    }
+    return CX_OK;
+  }
+  default:
+    return CX_INVALID_PARAMETER;
+  }
+}
+
+size_t cx_hash_sha256(const uint8_t *in, size_t len, uint8_t *out,
+                      size_t out_len) {
+  cx_sha256_t hash;
+  if (cx_sha256_init_no_throw(&hash) != CX_OK ||
+      cx_hash_no_throw(&hash.header, CX_LAST, in, len, out, out_len) !=
+          CX_OK) {
+    return 0;
+  }
+  return CX_SHA256_SIZE;
+}
+
+/////////////////////////////////////////////
+// HMAC, RFC 2104
+
+size_t cx_hmac_sha256(const uint8_t *key, size_t key_len, const uint8_t *in,
+                      size_t len, uint8_t *mac, size_t mac_len) {
+  if ((key == NULL && key_len > 0) || (in == NULL && len > 0) ||
+      mac == NULL || mac_len < CX_SHA256_SIZE) {
+    return 0;
+  }
+  uint8_t pad[SHA256_BLOCK_LEN] = {0};
+  if (key_len > SHA256_BLOCK_LEN) {
+    cx_hash_sha256(key, key_len, pad, sizeof(pad));
+  } else if (key_len > 0) {
+    memcpy(pad, key, key_len);
+  }
+
+  cx_sha256_t hash;
+  uint8_t inner[CX_SHA256_SIZE];
+  for (uint8_t i = 0; i < SHA256_BLOCK_LEN; i++) {
+    pad[i] ^= 0x36;
+  }
+  cx_sha256_init_no_throw(&hash);
+  sha256_update(&hash, pad, sizeof(pad));
+  sha256_update(&hash, in, len);
+  sha256_final(&hash, inner);
+
+  for (uint8_t i = 0; i < SHA256_BLOCK_LEN; i++) {
+    pad[i] ^= 0x36 ^ 0x5c;
+  }
+  cx_sha256_init_no_throw(&hash);
+  sha256_update(&hash, pad, sizeof(pad));
+  sha256_update(&hash, inner, sizeof(inner));
+  sha256_final(&hash, mac);
+
+  memset(pad, 0, sizeof(pad));
+  memset(inner, 0, sizeof(inner));
+  return CX_SHA256_SIZE;
+}
+
+size_t cx_hmac_sha512(const uint8_t *key, size_t key_len, const uint8_t *in,
+                      size_t len, uint8_t *mac, size_t mac_len) {
+  if ((key == NULL && key_len > 0) || (in == NULL && len > 0) ||
+      mac == NULL || mac_len < CX_SHA512_SIZE) {
+    return 0;
+  }
+  uint8_t pad[SHA512_BLOCK_LEN] = {0};
+  cx_sha512_t hash;
+  if (key_len > SHA512_BLOCK_LEN) {
+    cx_sha512_init_no_throw(&hash);
+    sha512_update(&hash, key, key_len);
+    sha512_final(&hash, pad);
+  } else if (key_len > 0) {
+    memcpy(pad, key, key_len);
+  }
+
+  uint8_t inner[CX_SHA512_SIZE];
+  for (uint8_t i = 0; i < SHA512_BLOCK_LEN; i++) {
+    pad[i] ^= 0x36;
+  }
+  cx_sha512_init_no_throw(&hash);
+  sha512_update(&hash, pad, sizeof(pad));
+  sha512_update(&hash, in, len);
+  sha512_final(&hash, inner);
+
+  for (uint8_t i = 0; i < SHA512_BLOCK_LEN; i++) {
+    pad[i] ^= 0x36 ^ 0x5c;
+  }
+  cx_sha512_init_no_throw(&hash);
+  sha512_update(&hash, pad, sizeof(pad));
+  sha512_update(&hash, inner, sizeof(inner));
+  sha512_final(&hash, mac);
+
+  memset(pad, 0, sizeof(pad));
+  memset(inner, 0, sizeof(inner));
+  return CX_SHA512_SIZE;
+}
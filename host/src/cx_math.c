@@ -0,0 +1,70 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "cx.h"
+
+cx_err_t cx_math_cmp_no_throw(const uint8_t *a, const uint8_t *b, size_t len,
+                              int *diff) {
+  if (a == NULL || b == NULL || diff == NULL) {
+    return CX_INVALID_PARAMETER;
+  }
+  *diff = 0;
+  for (size_t i = 0; i < len; i++) {
+    if (a[i] != b[i]) {
+      *diff = a[i] < b[i] ? -1 : 1;
+      break;
+    }
+  }
+  return CX_OK;
+}
+
+cx_err_t cx_math_is_zero_no_throw(const uint8_t *a, size_t len, bool *zero) {
+  if (a == NULL || zero == NULL) {
+    return CX_INVALID_PARAMETER;
+  }
+  uint8_t acc = 0;
+  for (size_t i = 0; i < len; i++) {
+    acc |= a[i];
+  }
+  *zero = acc == 0;
+  return CX_OK;
+}
+
+cx_err_t cx_math_addm_no_throw(uint8_t *r, const uint8_t *a, const uint8_t *b,
+                               const uint8_t *m, size_t len) {
+  if (r == NULL || a == NULL || b == NULL || m == NULL || len == 0) {
+    return CX_INVALID_PARAMETER;
+  }
+
+  uint16_t carry = 0;
+  for (size_t i = len; i > 0; i--) {
+    carry += (uint16_t)a[i - 1] + b[i - 1];
+    r[i - 1] = (uint8_t)carry;
+    carry >>= 8;
+  }
+
+  // Below 2m, one subtraction is enough
+  int diff = 0;
+  cx_math_cmp_no_throw(r, m, len, &diff);
+  if (carry != 0 || diff >= 0) {
+    int16_t borrow = 0;
+    for (size_t i = len; i > 0; i--) {
+      borrow += (int16_t)r[i - 1] - m[i - 1];
+      r[i - 1] = (uint8_t)borrow;
+      borrow = borrow < 0 ? -1 : 0;
+    }
+  }
+  return CX_OK;
+}
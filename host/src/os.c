@@ -0,0 +1,199 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#include "os.h"
+#include "host_crypto.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BIP32_HARDENED 0x80000000u
+#define BIP32_KEY_LEN 32u
+#define BIP39_ITERATIONS 2048u
+#define BIP39_SALT_MAX_LEN 256u
+
+uint8_t G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+
+static try_context_t *try_context = NULL;
+
+static uint8_t host_seed[HOST_SEED_LEN];
+static size_t host_seed_len = 0;
+
+static const uint8_t secp256k1_order[BIP32_KEY_LEN] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xBA, 0xAE, 0xDC, 0xE6, 0xAF, 0x48,
+    0xA0, 0x3B, 0xBF, 0xD2, 0x5E, 0x8C, 0xD0, 0x36, 0x41, 0x41};
+
+static bool locked = false;
+
+bolos_bool_t os_global_pin_is_validated(void) {
+  return locked ? BOLOS_FALSE : BOLOS_TRUE;
+}
+
+void host_os_set_locked(bool lock) { locked = lock; }
+
+try_context_t *try_context_get(void) { return try_context; }
+
+try_context_t *try_context_set(try_context_t *context) {
+  try_context_t *previous = try_context;
+  try_context = context;
+  return previous;
+}
+
+void os_longjmp(unsigned int exception) {
+  if (try_context == NULL) {
+    fprintf(stderr, "uncaught exception 0x%04X\n", exception);
+    abort();
+  }
+  longjmp(try_context->jmp_buf, (int)exception);
+}
+
+// PBKDF2 with HMAC-SHA512, a single block of output
+void host_crypto_mnemonic_to_seed(const char *mnemonic,
+                                  const char *passphrase,
+                                  uint8_t seed[HOST_SEED_LEN]) {
+  static const char prefix[] = "mnemonic";
+  uint8_t salt[sizeof(prefix) - 1 + BIP39_SALT_MAX_LEN + 4] = {0};
+  size_t saltLen = sizeof(prefix) - 1;
+  memcpy(salt, prefix, saltLen);
+  if (passphrase != NULL) {
+    const size_t len = strnlen(passphrase, BIP39_SALT_MAX_LEN);
+    memcpy(salt + saltLen, passphrase, len);
+    saltLen += len;
+  }
+  // Block index 1
+  salt[saltLen + 3] = 1;
+  saltLen += 4;
+
+  const size_t mnemonicLen = strlen(mnemonic);
+  uint8_t u[CX_SHA512_SIZE];
+  cx_hmac_sha512((const uint8_t *)mnemonic, mnemonicLen, salt, saltLen, u,
+                 sizeof(u));
+  memcpy(seed, u, sizeof(u));
+  for (uint32_t i = 1; i < BIP39_ITERATIONS; i++) {
+    cx_hmac_sha512((const uint8_t *)mnemonic, mnemonicLen, u, sizeof(u), u,
+                   sizeof(u));
+    for (uint8_t j = 0; j < sizeof(u); j++) {
+      seed[j] ^= u[j];
+    }
+  }
+  memset(u, 0, sizeof(u));
+}
+
+void host_crypto_set_seed(const uint8_t *seed, size_t seedLen) {
+  memset(host_seed, 0, sizeof(host_seed));
+  host_seed_len = 0;
+  if (seed == NULL || seedLen == 0 || seedLen > sizeof(host_seed)) {
+    return;
+  }
+  memcpy(host_seed, seed, seedLen);
+  host_seed_len = seedLen;
+}
+
+static void host_default_seed() {
+  if (host_seed_len == 0) {
+    host_crypto_mnemonic_to_seed(HOST_TEST_MNEMONIC, "", host_seed);
+    host_seed_len = sizeof(host_seed);
+  }
+}
+
+// Child of a private key, CKDpriv in BIP32
+static cx_err_t derive_child(uint8_t key[BIP32_KEY_LEN],
+                             uint8_t chainCode[BIP32_KEY_LEN],
+                             uint32_t index) {
+  uint8_t data[1 + BIP32_KEY_LEN + sizeof(uint32_t)] = {0};
+  uint8_t digest[CX_SHA512_SIZE];
+
+  if ((index & BIP32_HARDENED) != 0) {
+    memcpy(data + 1, key, BIP32_KEY_LEN);
+  } else {
+    cx_ecfp_private_key_t privateKey;
+    cx_ecfp_public_key_t publicKey;
+    cx_err_t err = cx_ecfp_init_private_key_no_throw(
+        CX_CURVE_256K1, key, BIP32_KEY_LEN, &privateKey);
+    if (err == CX_OK) {
+      err = cx_ecfp_generate_pair_no_throw(CX_CURVE_256K1, &publicKey,
+                                           &privateKey, true);
+    }
+    memset(&privateKey, 0, sizeof(privateKey));
+    if (err != CX_OK) {
+      return err;
+    }
+    data[0] = 0x02 | (publicKey.W[64] & 1u);
+    memcpy(data + 1, publicKey.W + 1, BIP32_KEY_LEN);
+  }
+  data[33] = (uint8_t)(index >> 24);
+  data[34] = (uint8_t)(index >> 16);
+  data[35] = (uint8_t)(index >> 8);
+  data[36] = (uint8_t)index;
+
+  cx_hmac_sha512(chainCode, BIP32_KEY_LEN, data, sizeof(data), digest,
+                 sizeof(digest));
+  memset(data, 0, sizeof(data));
+
+  // A left half above the order or a zero key is not expected in practice,
+  // BIP32 moves on to the next index and so would the caller
+  int diff = 0;
+  bool zero = false;
+  cx_math_cmp_no_throw(digest, secp256k1_order, BIP32_KEY_LEN, &diff);
+  if (diff >= 0) {
+    memset(digest, 0, sizeof(digest));
+    return CX_INTERNAL_ERROR;
+  }
+  cx_math_addm_no_throw(key, digest, key, secp256k1_order, BIP32_KEY_LEN);
+  cx_math_is_zero_no_throw(key, BIP32_KEY_LEN, &zero);
+  memcpy(chainCode, digest + BIP32_KEY_LEN, BIP32_KEY_LEN);
+  memset(digest, 0, sizeof(digest));
+  return zero ? CX_INTERNAL_ERROR : CX_OK;
+}
+
+cx_err_t os_derive_bip32_with_seed_no_throw(unsigned int derivation_mode,
+                                            cx_curve_t curve,
+                                            const uint32_t *path,
+                                            size_t path_len,
+                                            uint8_t raw_privkey[64],
+                                            uint8_t *chain_code,
+                                            unsigned char *seed,
+                                            size_t seed_len) {
+  if (derivation_mode != HDW_NORMAL || curve != CX_CURVE_256K1 ||
+      raw_privkey == NULL || (path == NULL && path_len > 0)) {
+    return CX_INVALID_PARAMETER;
+  }
+  if (seed == NULL) {
+    host_default_seed();
+    seed = host_seed;
+    seed_len = host_seed_len;
+  }
+
+  static const char masterKey[] = "Bitcoin seed";
+  uint8_t digest[CX_SHA512_SIZE];
+  cx_hmac_sha512((const uint8_t *)masterKey, sizeof(masterKey) - 1, seed,
+                 seed_len, digest, sizeof(digest));
+
+  cx_err_t err = CX_OK;
+  for (size_t i = 0; i < path_len && err == CX_OK; i++) {
+    err = derive_child(digest, digest + BIP32_KEY_LEN, path[i]);
+  }
+  if (err == CX_OK) {
+    memset(raw_privkey, 0, 64);
+    memcpy(raw_privkey, digest, BIP32_KEY_LEN);
+    if (chain_code != NULL) {
+      memcpy(chain_code, digest + BIP32_KEY_LEN, BIP32_KEY_LEN);
+    }
+  }
+  memset(digest, 0, sizeof(digest));
+  return err;
+}
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""
+Generates app/src/chain_config_table.h, the registry of supported chains.
+
+To support a new chain, add an entry to CHAINS and run this script from the
+repository root. Lookups by HRP and by chain id use perfect hash tables, so
+the seeds are searched here and the generated file must never be edited.
+"""
+
+import os
+
+# coin type, hrp, encoding, chain id, ticker, expert ticker, decimals, default
+# Chains without a chain id are only used for address derivation.
+CHAINS = [
+    (118, 'cosmos', 'BECH32_COSMOS', 'cosmoshub-4', 'ATOM', 'uatom', 6, True),
+    (60, 'inj', 'BECH32_ETH', None, None, None, 0, False),
+    (60, 'evmos', 'BECH32_ETH', None, None, None, 0, False),
+    (60, 'xpla', 'BECH32_ETH', None, None, None, 0, False),
+    (60, 'dym', 'BECH32_ETH', None, None, None, 0, False),
+    (60, 'zeta', 'BECH32_ETH', None, None, None, 0, False),
+    (60, 'bera', 'BECH32_ETH', None, None, None, 0, False),
+    (60, 'human', 'BECH32_ETH', None, None, None, 0, False),
+    (118, 'osmo', 'BECH32_COSMOS', 'osmosis-1', 'OSMO', 'uosmo', 6, False),
+    (118, 'dydx', 'BECH32_COSMOS', 'dydx-mainnet-1', 'DYDX', 'adydx', 18, False),
+    (118, 'mantra', 'BECH32_COSMOS', 'mantra-1', 'OM', 'uom', 6, False),
+    (118, 'xion', 'BECH32_COSMOS', 'xion-mainnet-1', 'XION', 'uxion', 6, False),
+    (118, 'celestia', 'BECH32_COSMOS', 'celestia', 'TIA', 'utia', 6, False),
+    (118, 'core', 'BECH32_COSMOS', None, None, None, 0, False),
+    (118, 'neutron', 'BECH32_COSMOS', None, None, None, 0, False),
+]
+
+# Must match MAX_BECH32_HRP_LEN and COIN_MAX_CHAINID_LEN
+MAX_HRP_LEN = 83
+MAX_CHAINID_LEN = 20
+
+OUTPUT = os.path.join('app', 'src', 'chain_config_table.h')
+
+HEADER = '''/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+// Generated by scripts/gen_chain_config.py. Do not edit.
+#pragma once
+
+#include "chain_config.h"
+'''
+
+
+def chain_hash(seed, key):
+    """Same as chain_config_hash in app/src/chain_config.c"""
+    h = (0x811C9DC5 ^ seed) & 0xFFFFFFFF
+    for b in key:
+        h ^= b
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    return h ^ (h >> 16)
+
+
+def build_slots(keys):
+    """Finds a seed that sends every key to its own slot"""
+    size = 1
+    while size < 2 * len(keys):
+        size *= 2
+    for seed in range(1 << 20):
+        slots = [0] * size
+        for idx, key in keys:
+            slot = chain_hash(seed, key) & (size - 1)
+            if slots[slot] != 0:
+                break
+            slots[slot] = idx + 1
+        else:
+            return seed, slots
+    raise RuntimeError('no perfect hash seed found')
+
+
+def bech32_hrp_state(hrp):
+    """Same as bech32_hrp_state in app/src/bech32/bech32_codec.c"""
+    gen = [0x3B6A57B2, 0x26508E6D, 0x1EA119FA, 0x3D4233DD, 0x2A1462B3]
+    chk = 1
+    for value in [ord(c) >> 5 for c in hrp] + [0] + [ord(c) & 31 for c in hrp]:
+        top = chk >> 25
+        chk = ((chk & 0x1FFFFFF) << 5) ^ value
+        for i in range(5):
+            if (top >> i) & 1:
+                chk ^= gen[i]
+    return chk
+
+
+def c_str(value):
+    return 'NULL' if value is None else f'"{value}"'
+
+
+def c_slots(name, slots):
+    values = ', '.join(str(s) for s in slots)
+    return f'static const uint8_t {name}[{len(slots)}] = {{{values}}};\n'
+
+
+def main():
+    hrps = [c[1] for c in CHAINS]
+    chain_ids = [c[3] for c in CHAINS if c[3] is not None]
+    assert len(set(hrps)) == len(hrps), 'duplicated hrp'
+    assert len(set(chain_ids)) == len(chain_ids), 'duplicated chain id'
+    assert sum(1 for c in CHAINS if c[7]) == 1, 'exactly one default chain'
+    assert all(c[3] is not None for c in CHAINS if c[7]), 'default chain id'
+    assert len(CHAINS) < 255
+    for c in CHAINS:
+        assert 0 < len(c[1]) <= MAX_HRP_LEN, c[1]
+        assert c[3] is None or 0 < len(c[3]) < MAX_CHAINID_LEN, c[3]
+        assert (c[3] is None) == (c[4] is None) == (c[5] is None), c[1]
+
+    hrp_seed, hrp_slots = build_slots(
+        [(i, c[1].encode()) for i, c in enumerate(CHAINS)])
+    chain_id_seed, chain_id_slots = build_slots(
+        [(i, c[3].encode()) for i, c in enumerate(CHAINS) if c[3] is not None])
+
+    out = HEADER
+    out += f'\n#define CHAIN_CONFIG_HRP_SEED {hrp_seed}u\n'
+    out += f'#define CHAIN_CONFIG_HRP_SLOTS {len(hrp_slots)}u\n'
+    out += f'#define CHAIN_CONFIG_CHAINID_SEED {chain_id_seed}u\n'
+    out += f'#define CHAIN_CONFIG_CHAINID_SLOTS {len(chain_id_slots)}u\n'
+    default_idx = next(i for i, c in enumerate(CHAINS) if c[7])
+    out += f'#define CHAIN_CONFIG_DEFAULT_IDX {default_idx}u\n\n'
+
+    out += 'static const chain_info_t chainConfig[] = {\n'
+    for coin_type, hrp, enc, chain_id, ticker, expert, decimals, default in CHAINS:
+        out += (f'    {{{coin_type}, "{hrp}", {len(hrp)}, '
+                f'0x{bech32_hrp_state(hrp):08X}u, {enc}, '
+                f'{c_str(chain_id)}, {c_str(ticker)}, {c_str(expert)}, '
+                f'{decimals}, {"true" if default else "false"}}},\n')
+    out += '};\n\n'
+
+    out += '// Slot -> chainConfig index + 1, zero for empty slots\n'
+    out += c_slots('chainConfigHrpSlots', hrp_slots)
+    out += c_slots('chainConfigChainIdSlots', chain_id_slots)
+
+    with open(OUTPUT, 'w') as f:
+        f.write(out)
+
+
+if __name__ == '__main__':
+    main()
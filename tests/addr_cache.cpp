@@ -0,0 +1,100 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "gtest/gtest.h"
+#include <addr_cache.h>
+#include <string>
+
+namespace {
+const uint32_t kPath[HDPATH_LEN_DEFAULT] = {0x8000002C, 0x80000076,
+                                            0x80000000, 0, 0};
+const uint8_t kPubkey[ADDR_CACHE_PUBKEY_LEN] = {0x02, 0x11, 0x22};
+const std::string kAddr = "cosmos1wkd9tfm5pqvhhaxq77wv9tvjcsazuaykwsld65";
+
+void store(addr_cache_t *cache, const uint32_t *path, const char *hrp,
+           uint8_t encoding, const std::string &addr) {
+  addr_cache_store(cache, path, HDPATH_LEN_DEFAULT, hrp, encoding, kPubkey,
+                   addr.data(), addr.size());
+}
+
+TEST(AddrCache, FindsByPathHrpAndEncoding) {
+  addr_cache_t cache = {};
+  EXPECT_EQ(addr_cache_find(&cache, kPath, HDPATH_LEN_DEFAULT, "cosmos", 0),
+            nullptr);
+
+  store(&cache, kPath, "cosmos", 0, kAddr);
+  const addr_cache_entry_t *entry =
+      addr_cache_find(&cache, kPath, HDPATH_LEN_DEFAULT, "cosmos", 0);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(std::string(entry->addr, entry->addrLen), kAddr);
+  EXPECT_EQ(entry->pubkey[1], 0x11);
+
+  uint32_t account[HDPATH_LEN_DEFAULT] = {0x8000002C, 0x80000076, 0x80000001,
+                                          0, 0};
+  EXPECT_EQ(addr_cache_find(&cache, account, HDPATH_LEN_DEFAULT, "cosmos", 0),
+            nullptr);
+  EXPECT_EQ(addr_cache_find(&cache, kPath, HDPATH_LEN_DEFAULT, "cosmo", 0),
+            nullptr);
+  EXPECT_EQ(addr_cache_find(&cache, kPath, HDPATH_LEN_DEFAULT, "cosmoss", 0),
+            nullptr);
+  EXPECT_EQ(addr_cache_find(&cache, kPath, HDPATH_LEN_DEFAULT, "cosmos", 1),
+            nullptr);
+  EXPECT_EQ(addr_cache_find(&cache, kPath, HDPATH_LEN_DEFAULT - 1, "cosmos",
+                            0),
+            nullptr);
+
+  addr_cache_clear(&cache);
+  EXPECT_EQ(addr_cache_find(&cache, kPath, HDPATH_LEN_DEFAULT, "cosmos", 0),
+            nullptr);
+}
+
+TEST(AddrCache, ReplacesOldestEntry) {
+  addr_cache_t cache = {};
+  uint32_t paths[ADDR_CACHE_ENTRIES + 1][HDPATH_LEN_DEFAULT] = {};
+  for (uint32_t i = 0; i <= ADDR_CACHE_ENTRIES; i++) {
+    paths[i][2] = 0x80000000 | i;
+    store(&cache, paths[i], "cosmos", 0, kAddr);
+  }
+
+  EXPECT_EQ(addr_cache_find(&cache, paths[0], HDPATH_LEN_DEFAULT, "cosmos", 0),
+            nullptr);
+  for (uint32_t i = 1; i <= ADDR_CACHE_ENTRIES; i++) {
+    EXPECT_NE(
+        addr_cache_find(&cache, paths[i], HDPATH_LEN_DEFAULT, "cosmos", 0),
+        nullptr)
+        << i;
+  }
+
+  // Storing again what is cached does not take an entry
+  store(&cache, paths[1], "cosmos", 0, kAddr);
+  EXPECT_NE(addr_cache_find(&cache, paths[2], HDPATH_LEN_DEFAULT, "cosmos", 0),
+            nullptr);
+}
+
+TEST(AddrCache, SkipsWhatDoesNotFit) {
+  addr_cache_t cache = {};
+  const std::string longHrp(ADDR_CACHE_HRP_SIZE, 'a');
+  store(&cache, kPath, longHrp.c_str(), 0, kAddr);
+  EXPECT_EQ(addr_cache_find(&cache, kPath, HDPATH_LEN_DEFAULT,
+                            longHrp.c_str(), 0),
+            nullptr);
+
+  const std::string longAddr(ADDR_CACHE_ADDR_SIZE, 'q');
+  store(&cache, kPath, "cosmos", 0, longAddr);
+  EXPECT_EQ(addr_cache_find(&cache, kPath, HDPATH_LEN_DEFAULT, "cosmos", 0),
+            nullptr);
+}
+} // namespace
@@ -0,0 +1,89 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "gtest/gtest.h"
+#include <host_crypto.h>
+#include <os.h>
+#include <sim_device.h>
+#include <string>
+#include <vector>
+
+namespace {
+// INS_GET_ADDR_SECP256K1 of m/44'/118'/5'/0/3 with HRP cosmos, not shown
+const std::vector<uint8_t> kGetAddr = {
+    0x55, 0x04, 0x00, 0x00, 0x1b, 0x06, 0x63, 0x6f, 0x73, 0x6d, 0x6f, 0x73,
+    0x2c, 0x00, 0x00, 0x80, 0x76, 0x00, 0x00, 0x80, 0x05, 0x00, 0x00, 0x80,
+    0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00};
+const std::string kOk("\x90\x00", 2);
+const std::string kNotAllowed("\x69\x86", 2);
+
+std::string exchange(const std::vector<uint8_t> &apdu) {
+  uint8_t reply[SIM_REPLY_SIZE];
+  uint16_t replyLen = 0;
+  EXPECT_EQ(sim_exchange(apdu.data(), (uint16_t)apdu.size(), reply, &replyLen),
+            zxerr_ok);
+  return std::string(reinterpret_cast<const char *>(reply), replyLen);
+}
+
+// Keys now come from the seed of another passphrase, as after unlocking with
+// a PIN tied to it
+void switchSeed() {
+  uint8_t seed[HOST_SEED_LEN];
+  host_crypto_mnemonic_to_seed(HOST_TEST_MNEMONIC, "second", seed);
+  host_crypto_set_seed(seed, sizeof(seed));
+}
+
+class ApduHandler : public ::testing::Test {
+protected:
+  void SetUp() override { sim_reset(); }
+  void TearDown() override {
+    host_crypto_set_seed(nullptr, 0);
+    sim_reset();
+  }
+};
+
+TEST_F(ApduHandler, LockBetweenRequestsClearsAddressCache) {
+  const std::string first = exchange(kGetAddr);
+  ASSERT_EQ(first.substr(first.size() - 2), kOk);
+
+  // Without a lock, the address is served from the cache
+  switchSeed();
+  EXPECT_EQ(exchange(kGetAddr), first);
+
+  // Locked and unlocked again before the next request
+  host_os_set_locked(true);
+  sim_tick();
+  host_os_set_locked(false);
+  const std::string second = exchange(kGetAddr);
+  EXPECT_NE(second, first);
+
+  sim_reset();
+  EXPECT_EQ(exchange(kGetAddr), second);
+}
+
+TEST_F(ApduHandler, RequestWhileLockedClearsAddressCache) {
+  const std::string first = exchange(kGetAddr);
+  switchSeed();
+
+  host_os_set_locked(true);
+  EXPECT_EQ(exchange(kGetAddr), kNotAllowed);
+  host_os_set_locked(false);
+
+  const std::string second = exchange(kGetAddr);
+  EXPECT_NE(second, first);
+  EXPECT_EQ(second.substr(second.size() - 2), kOk);
+}
+} // namespace
@@ -0,0 +1,155 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// Replays the APDU sessions of tests/apdu_sessions against the host build of
+// handleApdu. Replies must match the saved ones, and the number of times each
+// stage runs must match tests/apdu_sessions/baseline.json.
+//
+// zemu_*.jsonl sessions were recorded from the emulator and catch the host
+// build diverging from the device. host_*.jsonl sessions are fixtures
+// generated on the host from the requests of the Zemu suites: they only
+// check the host build against its own earlier replies.
+//
+// APDU_REPLAY_UPDATE=1 rewrites the baselines from the current build.
+// APDU_REPLAY_TIME_FACTOR=<f> also fails sessions that take more than f times
+// their baseline time. Times depend on the host and build, so this is off by
+// default.
+
+#include "apdu_session.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+namespace {
+const std::string kSessionsDir =
+    std::string(TESTVECTORS_DIR) + "apdu_sessions/";
+const std::string kBaselineFile = kSessionsDir + "baseline.json";
+const char kExtension[] = ".jsonl";
+
+std::vector<std::string> GetSessions() {
+  std::vector<std::string> sessions;
+  DIR *dir = opendir(kSessionsDir.c_str());
+  if (dir == nullptr) {
+    return sessions;
+  }
+  const size_t extLen = sizeof(kExtension) - 1;
+  for (struct dirent *entry = readdir(dir); entry != nullptr;
+       entry = readdir(dir)) {
+    const std::string name = entry->d_name;
+    if (name.size() > extLen &&
+        name.compare(name.size() - extLen, extLen, kExtension) == 0) {
+      sessions.push_back(name.substr(0, name.size() - extLen));
+    }
+  }
+  closedir(dir);
+  std::sort(sessions.begin(), sessions.end());
+  return sessions;
+}
+
+bool updating() { return getenv("APDU_REPLAY_UPDATE") != nullptr; }
+
+class ApduReplay : public ::testing::TestWithParam<std::string> {
+public:
+  static void SetUpTestSuite() {
+    std::ifstream in(kBaselineFile);
+    baselines = in.is_open() ? nlohmann::json::parse(in, nullptr, false)
+                             : nlohmann::json::object();
+    if (baselines.is_discarded()) {
+      baselines = nlohmann::json::object();
+    }
+  }
+
+  static void TearDownTestSuite() {
+    if (updating()) {
+      std::ofstream out(kBaselineFile);
+      out << baselines.dump(2) << std::endl;
+    }
+  }
+
+  static nlohmann::json baselines;
+};
+
+nlohmann::json ApduReplay::baselines;
+
+nlohmann::json counters(const ReplayResult &result) {
+  nlohmann::json calls = nlohmann::json::object();
+  nlohmann::json us = nlohmann::json::object();
+  for (int s = 0; s < STAGE_COUNT; s++) {
+    calls[stage_name((stage_e)s)] = result.stages.calls[s];
+    us[stage_name((stage_e)s)] = result.stages.ns[s] / 1000;
+  }
+  us["total"] = result.totalNs / 1000;
+  return {{"calls", calls}, {"us", us}};
+}
+
+TEST_P(ApduReplay, MatchesRecording) {
+  const std::string session = GetParam();
+  std::vector<ApduStep> steps;
+  std::string source;
+  std::string error;
+  ASSERT_TRUE(loadSession(kSessionsDir + session + kExtension, &steps, &source,
+                          &error))
+      << error;
+  ASSERT_TRUE(source == "zemu" || source == "host")
+      << "sessions must name the source of their replies";
+  ASSERT_EQ(session.compare(0, source.size() + 1, source + "_"), 0)
+      << "file name does not match source " << source;
+  RecordProperty("source", source);
+
+  ReplayResult result;
+  replaySession(steps, &result);
+
+  size_t exchange = 0;
+  for (const auto &step : steps) {
+    if (step.setsExpert) {
+      continue;
+    }
+    if (!step.reply.empty()) {
+      EXPECT_EQ(toHex(result.replies[exchange]), toHex(step.reply))
+          << "exchange " << exchange << ": " << toHex(step.apdu);
+    }
+    exchange++;
+  }
+
+  const nlohmann::json current = counters(result);
+  if (updating()) {
+    baselines[session] = current;
+    return;
+  }
+  ASSERT_TRUE(baselines.contains(session))
+      << "no baseline, run with APDU_REPLAY_UPDATE=1";
+  const nlohmann::json &baseline = baselines[session];
+  EXPECT_EQ(current["calls"], baseline["calls"]);
+
+  const char *factor = getenv("APDU_REPLAY_TIME_FACTOR");
+  if (factor != nullptr) {
+    EXPECT_LE(current["us"]["total"].get<double>(),
+              baseline["us"]["total"].get<double>() * atof(factor))
+        << current["us"].dump();
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P( // NOLINT(cert-err58-cpp)
+    Sessions, ApduReplay, ::testing::ValuesIn(GetSessions()),
+    [](const ::testing::TestParamInfo<std::string> &info) {
+      return info.param;
+    });
+} // namespace
@@ -0,0 +1,144 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "app_mode.h"
+#include "gtest/gtest.h"
+#include <bech32/bech32_codec.h>
+#include <chain_config_table.h>
+#include <common/parser.h>
+#include <string>
+#include <vector>
+
+namespace {
+bool verify(const std::string &addr) {
+  return bech32_verify(addr.data(), addr.size());
+}
+
+// Bit by bit BIP173 polymod over the expanded hrp
+uint32_t referenceHrpState(const std::string &hrp) {
+  const uint32_t gen[5] = {0x3B6A57B2, 0x26508E6D, 0x1EA119FA, 0x3D4233DD,
+                           0x2A1462B3};
+  std::vector<uint8_t> values;
+  for (char c : hrp) {
+    values.push_back((uint8_t)c >> 5);
+  }
+  values.push_back(0);
+  for (char c : hrp) {
+    values.push_back((uint8_t)c & 31);
+  }
+  uint32_t chk = 1;
+  for (uint8_t v : values) {
+    const uint32_t top = chk >> 25;
+    chk = ((chk & 0x1FFFFFF) << 5) ^ v;
+    for (int i = 0; i < 5; i++) {
+      chk ^= ((top >> i) & 1) ? gen[i] : 0;
+    }
+  }
+  return chk;
+}
+
+TEST(Bech32Codec, Bip173Vectors) {
+  EXPECT_TRUE(verify("A12UEL5L"));
+  EXPECT_TRUE(verify("a12uel5l"));
+  EXPECT_TRUE(verify("an83characterlonghumanreadablepartthatcontainsthenumber1"
+                     "andtheexcludedcharactersbio1tt5tgs"));
+  EXPECT_TRUE(verify("abcdef1qpzry9x8gf2tvdw0s3jn54khce6mua7lmqqqxw"));
+  EXPECT_TRUE(verify("11" + std::string(82, 'q') + "c8247j"));
+  EXPECT_TRUE(
+      verify("split1checkupstagehandshakeupstreamerranterredcaperred2y9e3w"));
+  EXPECT_TRUE(verify("?1ezyfcl"));
+
+  // Length over 90, no separator, empty hrp, bad charset, short checksum,
+  // mixed case and a checksum over the uppercase hrp
+  EXPECT_FALSE(verify("an84characterslonghumanreadablepartthatcontainsthenumber"
+                      "1andtheexcludedcharactersbio1569pvx"));
+  EXPECT_FALSE(verify("pzry9x0s0muk"));
+  EXPECT_FALSE(verify("1pzry9x0s0muk"));
+  EXPECT_FALSE(verify("x1b4n0q5v"));
+  EXPECT_FALSE(verify("li1dgmt3"));
+  EXPECT_FALSE(verify("A12uEL5L"));
+  EXPECT_FALSE(verify("A1G7SGD8"));
+  EXPECT_FALSE(verify(std::string("a12uel5l\x7F", 9)));
+  EXPECT_FALSE(verify("cosmosaccaddr1d9h8xxxGRANTER"));
+}
+
+TEST(Bech32Codec, RegisteredHrpStates) {
+  for (const chain_info_t &chain : chainConfig) {
+    EXPECT_EQ(chain.hrpChecksum, referenceHrpState(chain.hrp)) << chain.hrp;
+  }
+}
+
+TEST(Bech32Codec, EncodeDecodeRoundTrip) {
+  const std::string addr = "cosmos1wkd9tfm5pqvhhaxq77wv9tvjcsazuaykwsld65";
+  uint8_t data[40];
+  size_t hrpLen = 0;
+  size_t dataLen = 0;
+  ASSERT_EQ(bech32_decode(addr.data(), addr.size(), &hrpLen, data,
+                          sizeof(data), &dataLen),
+            zxerr_ok);
+  EXPECT_EQ(hrpLen, 6u);
+  ASSERT_EQ(dataLen, 20u);
+
+  // Registered hrps use the generated state, others compute it
+  char out[BECH32_MAX_LEN + 1];
+  for (const char *hrp : {"cosmos", "osmo", "inj", "cosmosvaloper"}) {
+    ASSERT_EQ(bech32_encode(out, sizeof(out), hrp, strlen(hrp), data, dataLen),
+              zxerr_ok);
+    EXPECT_TRUE(verify(out)) << out;
+    EXPECT_EQ(std::string(out).substr(strlen(hrp) + 1, 32),
+              addr.substr(7, 32));
+  }
+  ASSERT_EQ(bech32_encode(out, sizeof(out), "cosmos", 6, data, dataLen),
+            zxerr_ok);
+  EXPECT_EQ(out, addr);
+
+  EXPECT_EQ(bech32_encode(out, addr.size(), "cosmos", 6, data, dataLen),
+            zxerr_buffer_too_small);
+  EXPECT_EQ(bech32_encode(out, sizeof(out), "Cosmos", 6, data, dataLen),
+            zxerr_invalid_crypto_settings);
+  EXPECT_EQ(bech32_decode(addr.data(), addr.size(), &hrpLen, data, 19,
+                          &dataLen),
+            zxerr_buffer_too_small);
+}
+
+TEST(Bech32Codec, IndexingRejectsBadChecksum) {
+  app_mode_set_expert(false);
+  const std::string prefix =
+      R"({"account_number":"0","chain_id":"cosmoshub-4","fee":{"amount":[],)"
+      R"("gas":"200000"},"memo":"","msgs":[{"type":"cosmos-sdk/MsgSend",)"
+      R"("value":{"amount":[{"amount":"10","denom":"uatom"}],)"
+      R"("from_address":"cosmos1wkd9tfm5pqvhhaxq77wv9tvjcsazuaykwsld65",)"
+      R"("to_address":")";
+  const std::string suffix = R"("}}],"sequence":"1"})";
+
+  for (const auto &test : std::vector<std::pair<std::string, parser_error_t>>{
+           {"cosmos1wkd9tfm5pqvhhaxq77wv9tvjcsazuaykwsld65", parser_ok},
+           {"cosmos1wkd9tfm5pqvhhaxq77wv9tvjcsazuaykwsld66",
+            parser_invalid_address},
+           {"cosmos1from", parser_invalid_address},
+       }) {
+    const std::string tx = prefix + test.first + suffix;
+    parser_context_t ctx;
+    parser_tx_t tx_obj;
+    MEMZERO(&tx_obj, sizeof(tx_obj));
+    tx_obj.tx_type = tx_json;
+    ASSERT_EQ(parser_parse(&ctx, (const uint8_t *)tx.data(), tx.size(),
+                           &tx_obj),
+              parser_ok);
+    EXPECT_EQ(parser_validate(&ctx), test.second) << test.first;
+  }
+}
+} // namespace
@@ -0,0 +1,85 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "chain_config.h"
+#include "coin.h"
+#include "gtest/gtest.h"
+#include <cstring>
+
+namespace {
+address_encoding_e check(uint32_t coinType, const char *hrp) {
+  return checkChainConfig(0x80000000u | coinType, hrp, strlen(hrp));
+}
+
+const chain_info_t *by_chain_id(const char *chainId) {
+  return chain_config_by_chain_id(chainId, strlen(chainId));
+}
+
+TEST(ChainConfig, AddressEncoding) {
+  EXPECT_EQ(check(118, "cosmos"), BECH32_COSMOS);
+  EXPECT_EQ(check(118, "osmo"), BECH32_COSMOS);
+  EXPECT_EQ(check(118, "neutron"), BECH32_COSMOS);
+  EXPECT_EQ(check(60, "inj"), BECH32_ETH);
+  EXPECT_EQ(check(60, "human"), BECH32_ETH);
+
+  // Wrong coin type, unknown hrp or partial matches
+  EXPECT_EQ(check(60, "cosmos"), UNSUPPORTED);
+  EXPECT_EQ(check(118, "inj"), UNSUPPORTED);
+  EXPECT_EQ(check(118, "cosmo"), UNSUPPORTED);
+  EXPECT_EQ(check(118, "cosmoss"), UNSUPPORTED);
+  EXPECT_EQ(check(118, "terra"), UNSUPPORTED);
+  EXPECT_EQ(checkChainConfig(0x80000076u, "cosmos", 0), UNSUPPORTED);
+  EXPECT_EQ(checkChainConfig(0x80000076u, nullptr, 6), UNSUPPORTED);
+  // The coin type must be hardened
+  EXPECT_EQ(checkChainConfig(118, "cosmos", 6), UNSUPPORTED);
+}
+
+TEST(ChainConfig, ChainId) {
+  const chain_info_t *chain = by_chain_id("cosmoshub-4");
+  ASSERT_NE(chain, nullptr);
+  EXPECT_TRUE(chain->isDefault);
+  EXPECT_EQ(chain, chain_config_default());
+  EXPECT_STREQ(chain->hrp, "cosmos");
+  EXPECT_STREQ(chain->ticker, "ATOM");
+  EXPECT_STREQ(chain->expertTicker, "uatom");
+  EXPECT_EQ(chain->decimals, 6);
+
+  chain = by_chain_id("dydx-mainnet-1");
+  ASSERT_NE(chain, nullptr);
+  EXPECT_FALSE(chain->isDefault);
+  EXPECT_EQ(chain->decimals, 18);
+  EXPECT_EQ(chain, chain_config_by_hrp("dydx", 4));
+
+  for (const char *id : {"osmosis-1", "mantra-1", "xion-mainnet-1", "celestia"}) {
+    chain = by_chain_id(id);
+    ASSERT_NE(chain, nullptr) << id;
+    EXPECT_STREQ(chain->chainId, id);
+  }
+
+  EXPECT_EQ(by_chain_id("cosmoshub-3"), nullptr);
+  EXPECT_EQ(by_chain_id("cosmoshub-4 "), nullptr);
+  EXPECT_EQ(by_chain_id("osmosis"), nullptr);
+  EXPECT_EQ(by_chain_id(""), nullptr);
+}
+
+TEST(ChainConfig, AddressOnlyChains) {
+  const chain_info_t *chain = chain_config_by_hrp("core", 4);
+  ASSERT_NE(chain, nullptr);
+  EXPECT_EQ(chain->chainId, nullptr);
+  EXPECT_EQ(chain->ticker, nullptr);
+  EXPECT_FALSE(chain->isDefault);
+}
+} // namespace
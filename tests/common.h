@@ -37,5 +37,6 @@ parser_error_t parse_tx(parsed_json_t *parsed_json, const char *tx);
 std::vector<std::string> dumpUI(parser_context_t *ctx, uint16_t maxKeyLen,
                                 uint16_t maxValueLen);
 
+// Parses into a struct that has not been parsed into before
 #define JSON_PARSE(parsed_json, buffer)                                        \
-  json_parse(parsed_json, buffer, strlen(buffer))
+  json_parse(parsed_json, buffer, strlen(buffer), 0)
@@ -0,0 +1,289 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "gtest/gtest.h"
+#include <crypto.h>
+#include <cx.h>
+#include <host_crypto.h>
+#include <lib_standard_app/swap_lib_calls.h>
+#include <os.h>
+#include <string>
+#include <swap/swap.h>
+#include <vector>
+
+namespace {
+typedef std::vector<uint8_t> bytes_t;
+
+std::string toHex(const uint8_t *data, size_t len) {
+  static const char digits[] = "0123456789abcdef";
+  std::string out;
+  for (size_t i = 0; i < len; i++) {
+    out += digits[data[i] >> 4];
+    out += digits[data[i] & 0x0F];
+  }
+  return out;
+}
+
+bytes_t fromHex(const std::string &hex) {
+  bytes_t out;
+  for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+    out.push_back((uint8_t)std::stoul(hex.substr(i, 2), nullptr, 16));
+  }
+  return out;
+}
+
+// Paths of the Zemu address tests, with the addresses they expect for the
+// Zemu mnemonic
+const uint32_t kCosmosPath[HDPATH_LEN_DEFAULT] = {0x8000002C, 0x80000076,
+                                                  0x80000005, 0, 3};
+const uint32_t kEthPath[HDPATH_LEN_DEFAULT] = {0x8000002C, 0x8000003C,
+                                               0x80000000, 0, 1};
+const char kCosmosAddress[] = "cosmos1wkd9tfm5pqvhhaxq77wv9tvjcsazuaykwsld65";
+const char kCosmosPubkey[] =
+    "035c986b9ae5fbfb8e1e9c12c817f5ef8fdb821cdecaa407f1420ec4f8f1d766bf";
+const char kInjAddress[] = "inj15n2h0lzvfgc8x4fm6fdya89n78x6ee2f3h7z3f";
+
+void selectChain(const uint32_t *path, const char *hrp,
+                 address_encoding_e encode_type) {
+  MEMCPY(hdPath, path, sizeof(hdPath));
+  bech32_hrp_len = (uint8_t)strlen(hrp);
+  MEMCPY(bech32_hrp, hrp, bech32_hrp_len + 1);
+  encoding = encode_type;
+  crypto_addrCacheClear();
+}
+
+TEST(HostCrypto, HashVectors) {
+  const std::string abc = "abc";
+  const std::string twoBlocks =
+      "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+  uint8_t digest[CX_SHA512_SIZE];
+
+  cx_hash_sha256((const uint8_t *)abc.data(), abc.size(), digest,
+                 CX_SHA256_SIZE);
+  EXPECT_EQ(toHex(digest, CX_SHA256_SIZE),
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  cx_hash_sha256((const uint8_t *)twoBlocks.data(), twoBlocks.size(), digest,
+                 CX_SHA256_SIZE);
+  EXPECT_EQ(toHex(digest, CX_SHA256_SIZE),
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+  ASSERT_EQ(cx_ripemd160_hash((const uint8_t *)abc.data(), abc.size(), digest),
+            CX_OK);
+  EXPECT_EQ(toHex(digest, CX_RIPEMD160_SIZE),
+            "8eb208f7e05d987a9b044a8e98c6b087f15a0bfc");
+  ASSERT_EQ(cx_ripemd160_hash((const uint8_t *)twoBlocks.data(),
+                              twoBlocks.size(), digest),
+            CX_OK);
+  EXPECT_EQ(toHex(digest, CX_RIPEMD160_SIZE),
+            "12a053384a9c0c88e405a06c27dcf49ada62eb2b");
+
+  // RFC 4231, test case 2
+  const std::string key = "Jefe";
+  const std::string data = "what do ya want for nothing?";
+  ASSERT_EQ(cx_hmac_sha512((const uint8_t *)key.data(), key.size(),
+                           (const uint8_t *)data.data(), data.size(), digest,
+                           sizeof(digest)),
+            CX_SHA512_SIZE);
+  EXPECT_EQ(toHex(digest, CX_SHA512_SIZE),
+            "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea250554"
+            "9758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737");
+}
+
+TEST(HostCrypto, Bip32Vector) {
+  // BIP32 test vector 1, m/0'/1/2'/2/1000000000
+  bytes_t seed = fromHex("000102030405060708090a0b0c0d0e0f");
+  const uint32_t path[] = {0x80000000, 1, 0x80000002, 2, 1000000000};
+  uint8_t privateKey[64] = {0};
+  uint8_t chainCode[32] = {0};
+  ASSERT_EQ(os_derive_bip32_with_seed_no_throw(HDW_NORMAL, CX_CURVE_256K1,
+                                               path, 5, privateKey, chainCode,
+                                               seed.data(), seed.size()),
+            CX_OK);
+  EXPECT_EQ(toHex(privateKey, 32),
+            "471b76e389e528d6de6d816857e012c5455051cad6660850e58372a6c3e6e7c8");
+  EXPECT_EQ(toHex(chainCode, 32),
+            "c783e67b921d2beb8f6b389cc646d7263b4145701dadd2161548a8b078e65e9e");
+}
+
+TEST(HostCrypto, Rfc6979Vector) {
+  // Key 1 signing SHA-256 of "Satoshi Nakamoto"
+  uint8_t key[32] = {0};
+  key[31] = 1;
+  const std::string message = "Satoshi Nakamoto";
+  uint8_t digest[CX_SHA256_SIZE];
+  cx_hash_sha256((const uint8_t *)message.data(), message.size(), digest,
+                 sizeof(digest));
+
+  cx_ecfp_private_key_t privateKey;
+  ASSERT_EQ(cx_ecfp_init_private_key_no_throw(CX_CURVE_256K1, key,
+                                              sizeof(key), &privateKey),
+            CX_OK);
+  uint8_t der[72];
+  size_t derLen = sizeof(der);
+  uint32_t info = 0;
+  ASSERT_EQ(cx_ecdsa_sign_no_throw(&privateKey, CX_RND_RFC6979 | CX_LAST,
+                                   CX_SHA256, digest, sizeof(digest), der,
+                                   &derLen, &info),
+            CX_OK);
+  EXPECT_EQ(toHex(der, derLen),
+            "3045022100"
+            "934b1ea10a4b3c1757e2b0c017d0b6143ce3c9a7e6a4a49860d7a6ab210ee3d8"
+            "0220"
+            "2442ce9d2b916064108014783e923ec36b49743e2ffa1c4496f01a512aafd9e5");
+}
+
+TEST(HostCrypto, AddressesMatchZemu) {
+  uint8_t buffer[100];
+  uint16_t len = 0;
+
+  selectChain(kCosmosPath, "cosmos", BECH32_COSMOS);
+  ASSERT_EQ(crypto_fillAddress(buffer, sizeof(buffer), &len), zxerr_ok);
+  EXPECT_EQ(toHex(buffer, PK_LEN_SECP256K1), kCosmosPubkey);
+  EXPECT_EQ(std::string((const char *)buffer + PK_LEN_SECP256K1,
+                        len - PK_LEN_SECP256K1),
+            kCosmosAddress);
+
+  selectChain(kEthPath, "inj", BECH32_ETH);
+  ASSERT_EQ(crypto_fillAddress(buffer, sizeof(buffer), &len), zxerr_ok);
+  EXPECT_EQ(std::string((const char *)buffer + PK_LEN_SECP256K1,
+                        len - PK_LEN_SECP256K1),
+            kInjAddress);
+}
+
+TEST(HostCrypto, SignatureVerifiesAndIsDeterministic) {
+  selectChain(kCosmosPath, "cosmos", BECH32_COSMOS);
+  uint8_t address[100];
+  uint16_t addressLen = 0;
+  ASSERT_EQ(crypto_fillAddress(address, sizeof(address), &addressLen),
+            zxerr_ok);
+
+  const std::string tx = "{\"account_number\":\"0\",\"chain_id\":\"test\"}";
+  bytes_t signatures[2];
+  for (auto &signature : signatures) {
+    ASSERT_EQ(crypto_signSessionStart(), zxerr_ok);
+    ASSERT_EQ(crypto_digestStart(), zxerr_ok);
+    ASSERT_EQ(crypto_digestUpdate((const uint8_t *)tx.data(), tx.size()),
+              zxerr_ok);
+    ASSERT_EQ(crypto_digestFinish(), zxerr_ok);
+    uint8_t der[80];
+    uint16_t derLen = 0;
+    ASSERT_EQ(crypto_sign(der, sizeof(der), &derLen), zxerr_ok);
+    signature.assign(der, der + derLen);
+  }
+  EXPECT_EQ(signatures[0], signatures[1]);
+
+  // The signature is over SHA-256 of the transaction, by the key of hdPath
+  uint8_t privateKeyData[64];
+  ASSERT_EQ(os_derive_bip32_with_seed_no_throw(
+                HDW_NORMAL, CX_CURVE_256K1, kCosmosPath, HDPATH_LEN_DEFAULT,
+                privateKeyData, nullptr, nullptr, 0),
+            CX_OK);
+  cx_ecfp_private_key_t privateKey;
+  cx_ecfp_public_key_t publicKey;
+  cx_ecfp_init_private_key_no_throw(CX_CURVE_256K1, privateKeyData, 32,
+                                    &privateKey);
+  ASSERT_EQ(cx_ecfp_generate_pair_no_throw(CX_CURVE_256K1, &publicKey,
+                                           &privateKey, true),
+            CX_OK);
+  EXPECT_EQ(publicKey.W[64] & 1 ? 0x03 : 0x02, address[0]);
+
+  uint8_t digest[CX_SHA256_SIZE];
+  cx_hash_sha256((const uint8_t *)tx.data(), tx.size(), digest,
+                 sizeof(digest));
+  EXPECT_TRUE(cx_ecdsa_verify_no_throw(&publicKey, digest, sizeof(digest),
+                                       signatures[0].data(),
+                                       signatures[0].size()));
+  digest[0] ^= 1;
+  EXPECT_FALSE(cx_ecdsa_verify_no_throw(&publicKey, digest, sizeof(digest),
+                                        signatures[0].data(),
+                                        signatures[0].size()));
+
+  // Without a sign request, there is no key to sign with
+  ASSERT_EQ(crypto_digestStart(), zxerr_ok);
+  ASSERT_EQ(crypto_digestFinish(), zxerr_ok);
+  uint8_t der[80];
+  uint16_t derLen = 0;
+  EXPECT_NE(crypto_sign(der, sizeof(der), &derLen), zxerr_ok);
+}
+
+TEST(HostCrypto, AddressRangeMatchesSingleAddresses) {
+  selectChain(kCosmosPath, "cosmos", BECH32_COSMOS);
+  const uint8_t count = 3;
+  uint8_t range[250];
+  uint16_t rangeLen = 0;
+  ASSERT_EQ(crypto_fillAddressRange(range, sizeof(range), kCosmosPath,
+                                    HDPATH_INDEX_LEVEL, count, &rangeLen),
+            zxerr_ok);
+  ASSERT_EQ(range[0], count);
+
+  // Each one derived from the seed, without the cache filled by the range
+  uint16_t offset = 1;
+  for (uint8_t i = 0; i < count; i++) {
+    uint32_t path[HDPATH_LEN_DEFAULT];
+    MEMCPY(path, kCosmosPath, sizeof(path));
+    path[HDPATH_INDEX_LEVEL] += i;
+    selectChain(path, "cosmos", BECH32_COSMOS);
+    uint8_t single[100];
+    uint16_t singleLen = 0;
+    ASSERT_EQ(crypto_fillAddress(single, sizeof(single), &singleLen),
+              zxerr_ok);
+
+    const uint8_t addrLen = range[offset + PK_LEN_SECP256K1];
+    ASSERT_EQ(addrLen + PK_LEN_SECP256K1, singleLen);
+    EXPECT_EQ(toHex(range + offset, PK_LEN_SECP256K1),
+              toHex(single, PK_LEN_SECP256K1));
+    EXPECT_EQ(std::string((const char *)range + offset + PK_LEN_SECP256K1 + 1,
+                          addrLen),
+              std::string((const char *)single + PK_LEN_SECP256K1, addrLen));
+    offset += PK_LEN_SECP256K1 + 1 + addrLen;
+  }
+  EXPECT_EQ(offset, rangeLen);
+  EXPECT_EQ(std::string((const char *)range + 1 + PK_LEN_SECP256K1 + 1,
+                        strlen(kCosmosAddress)),
+            kCosmosAddress);
+}
+
+TEST(HostCrypto, SwapCheckAddress) {
+  crypto_addrCacheClear();
+  uint8_t coinConfig[] = {6, 'c', 'o', 's', 'm', 'o', 's'};
+  uint8_t addressParams[1 + 4 * HDPATH_LEN_DEFAULT] = {HDPATH_LEN_DEFAULT};
+  for (uint8_t i = 0; i < HDPATH_LEN_DEFAULT; i++) {
+    for (uint8_t b = 0; b < 4; b++) {
+      addressParams[1 + 4 * i + b] = (uint8_t)(kCosmosPath[i] >> (24 - 8 * b));
+    }
+  }
+
+  std::string address = kCosmosAddress;
+  check_address_parameters_t params = {};
+  params.coin_configuration = coinConfig;
+  params.coin_configuration_length = sizeof(coinConfig);
+  params.address_parameters = addressParams;
+  params.address_parameters_length = sizeof(addressParams);
+  params.address_to_check = &address[0];
+  handle_check_address(&params);
+  EXPECT_EQ(params.result, 1);
+
+  address[address.size() - 1] = 'q';
+  handle_check_address(&params);
+  EXPECT_EQ(params.result, 0);
+
+  // Another account of the same chain
+  address = kCosmosAddress;
+  addressParams[1 + 4 * HDPATH_ACCOUNT_LEVEL + 3] = 6;
+  handle_check_address(&params);
+  EXPECT_EQ(params.result, 0);
+}
+} // namespace
@@ -0,0 +1,150 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "formatting.h"
+#include "zxmacros.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <string>
+
+namespace {
+std::string format(const char *digits, uint8_t decimals, uint8_t minDecimals,
+                   const char *unit = "") {
+  char out[160];
+  const zxerr_t err =
+      format_fixed_point(out, sizeof(out), digits, strlen(digits), decimals,
+                         minDecimals, unit, strlen(unit));
+  EXPECT_EQ(err, zxerr_ok);
+  return std::string(out);
+}
+
+TEST(Formatting, FixedPointDigits) {
+  EXPECT_EQ(format("1000000", 6, 6, "ATOM"), "1.000000 ATOM");
+  EXPECT_EQ(format("20139397", 6, 6, "ATOM"), "20.139397 ATOM");
+  EXPECT_EQ(format("5000", 6, 6, "ATOM"), "0.005000 ATOM");
+  EXPECT_EQ(format("5", 6, 6), "0.000005");
+  EXPECT_EQ(format("0", 6, 6), "0.000000");
+  EXPECT_EQ(format("", 6, 6), "0.000000");
+  EXPECT_EQ(format("123", 0, 0, "uatom"), "123 uatom");
+  EXPECT_EQ(format("123", 3, 3), "0.123");
+}
+
+TEST(Formatting, FixedPointTrimming) {
+  EXPECT_EQ(format("1500000", 6, 1), "1.5");
+  EXPECT_EQ(format("1000000", 6, 1), "1.0");
+  EXPECT_EQ(format("1000000", 6, 0), "1");
+  EXPECT_EQ(format("5000", 6, 0), "0.005");
+  EXPECT_EQ(format("1000010", 6, 2), "1.00001");
+  EXPECT_EQ(format("1", 18, 1, "DYDX"), "0.000000000000000001 DYDX");
+}
+
+TEST(Formatting, FixedPointLongDigits) {
+  // Values beyond 128 bits are still formatted from their digits
+  const std::string digits(60, '9');
+  const std::string expected =
+      std::string(42, '9') + "." + std::string(18, '9') + " adydx";
+  EXPECT_EQ(format(digits.c_str(), 18, 18, "adydx"), expected);
+}
+
+TEST(Formatting, FixedPointBufferTooSmall) {
+  char out[9];
+  EXPECT_EQ(format_fixed_point(out, sizeof(out), "1000000", 7, 6, 6, "", 0),
+            zxerr_ok);
+  EXPECT_STREQ(out, "1.000000");
+
+  EXPECT_EQ(format_fixed_point(out, sizeof(out), "1000000", 7, 6, 6, "A", 1),
+            zxerr_buffer_too_small);
+  EXPECT_STREQ(out, "");
+}
+
+TEST(Formatting, FixedPointU64) {
+  char out[64];
+  EXPECT_EQ(format_fixed_point_u64(out, sizeof(out), 0, 6, 6, "ATOM", 4),
+            zxerr_ok);
+  EXPECT_STREQ(out, "0.000000 ATOM");
+
+  EXPECT_EQ(format_fixed_point_u64(out, sizeof(out), 6000000, 6, 6, "", 0),
+            zxerr_ok);
+  EXPECT_STREQ(out, "6.000000");
+
+  EXPECT_EQ(format_fixed_point_u64(out, sizeof(out), UINT64_MAX, 0, 0, "", 0),
+            zxerr_ok);
+  EXPECT_STREQ(out, "18446744073709551615");
+
+  EXPECT_EQ(format_fixed_point_u64(out, sizeof(out), 10000000000000000000ULL,
+                                   18, 1, "", 0),
+            zxerr_ok);
+  EXPECT_STREQ(out, "10.0");
+}
+
+TEST(Formatting, FixedPointU128) {
+  char out[64];
+  // 2^64
+  EXPECT_EQ(format_fixed_point_u128(out, sizeof(out), 1, 0, 0, 0, "", 0),
+            zxerr_ok);
+  EXPECT_STREQ(out, "18446744073709551616");
+
+  // 2^128 - 1
+  EXPECT_EQ(format_fixed_point_u128(out, sizeof(out), UINT64_MAX, UINT64_MAX,
+                                    18, 18, "", 0),
+            zxerr_ok);
+  EXPECT_STREQ(out, "340282366920938463463.374607431768211455");
+
+  // 10^20, digits below the top one are all zeros
+  EXPECT_EQ(format_fixed_point_u128(out, sizeof(out), 0x5ULL,
+                                    0x6bc75e2d63100000ULL, 18, 1, "", 0),
+            zxerr_ok);
+  EXPECT_STREQ(out, "100.0");
+
+  // Falls back to the 64-bit path
+  EXPECT_EQ(format_fixed_point_u128(out, sizeof(out), 0, 1234567, 6, 6, "", 0),
+            zxerr_ok);
+  EXPECT_STREQ(out, "1.234567");
+}
+
+TEST(Formatting, FixedPointBigEndian) {
+  char out[64];
+  // Amounts arrive right aligned in a zero padded buffer
+  uint8_t amount[50] = {0};
+  amount[47] = 0x0F;
+  amount[48] = 0x42;
+  amount[49] = 0x40;
+  EXPECT_EQ(format_fixed_point_be(out, sizeof(out), amount, sizeof(amount), 6,
+                                  6, "ATOM", 4),
+            zxerr_ok);
+  EXPECT_STREQ(out, "1.000000 ATOM");
+
+  MEMZERO(amount, sizeof(amount));
+  EXPECT_EQ(format_fixed_point_be(out, sizeof(out), amount, sizeof(amount), 0,
+                                  0, "uatom", 5),
+            zxerr_ok);
+  EXPECT_STREQ(out, "0 uatom");
+
+  // 2^128 - 1
+  memset(amount + 34, 0xFF, 16);
+  EXPECT_EQ(format_fixed_point_be(out, sizeof(out), amount, sizeof(amount), 18,
+                                  18, "DYDX", 4),
+            zxerr_ok);
+  EXPECT_STREQ(out, "340282366920938463463.374607431768211455 DYDX");
+
+  // 2^128 needs the arbitrary precision path
+  MEMZERO(amount, sizeof(amount));
+  amount[33] = 0x01;
+  EXPECT_EQ(format_fixed_point_be(out, sizeof(out), amount, sizeof(amount), 18,
+                                  18, "DYDX", 4),
+            zxerr_out_of_bounds);
+}
+} // namespace
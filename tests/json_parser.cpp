@@ -118,6 +118,25 @@ TEST(JsonParserTest, SimpleObject) {
   EXPECT_TRUE(parserData.tokens[9].type == jsmntype_t::JSMN_PRIMITIVE);
 }
 
+TEST(JsonParserTest, ReparseWipesOnlyStaleTokens) {
+  parsed_json_t parserData = {false};
+  JSON_PARSE(&parserData, "LIST : [1, 2, 3, 4]");
+  EXPECT_EQ(6, parserData.tokensWritten);
+
+  const char reparsed[] = "KEY : VALUE";
+  json_parse(&parserData, reparsed, strlen(reparsed), parserData.tokensWritten);
+  EXPECT_TRUE(parserData.isValid);
+  EXPECT_EQ(2, parserData.numberOfTokens);
+  EXPECT_EQ(2, parserData.tokensWritten);
+
+  // Tokens left over from the longer parse are cleared
+  for (uint16_t i = 2; i < 6; i++) {
+    EXPECT_EQ(parserData.tokens[i].type, jsmntype_t::JSMN_UNDEFINED);
+    EXPECT_EQ(parserData.tokens[i].start, 0);
+    EXPECT_EQ(parserData.tokens[i].end, 0);
+  }
+}
+
 TEST(JsonParserTest, ArrayElementCount_objects) {
   auto transaction =
       R"({"array":[{"amount":5,"denom":"photon"}, {"amount":5,"denom":"photon"}, {"amount":5,"denom":"photon"}]})";
@@ -0,0 +1,88 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "gtest/gtest.h"
+#include "keccak.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+std::string hex(const uint8_t *data, size_t len) {
+  static const char digits[] = "0123456789abcdef";
+  std::string out;
+  for (size_t i = 0; i < len; i++) {
+    out += digits[data[i] >> 4];
+    out += digits[data[i] & 0xF];
+  }
+  return out;
+}
+
+std::string keccak256(const std::vector<uint8_t> &in) {
+  uint8_t out[32];
+  EXPECT_EQ(keccak_hash(in.data(), in.size(), out, sizeof(out)), zxerr_ok);
+  return hex(out, sizeof(out));
+}
+
+// Bytes 0, 1, 2, ... spanning more than one block
+std::vector<uint8_t> counting(size_t len) {
+  std::vector<uint8_t> data(len);
+  for (size_t i = 0; i < len; i++) {
+    data[i] = (uint8_t)i;
+  }
+  return data;
+}
+
+TEST(Keccak, Vectors) {
+  EXPECT_EQ(keccak256({}),
+            "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470");
+  EXPECT_EQ(keccak256({'a', 'b', 'c'}),
+            "4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45");
+  EXPECT_EQ(keccak256(counting(200)),
+            "bfb0aa97863e797943cf7c33bb7e880bb4543f3d2703c0923c6901c2af57b890");
+}
+
+TEST(Keccak, StreamingMatchesOneShot) {
+  for (size_t len : {0u, 1u, 63u, 64u, 135u, 136u, 137u, 272u, 500u}) {
+    const std::vector<uint8_t> data = counting(len);
+    const std::string expected = keccak256(data);
+
+    for (size_t chunk : {1u, 7u, 8u, 64u, 136u, 200u}) {
+      keccak_ctx_t ctx;
+      ASSERT_EQ(keccak_init(&ctx, 256), zxerr_ok);
+      for (size_t off = 0; off < len; off += chunk) {
+        const size_t n = std::min(chunk, len - off);
+        ASSERT_EQ(keccak_update(&ctx, data.data() + off, n), zxerr_ok);
+      }
+      uint8_t out[32];
+      ASSERT_EQ(keccak_final(&ctx, out, sizeof(out)), zxerr_ok);
+      EXPECT_EQ(hex(out, sizeof(out)), expected) << len << " by " << chunk;
+    }
+  }
+}
+
+TEST(Keccak, SqueezesPastOneBlock) {
+  // The first 32 bytes of a long output are the digest
+  const std::vector<uint8_t> data = counting(100);
+  uint8_t out[300];
+  ASSERT_EQ(keccak_hash(data.data(), data.size(), out, sizeof(out)), zxerr_ok);
+  EXPECT_EQ(hex(out, 32), keccak256(data));
+
+  keccak_ctx_t ctx;
+  EXPECT_EQ(keccak_init(&ctx, 100), zxerr_invalid_crypto_settings);
+  EXPECT_EQ(keccak_hash(nullptr, 1, out, 32), zxerr_invalid_crypto_settings);
+}
+} // namespace
@@ -0,0 +1,121 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "gtest/gtest.h"
+#include <key_session.h>
+#include <vector>
+
+namespace {
+// Cost model of a derivation on the secure element, relative to the rest of
+// a sign request
+constexpr unsigned kDeriveCost = 100;
+constexpr unsigned kAddressCost = 10;
+constexpr unsigned kSignCost = 40;
+
+unsigned derivations = 0;
+
+zxerr_t mockDerive(const uint32_t *path, uint8_t pathLen, uint8_t *key) {
+  derivations++;
+  for (size_t i = 0; i < KEY_SESSION_KEY_LEN; i++) {
+    key[i] = (uint8_t)(path[pathLen - 1] + i);
+  }
+  return zxerr_ok;
+}
+
+zxerr_t failingDerive(const uint32_t *, uint8_t, uint8_t *key) {
+  key[0] = 0xAA;
+  return zxerr_unknown;
+}
+
+const uint32_t kPath[HDPATH_LEN_DEFAULT] = {0x8000002C, 0x80000076,
+                                            0x80000000, 0, 7};
+
+// Address then signature of one sign request, deriving the key for each
+// unless a session holds it. Returns the modeled cost.
+unsigned signRequest(bool useSession) {
+  key_session_t session = {};
+  unsigned cost = 0;
+  const unsigned before = derivations;
+
+  uint8_t key[KEY_SESSION_KEY_LEN];
+  if (useSession) {
+    EXPECT_EQ(key_session_start(&session, kPath, HDPATH_LEN_DEFAULT,
+                                mockDerive),
+              zxerr_ok);
+  }
+  for (unsigned step = 0; step < 2; step++) {
+    if (key_session_get(&session, kPath, HDPATH_LEN_DEFAULT) == nullptr) {
+      mockDerive(kPath, HDPATH_LEN_DEFAULT, key);
+    }
+    cost += step == 0 ? kAddressCost : kSignCost;
+  }
+  key_session_end(&session);
+
+  return cost + (derivations - before) * kDeriveCost;
+}
+
+std::vector<uint8_t> keyBytes(const key_session_t &session) {
+  return std::vector<uint8_t>(session.key, session.key + sizeof(session.key));
+}
+
+TEST(KeySession, DerivesOncePerSignRequest) {
+  derivations = 0;
+  const unsigned uncached = signRequest(false);
+  EXPECT_EQ(derivations, 2u);
+
+  derivations = 0;
+  const unsigned cached = signRequest(true);
+  EXPECT_EQ(derivations, 1u);
+
+  EXPECT_EQ(uncached - cached, kDeriveCost);
+  EXPECT_LT(cached * 10, uncached * 7);
+}
+
+TEST(KeySession, OnlyServesItsPath) {
+  key_session_t session = {};
+  EXPECT_EQ(key_session_get(&session, kPath, HDPATH_LEN_DEFAULT), nullptr);
+
+  ASSERT_EQ(key_session_start(&session, kPath, HDPATH_LEN_DEFAULT, mockDerive),
+            zxerr_ok);
+  const uint8_t *key = key_session_get(&session, kPath, HDPATH_LEN_DEFAULT);
+  ASSERT_NE(key, nullptr);
+  EXPECT_EQ(key[0], 7);
+
+  uint32_t other[HDPATH_LEN_DEFAULT] = {0x8000002C, 0x80000076, 0x80000000, 0,
+                                        8};
+  EXPECT_EQ(key_session_get(&session, other, HDPATH_LEN_DEFAULT), nullptr);
+  EXPECT_EQ(key_session_get(&session, kPath, HDPATH_LEN_DEFAULT - 1), nullptr);
+}
+
+TEST(KeySession, WipesKey) {
+  key_session_t session = {};
+  ASSERT_EQ(key_session_start(&session, kPath, HDPATH_LEN_DEFAULT, mockDerive),
+            zxerr_ok);
+  key_session_end(&session);
+  EXPECT_EQ(key_session_get(&session, kPath, HDPATH_LEN_DEFAULT), nullptr);
+  const std::vector<uint8_t> zeros(KEY_SESSION_KEY_LEN, 0);
+  EXPECT_EQ(keyBytes(session), zeros);
+
+  // A failed derivation leaves nothing behind
+  ASSERT_EQ(key_session_start(&session, kPath, HDPATH_LEN_DEFAULT, mockDerive),
+            zxerr_ok);
+  EXPECT_EQ(key_session_start(&session, kPath, HDPATH_LEN_DEFAULT,
+                              failingDerive),
+            zxerr_unknown);
+  EXPECT_EQ(key_session_get(&session, kPath, HDPATH_LEN_DEFAULT), nullptr);
+  EXPECT_EQ(keyBytes(session), zeros);
+}
+} // namespace
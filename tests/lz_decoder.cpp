@@ -0,0 +1,206 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "app_mode.h"
+#include "common.h"
+#include "testcases.h"
+#include "gtest/gtest.h"
+#include <common/parser.h>
+#include <compress/lz_decoder.h>
+#include <string>
+#include <vector>
+
+namespace {
+typedef std::vector<uint8_t> bytes_t;
+
+// Greedy reference encoder, searching the dictionary and the input for the
+// longest match at each position
+bytes_t compress(const std::string &input) {
+  size_t dictLen = 0;
+  const uint8_t *dict = lz_dictionary(&dictLen);
+  bytes_t window(dict, dict + dictLen);
+  window.insert(window.end(), input.begin(), input.end());
+
+  bytes_t out;
+  bytes_t literals;
+  auto flushLiterals = [&]() {
+    for (size_t i = 0; i < literals.size(); i += LZ_MAX_LITERALS) {
+      const size_t n = std::min<size_t>(LZ_MAX_LITERALS, literals.size() - i);
+      out.push_back((uint8_t)(n - 1));
+      out.insert(out.end(), literals.begin() + i, literals.begin() + i + n);
+    }
+    literals.clear();
+  };
+
+  size_t pos = dictLen;
+  while (pos < window.size()) {
+    size_t bestLen = 0;
+    size_t bestDistance = 0;
+    const size_t start = pos > LZ_MAX_DISTANCE ? pos - LZ_MAX_DISTANCE : 0;
+    for (size_t candidate = start; candidate < pos; candidate++) {
+      size_t len = 0;
+      while (len < LZ_MAX_MATCH && pos + len < window.size() &&
+             window[candidate + len] == window[pos + len]) {
+        len++;
+      }
+      if (len >= bestLen) {
+        bestLen = len;
+        bestDistance = pos - candidate;
+      }
+    }
+
+    if (bestLen < LZ_MIN_MATCH) {
+      literals.push_back(window[pos++]);
+      continue;
+    }
+    flushLiterals();
+    out.push_back((uint8_t)(0x80 | (bestLen - LZ_MIN_MATCH)));
+    out.push_back((uint8_t)(bestDistance >> 8));
+    out.push_back((uint8_t)bestDistance);
+    pos += bestLen;
+  }
+  flushLiterals();
+  return out;
+}
+
+// Feeds the stream in chunks of chunkLen bytes through a small output
+// buffer, the way the sign handler appends to the transaction buffer
+parser_error_t decompress(const bytes_t &in, size_t chunkLen, size_t outLen,
+                          std::string *result) {
+  lz_decoder_t decoder;
+  lz_decoder_init(&decoder);
+  bytes_t history;
+  bytes_t out(outLen);
+
+  for (size_t offset = 0; offset < in.size(); offset += chunkLen) {
+    const size_t end = std::min(in.size(), offset + chunkLen);
+    size_t pos = offset;
+    size_t produced = 0;
+    do {
+      size_t consumed = 0;
+      CHECK_PARSER_ERR(lz_decode(&decoder, in.data() + pos, end - pos,
+                                 &consumed, history.data(), history.size(),
+                                 out.data(), out.size(), &produced))
+      pos += consumed;
+      history.insert(history.end(), out.begin(), out.begin() + produced);
+    } while (pos < end || produced == out.size());
+  }
+  CHECK_PARSER_ERR(lz_decoder_finish(&decoder))
+
+  result->assign(history.begin(), history.end());
+  return parser_ok;
+}
+
+size_t chunks(size_t len) { return (len + 249) / 250; }
+
+// Several messages sharing addresses, as in a batch of reward withdrawals
+std::string multiMessageTx(size_t numMsgs) {
+  std::string tx = "{\"account_number\":\"108\",\"chain_id\":\"cosmoshub-4\","
+                   "\"fee\":{\"amount\":[{\"amount\":\"600\",\"denom\":"
+                   "\"uatom\"}],\"gas\":\"200000\"},\"memo\":\"\",\"msgs\":[";
+  const char *validators[] = {
+      "cosmosvaloper1qwl879nx9t6kef4supyazayf7vjhennyh568ys",
+      "cosmosvaloper1x88j7vp2xnw3zec8ur3g4waxycyz7m0mahdv3p",
+      "cosmosvaloper1grgelyng2v6v3t8z87wu3sxgt9m5s03xfytvz7",
+      "cosmosvaloper1sjllsnramtg3ewxqwwrwjxfgc4n4ef9u2lcnj0",
+  };
+  for (size_t i = 0; i < numMsgs; i++) {
+    tx += i == 0 ? "" : ",";
+    tx += "{\"type\":\"cosmos-sdk/MsgWithdrawDelegationReward\",\"value\":{"
+          "\"delegator_address\":\""
+          "cosmos14lultfckehtszvzw4ehu0apvsr77afvyhgqhwh\","
+          "\"validator_address\":\"";
+    tx += validators[i % 4];
+    tx += "\"}}";
+  }
+  tx += "],\"sequence\":\"106\"}";
+  return tx;
+}
+
+TEST(LzDecoder, RoundTripsJsonVectors) {
+  size_t plain = 0;
+  size_t compressed = 0;
+  for (const auto &tc : GetJsonTestCases("testcases/manual.json")) {
+    const bytes_t stream = compress(tc.tx);
+    for (size_t chunkLen : {1u, 7u, 250u}) {
+      std::string output;
+      ASSERT_EQ(decompress(stream, chunkLen, 5, &output), parser_ok) << tc.name;
+      EXPECT_EQ(output, tc.tx) << tc.name;
+    }
+    plain += tc.tx.size();
+    compressed += stream.size();
+  }
+  EXPECT_LT(compressed * 2, plain);
+}
+
+TEST(LzDecoder, LargeTransactionNeedsFewerChunks) {
+  const std::string tx = multiMessageTx(40);
+  const bytes_t stream = compress(tx);
+
+  std::string output;
+  ASSERT_EQ(decompress(stream, 250, 256, &output), parser_ok);
+  ASSERT_EQ(output, tx);
+  EXPECT_GE(chunks(tx.size()), 4 * chunks(stream.size()));
+
+  // The decompressed bytes are what gets parsed and signed
+  app_mode_set_expert(false);
+  parser_context_t ctx;
+  parser_tx_t tx_obj;
+  MEMZERO(&tx_obj, sizeof(tx_obj));
+  tx_obj.tx_type = tx_json;
+  ASSERT_EQ(parser_parse(&ctx, (const uint8_t *)output.data(), output.size(),
+                         &tx_obj),
+            parser_ok);
+  EXPECT_EQ(parser_validate(&ctx), parser_ok);
+}
+
+TEST(LzDecoder, OverlappingMatch) {
+  // A run is a match whose source overlaps its own output
+  const bytes_t stream = {0x00, 'a', 0x80 | 7, 0x00, 0x01};
+  std::string output;
+  ASSERT_EQ(decompress(stream, 1, 3, &output), parser_ok);
+  EXPECT_EQ(output, "aaaaaaaaaaa");
+}
+
+TEST(LzDecoder, RejectsMalformedStreams) {
+  size_t dictLen = 0;
+  lz_dictionary(&dictLen);
+  std::string output;
+
+  // Zero distance
+  EXPECT_EQ(decompress({0x80, 0x00, 0x00}, 250, 16, &output),
+            parser_value_out_of_range);
+  // Reaching before the dictionary
+  const uint16_t far = (uint16_t)(dictLen + 2);
+  EXPECT_EQ(decompress({0x00, 'a', 0x80, (uint8_t)(far >> 8), (uint8_t)far},
+                       250, 16, &output),
+            parser_value_out_of_range);
+  // Truncated literal run, match and distance
+  EXPECT_EQ(decompress({0x03, 'a', 'b'}, 250, 16, &output),
+            parser_unexpected_buffer_end);
+  EXPECT_EQ(decompress({0x80}, 250, 16, &output),
+            parser_unexpected_buffer_end);
+  EXPECT_EQ(decompress({0x80, 0x00}, 250, 16, &output),
+            parser_unexpected_buffer_end);
+
+  // The start of the dictionary is the farthest reachable byte
+  const uint16_t first = (uint16_t)dictLen;
+  ASSERT_EQ(decompress({0x80, (uint8_t)(first >> 8), (uint8_t)first}, 250, 16,
+                       &output),
+            parser_ok);
+  EXPECT_EQ(output, "\"vo");
+}
+} // namespace
@@ -0,0 +1,161 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "gtest/gtest.h"
+#include "nvm_mock.h"
+#include <nvm/nvm_cache.h>
+#include <vector>
+
+namespace {
+typedef std::vector<uint8_t> bytes_t;
+
+constexpr size_t kRamSize = 8192;
+constexpr size_t kFlashSize = 16384;
+
+// The write callback has no context
+NvmMock *nvm = nullptr;
+
+void mockWrite(uint8_t *dst, const uint8_t *src, uint32_t len) {
+  nvm->write(dst, src, len);
+}
+
+bytes_t transaction(size_t len) {
+  bytes_t tx(len);
+  for (size_t i = 0; i < len; i++) {
+    tx[i] = (uint8_t)(i * 31 + i / 251);
+  }
+  return tx;
+}
+
+// Uploads tx in chunks of chunkLen bytes through the cache, with the final
+// flush of the last chunk
+bytes_t upload(const bytes_t &tx, size_t chunkLen, NvmMock *mock) {
+  nvm = mock;
+  bytes_t ram(kRamSize);
+  nvm_cache_t cache;
+  nvm_cache_init(&cache, ram.data(), ram.size(), mock->flash.data(),
+                 mock->flash.size(), mockWrite);
+  for (size_t offset = 0; offset < tx.size(); offset += chunkLen) {
+    const uint32_t len = (uint32_t)std::min(chunkLen, tx.size() - offset);
+    EXPECT_EQ(nvm_cache_append(&cache, tx.data() + offset, len), len);
+  }
+  nvm_cache_flush(&cache);
+
+  const uint8_t *data = nvm_cache_data(&cache);
+  return bytes_t(data, data + nvm_cache_length(&cache));
+}
+
+// Same upload as zxlib buffering does it, one flash write per chunk once the
+// RAM buffer is exceeded
+void uploadUncached(const bytes_t &tx, size_t chunkLen, NvmMock *mock) {
+  size_t ramPos = 0;
+  size_t flashPos = 0;
+  bool inFlash = false;
+  for (size_t offset = 0; offset < tx.size(); offset += chunkLen) {
+    const size_t len = std::min(chunkLen, tx.size() - offset);
+    if (!inFlash && ramPos + len <= kRamSize) {
+      ramPos += len;
+      continue;
+    }
+    if (!inFlash) {
+      mock->write(mock->flash.data(), tx.data(), ramPos);
+      flashPos = ramPos;
+      inFlash = true;
+    }
+    mock->write(mock->flash.data() + flashPos, tx.data() + offset, len);
+    flashPos += len;
+  }
+}
+
+TEST(NvmCache, KeepsContents) {
+  for (size_t len : {100u, 8192u, 8193u, 9000u, 16384u}) {
+    for (size_t chunkLen : {1u, 7u, 250u, 255u}) {
+      NvmMock mock(kFlashSize, NVM_CACHE_PAGE_SIZE);
+      const bytes_t tx = transaction(len);
+      EXPECT_EQ(upload(tx, chunkLen, &mock), tx) << len << " " << chunkLen;
+      EXPECT_EQ(mock.unalignedWrites, 0u);
+    }
+  }
+}
+
+TEST(NvmCache, WritesWholePages) {
+  const bytes_t tx = transaction(12000);
+
+  NvmMock uncached(kFlashSize, NVM_CACHE_PAGE_SIZE);
+  uploadUncached(tx, 250, &uncached);
+  NvmMock cached(kFlashSize, NVM_CACHE_PAGE_SIZE);
+  ASSERT_EQ(upload(tx, 250, &cached), tx);
+
+  // Each page is programmed once, the last one when flushed
+  const size_t pages = (tx.size() + NVM_CACHE_PAGE_SIZE - 1) /
+                       NVM_CACHE_PAGE_SIZE;
+  EXPECT_EQ(cached.pagePrograms, pages);
+  EXPECT_EQ(cached.bytesWritten, tx.size());
+  EXPECT_LT(cached.pagePrograms * 3, uncached.pagePrograms * 2);
+  EXPECT_LT(cached.writes, uncached.writes);
+
+  // Small transactions never reach flash
+  NvmMock small(kFlashSize, NVM_CACHE_PAGE_SIZE);
+  ASSERT_EQ(upload(transaction(kRamSize), 250, &small),
+            transaction(kRamSize));
+  EXPECT_EQ(small.writes, 0u);
+}
+
+TEST(NvmCache, ReadsBetweenAppends) {
+  NvmMock mock(kFlashSize, NVM_CACHE_PAGE_SIZE);
+  nvm = &mock;
+  bytes_t ram(kRamSize);
+  nvm_cache_t cache;
+  nvm_cache_init(&cache, ram.data(), ram.size(), mock.flash.data(),
+                 mock.flash.size(), mockWrite);
+
+  // Reading writes out the staged page, which is written again once full
+  const bytes_t tx = transaction(kRamSize + 1000);
+  ASSERT_EQ(nvm_cache_append(&cache, tx.data(), kRamSize), kRamSize);
+  ASSERT_EQ(nvm_cache_append(&cache, tx.data() + kRamSize, 100), 100u);
+  EXPECT_EQ(bytes_t(nvm_cache_data(&cache), nvm_cache_data(&cache) + 8292),
+            bytes_t(tx.begin(), tx.begin() + 8292));
+  const size_t programs = mock.pagePrograms;
+  nvm_cache_flush(&cache);
+  EXPECT_EQ(mock.pagePrograms, programs);
+
+  ASSERT_EQ(nvm_cache_append(&cache, tx.data() + 8292, 900), 900u);
+  EXPECT_EQ(bytes_t(nvm_cache_data(&cache), nvm_cache_data(&cache) + 9192),
+            tx);
+  EXPECT_EQ(mock.unalignedWrites, 0u);
+}
+
+TEST(NvmCache, RejectsWhatDoesNotFit) {
+  NvmMock mock(kFlashSize, NVM_CACHE_PAGE_SIZE);
+  nvm = &mock;
+  bytes_t ram(kRamSize);
+  nvm_cache_t cache;
+  nvm_cache_init(&cache, ram.data(), ram.size(), mock.flash.data(),
+                 mock.flash.size(), mockWrite);
+
+  const bytes_t tx = transaction(kFlashSize + 1);
+  ASSERT_EQ(nvm_cache_append(&cache, tx.data(), kFlashSize - 1),
+            kFlashSize - 1);
+  EXPECT_EQ(nvm_cache_append(&cache, tx.data(), 2), 0u);
+  EXPECT_EQ(nvm_cache_append(&cache, tx.data(), 1), 1u);
+  EXPECT_EQ(nvm_cache_length(&cache), kFlashSize);
+
+  // Back to RAM after a reset
+  nvm_cache_reset(&cache);
+  ASSERT_EQ(nvm_cache_append(&cache, tx.data(), 10), 10u);
+  EXPECT_EQ(nvm_cache_data(&cache), ram.data());
+}
+} // namespace
@@ -0,0 +1,53 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Flash area for host tests. Writes are counted the way the device programs
+// flash: every page a write touches is erased and programmed whole.
+class NvmMock {
+public:
+  NvmMock(size_t size, size_t pageSize)
+      : flash(size, 0xFF), pageSize(pageSize) {}
+
+  void write(uint8_t *dst, const uint8_t *src, uint32_t len) {
+    const size_t offset = dst - flash.data();
+    writes++;
+    bytesWritten += len;
+    if (offset % pageSize != 0) {
+      unalignedWrites++;
+    }
+    if (len > 0) {
+      const size_t last = (offset + len - 1) / pageSize;
+      const size_t pages = last - offset / pageSize + 1;
+      pagePrograms += pages;
+      bytesErased += pages * pageSize;
+    }
+    memcpy(dst, src, len);
+  }
+
+  std::vector<uint8_t> flash;
+  size_t pageSize;
+
+  size_t writes = 0;
+  size_t unalignedWrites = 0;
+  size_t bytesWritten = 0;
+  size_t pagePrograms = 0;
+  size_t bytesErased = 0;
+};
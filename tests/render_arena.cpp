@@ -0,0 +1,47 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "render_arena.h"
+#include "gtest/gtest.h"
+
+namespace {
+TEST(RenderArena, Budget) {
+  // Documented worst case, the screen phase
+  EXPECT_EQ(sizeof(render_screen_t), 1267u);
+  EXPECT_EQ(sizeof(render_amount_t), 160u);
+  EXPECT_EQ(sizeof(render_indexing_t), 280u);
+  EXPECT_EQ(sizeof(render_arena_t), sizeof(render_screen_t));
+}
+
+TEST(RenderArena, SingleOwner) {
+  render_arena_t *arena = render_arena_acquire(render_phase_screen);
+  ASSERT_NE(arena, nullptr);
+
+  // Nested borrows are rejected
+  EXPECT_EQ(render_arena_acquire(render_phase_amount), nullptr);
+  EXPECT_EQ(render_arena_acquire(render_phase_screen), nullptr);
+
+  // Only the owner can release it
+  render_arena_release(render_phase_indexing);
+  EXPECT_EQ(render_arena_acquire(render_phase_indexing), nullptr);
+
+  render_arena_release(render_phase_screen);
+  EXPECT_EQ(render_arena_acquire(render_phase_indexing), arena);
+  render_arena_release(render_phase_indexing);
+
+  EXPECT_EQ(render_arena_acquire(render_phase_none), nullptr);
+}
+} // namespace
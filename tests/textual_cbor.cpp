@@ -0,0 +1,200 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "testcases.h"
+#include "textual_cbor_reference.h"
+#include "gtest/gtest.h"
+#include <cbor/textual_cbor.h>
+#include <cstring>
+#include <hexutils.h>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+parser_error_t decode(const std::vector<uint8_t> &blob,
+                      std::vector<screen_arg_t> *screens) {
+  screens->clear();
+  textual_cbor_t decoder;
+  CHECK_PARSER_ERR(textual_cbor_init(&decoder, blob.data(), blob.size()))
+  uint8_t count = 0;
+  CHECK_PARSER_ERR(textual_cbor_enter_screens(&decoder, &count))
+  for (uint8_t i = 0; i < count; i++) {
+    screen_arg_t screen;
+    CHECK_PARSER_ERR(textual_cbor_read_screen(&decoder, &screen))
+    screens->push_back(screen);
+  }
+  return textual_cbor_finish(&decoder);
+}
+
+bool sameScreens(const std::vector<screen_arg_t> &a,
+                 const std::vector<screen_arg_t> &b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].titlePtr != b[i].titlePtr || a[i].titleLen != b[i].titleLen ||
+        a[i].contentPtr != b[i].contentPtr ||
+        a[i].contentLen != b[i].contentLen || a[i].indent != b[i].indent ||
+        a[i].expert != b[i].expert) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<std::vector<uint8_t>> textualBlobs() {
+  std::vector<std::vector<uint8_t>> blobs;
+  for (const auto &tc : GetJsonTextualTestCases("testcases/textual.json")) {
+    std::vector<uint8_t> blob(tc.tx.size() / 2);
+    blob.resize(parseHexString(blob.data(), blob.size(), tc.tx.c_str()));
+    blobs.push_back(blob);
+  }
+  return blobs;
+}
+
+std::vector<uint8_t> hex(const char *s) {
+  std::vector<uint8_t> blob(strlen(s) / 2);
+  blob.resize(parseHexString(blob.data(), blob.size(), s));
+  return blob;
+}
+
+TEST(TextualCbor, MatchesReferenceOnVectors) {
+  const auto blobs = textualBlobs();
+  ASSERT_FALSE(blobs.empty());
+  for (const auto &blob : blobs) {
+    std::vector<screen_arg_t> screens;
+    std::vector<screen_arg_t> expected;
+    ASSERT_EQ(decode(blob, &screens), parser_ok);
+    ASSERT_TRUE(
+        textual_reference::decode(blob.data(), blob.size(), &expected));
+    EXPECT_TRUE(sameScreens(screens, expected));
+  }
+}
+
+TEST(TextualCbor, ContentOnlyIndent) {
+  std::vector<screen_arg_t> screens;
+  // {1: [{2: "a", 3: 2}, {2: "b", 3: 2, 4: true}, {1: "t", 2: "c", 3: 1}]}
+  const auto blob = hex("a10183a202616103"
+                        "02a3026162030204f5a30161740261630301");
+  ASSERT_EQ(decode(blob, &screens), parser_ok);
+  ASSERT_EQ(screens.size(), 3u);
+  EXPECT_EQ(screens[0].indent, 0);
+  EXPECT_EQ(screens[1].indent, 2);
+  EXPECT_TRUE(screens[1].expert);
+  EXPECT_EQ(screens[2].indent, 1);
+  EXPECT_EQ(screens[2].titleLen, 1u);
+}
+
+TEST(TextualCbor, RejectsNonCanonicalHeads) {
+  std::vector<screen_arg_t> screens;
+  // Indent 2 encoded in two bytes
+  const auto longIndent = hex("a10181a3016174026163031802");
+  EXPECT_TRUE(textual_reference::decode(longIndent.data(), longIndent.size(),
+                                        &screens));
+  EXPECT_EQ(decode(longIndent, &screens), parser_cbor_not_canonical);
+
+  // Content length in two bytes
+  const auto longLength = hex("a10181a10279000161");
+  EXPECT_EQ(decode(longLength, &screens), parser_cbor_not_canonical);
+
+  // Indefinite length text
+  const auto indefinite = hex("a10181a1027f6161ff");
+  EXPECT_EQ(decode(indefinite, &screens), parser_cbor_unexpected);
+}
+
+TEST(TextualCbor, RejectsNonCanonicalMaps) {
+  std::vector<screen_arg_t> screens;
+  // Same screen as {1: "t", 2: "c", 3: 1, 4: true}, with fields swapped
+  const auto swapped = hex("a10181a401617402616304f50301");
+  EXPECT_TRUE(
+      textual_reference::decode(swapped.data(), swapped.size(), &screens));
+  EXPECT_EQ(decode(swapped, &screens), parser_cbor_not_canonical);
+  EXPECT_EQ(decode(hex("a10181a401617402616303010301"), &screens),
+            parser_cbor_not_canonical);
+
+  // Defaults spelled out
+  EXPECT_EQ(decode(hex("a10181a20261630300"), &screens),
+            parser_cbor_not_canonical);
+  EXPECT_EQ(decode(hex("a10181a202616304f4"), &screens),
+            parser_cbor_not_canonical);
+  EXPECT_EQ(decode(hex("a10181a20160026163"), &screens),
+            parser_cbor_not_canonical);
+
+  // Canonical form of the first one
+  EXPECT_EQ(decode(hex("a10181a4016174026163030104f5"), &screens), parser_ok);
+}
+
+TEST(TextualCbor, RejectsMalformedInput) {
+  std::vector<screen_arg_t> screens;
+  // Truncated content
+  EXPECT_EQ(decode(hex("a10181a1026261"), &screens),
+            parser_cbor_unexpected_EOF);
+  // Trailing bytes
+  EXPECT_EQ(decode(hex("a10181a102616100"), &screens),
+            parser_cbor_unexpected_EOF);
+  // Title without content
+  EXPECT_EQ(decode(hex("a10181a10161740a"), &screens), parser_unexpected_type);
+  // Unknown field
+  EXPECT_EQ(decode(hex("a10181a202616105f5"), &screens),
+            parser_unexpected_value);
+  // Empty array of screens
+  EXPECT_EQ(decode(hex("a10180"), &screens), parser_unexpected_number_items);
+  // Indent out of range
+  EXPECT_EQ(decode(hex("a10181a301617402616303190100"), &screens),
+            parser_unexpected_value);
+}
+
+// Whatever the specialized decoder accepts, tinycbor must accept and decode
+// to the same screens. fuzz/textual_cbor.cpp runs the same check on
+// arbitrary inputs.
+TEST(TextualCbor, DifferentialAgainstReference) {
+  std::mt19937 rng(0x5eed);
+  const auto blobs = textualBlobs();
+  ASSERT_FALSE(blobs.empty());
+
+  for (int iter = 0; iter < 20000; iter++) {
+    std::vector<uint8_t> blob = blobs[rng() % blobs.size()];
+    const int mutations = 1 + rng() % 4;
+    for (int m = 0; m < mutations && !blob.empty(); m++) {
+      const size_t pos = rng() % blob.size();
+      switch (rng() % 4) {
+      case 0:
+        blob[pos] = (uint8_t)rng();
+        break;
+      case 1:
+        blob[pos] ^= (uint8_t)(1u << (rng() % 8));
+        break;
+      case 2:
+        blob.resize(pos);
+        break;
+      default:
+        blob.insert(blob.begin() + pos, (uint8_t)rng());
+      }
+    }
+
+    std::vector<screen_arg_t> screens;
+    std::vector<screen_arg_t> expected;
+    if (decode(blob, &screens) != parser_ok) {
+      continue;
+    }
+    ASSERT_TRUE(
+        textual_reference::decode(blob.data(), blob.size(), &expected))
+        << "iteration " << iter;
+    ASSERT_TRUE(sameScreens(screens, expected)) << "iteration " << iter;
+  }
+}
+} // namespace
@@ -0,0 +1,165 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+#pragma once
+
+// Reference decoder for the textual sign doc, built on tinycbor as the app
+// used to be. Host only: the unit and fuzz tests check the specialized
+// decoder in app/src/cbor/textual_cbor.c against it.
+
+#include "cbor.h"
+#include <common/parser.h>
+#include <parser_txdef.h>
+#include <vector>
+
+namespace textual_reference {
+
+#define REF_CHECK_CBOR(CALL)                                                   \
+  {                                                                            \
+    if ((CALL) != CborNoError)                                                 \
+      return false;                                                            \
+  }
+
+#define REF_ASSERT(CALL)                                                       \
+  {                                                                            \
+    if (!(CALL))                                                               \
+      return false;                                                            \
+  }
+
+inline bool read_text(CborValue *it, char **ptr, size_t *len) {
+  REF_ASSERT(cbor_value_is_text_string(it))
+  it->flags = 0x64;
+  REF_CHECK_CBOR(cbor_value_get_text_string_chunk(it, (const char **)ptr, len,
+                                                  nullptr))
+  return true;
+}
+
+inline bool read_opt_fields(CborValue *data, size_t n_field,
+                            screen_arg_t *screen) {
+  for (size_t i = 0; i < n_field; i++) {
+    int key = 0;
+    REF_ASSERT(cbor_value_is_integer(data))
+    REF_CHECK_CBOR(cbor_value_get_int(data, &key))
+    REF_CHECK_CBOR(cbor_value_advance(data))
+
+    switch (key) {
+    case INDENT_KEY_ID: {
+      int tmpVal = 0;
+      REF_ASSERT(cbor_value_is_integer(data))
+      REF_CHECK_CBOR(cbor_value_get_int(data, &tmpVal))
+      REF_ASSERT(tmpVal >= 0 && tmpVal <= UINT8_MAX)
+      screen->indent = (uint8_t)tmpVal;
+      break;
+    }
+    case EXPERT_KEY_ID:
+      REF_ASSERT(cbor_value_is_boolean(data))
+      REF_CHECK_CBOR(cbor_value_get_boolean(data, &screen->expert))
+      break;
+    default:
+      screen->indent = 0;
+      screen->expert = false;
+    }
+    REF_CHECK_CBOR(cbor_value_advance(data))
+  }
+  return true;
+}
+
+// Title and content, then the optional fields that follow them
+inline bool read_screen(CborValue *data, size_t n_field, screen_arg_t *screen) {
+  int key = 0;
+  REF_ASSERT(cbor_value_is_integer(data))
+  REF_CHECK_CBOR(cbor_value_get_int(data, &key))
+  if (key != TITLE_KEY_ID) {
+    REF_ASSERT(key == CONTENT_KEY_ID)
+    REF_CHECK_CBOR(cbor_value_advance(data))
+    REF_ASSERT(read_text(data, &screen->contentPtr, &screen->contentLen))
+    REF_ASSERT(screen->contentLen <= MAX_CONTENT_SIZE)
+  } else {
+    REF_CHECK_CBOR(cbor_value_advance(data))
+    REF_ASSERT(read_text(data, &screen->titlePtr, &screen->titleLen))
+    REF_ASSERT(screen->titleLen <= MAX_CONTENT_SIZE)
+    REF_CHECK_CBOR(cbor_value_advance(data))
+    REF_ASSERT(cbor_value_is_integer(data))
+    REF_CHECK_CBOR(cbor_value_get_int(data, &key))
+    REF_ASSERT(key == CONTENT_KEY_ID)
+    REF_CHECK_CBOR(cbor_value_advance(data))
+    REF_ASSERT(read_text(data, &screen->contentPtr, &screen->contentLen))
+    REF_ASSERT(screen->contentLen <= MAX_CONTENT_SIZE)
+  }
+  REF_CHECK_CBOR(cbor_value_advance(data))
+
+  if (n_field > 2) {
+    REF_ASSERT(read_opt_fields(data, n_field - 2, screen))
+  }
+  return true;
+}
+
+/// Decodes buffer into screens, false if it is rejected
+inline bool decode(const uint8_t *buffer, size_t bufferLen,
+                   std::vector<screen_arg_t> *screens) {
+  screens->clear();
+
+  CborParser parser;
+  CborValue mapStruct;
+  CborValue it;
+  REF_CHECK_CBOR(cbor_parser_init(buffer, bufferLen, 0, &parser, &mapStruct))
+  REF_ASSERT(cbor_value_is_map(&mapStruct))
+  REF_CHECK_CBOR(cbor_value_enter_container(&mapStruct, &it))
+
+  int key = 0;
+  REF_ASSERT(cbor_value_is_integer(&it))
+  REF_CHECK_CBOR(cbor_value_get_int(&it, &key))
+  REF_ASSERT(key == 1)
+  REF_CHECK_CBOR(cbor_value_advance(&it))
+
+  size_t count = 0;
+  REF_ASSERT(cbor_value_is_array(&it))
+  REF_CHECK_CBOR(cbor_value_get_array_length(&it, &count))
+  REF_ASSERT(count > 0 && count <= TEXTUAL_MAX_SCREENS)
+
+  CborValue array;
+  REF_CHECK_CBOR(cbor_value_enter_container(&it, &array))
+  for (size_t i = 0; i < count; i++) {
+    size_t n_field = 0;
+    REF_ASSERT(cbor_value_is_map(&array))
+    REF_CHECK_CBOR(cbor_value_get_map_length(&array, &n_field))
+    REF_ASSERT(n_field > 0 && n_field < 5)
+
+    CborValue data;
+    REF_CHECK_CBOR(cbor_value_enter_container(&array, &data))
+
+    screen_arg_t screen = {};
+    CborValue screenData = data;
+    REF_ASSERT(read_screen(&screenData, n_field, &screen))
+
+    // Expert flag walks every field from the start of the map
+    screen_arg_t expert = {};
+    if (n_field > 1) {
+      REF_ASSERT(read_opt_fields(&data, n_field, &expert))
+    }
+    screen.expert = expert.expert;
+    screens->push_back(screen);
+
+    REF_CHECK_CBOR(cbor_value_advance(&array))
+  }
+  REF_CHECK_CBOR(cbor_value_leave_container(&it, &array))
+
+  return it.source.ptr == buffer + bufferLen;
+}
+
+#undef REF_CHECK_CBOR
+#undef REF_ASSERT
+
+} // namespace textual_reference
@@ -0,0 +1,558 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "app_mode.h"
+#include "common.h"
+#include "testcases.h"
+#include "gtest/gtest.h"
+#include <common/parser.h>
+#include <map>
+#include <proto/proto_reader.h>
+#include <string>
+#include <tx.h>
+#include <tx_direct_stream.h>
+#include <vector>
+
+namespace {
+typedef std::vector<uint8_t> bytes_t;
+
+// Minimal protobuf writer, fields are written in the order they are added
+struct Proto {
+  bytes_t data;
+
+  void putVarint(uint64_t value) {
+    while (value >= 0x80) {
+      data.push_back((uint8_t)(value | 0x80));
+      value >>= 7;
+    }
+    data.push_back((uint8_t)value);
+  }
+
+  Proto &varint(uint32_t number, uint64_t value) {
+    putVarint((uint64_t)number << 3);
+    putVarint(value);
+    return *this;
+  }
+
+  Proto &bytes(uint32_t number, const bytes_t &value) {
+    putVarint(((uint64_t)number << 3) | 2);
+    putVarint(value.size());
+    data.insert(data.end(), value.begin(), value.end());
+    return *this;
+  }
+
+  Proto &text(uint32_t number, const std::string &value) {
+    return bytes(number, bytes_t(value.begin(), value.end()));
+  }
+
+  Proto &message(uint32_t number, const Proto &value) {
+    return bytes(number, value.data);
+  }
+};
+
+struct MsgMapping {
+  std::string typeUrl;
+  std::map<std::string, uint32_t> fields;
+};
+
+// Amino JSON messages in the test vectors and their protobuf counterparts
+const std::map<std::string, MsgMapping> &msgMappings() {
+  static const std::map<std::string, MsgMapping> mappings = {
+      {"cosmos-sdk/MsgSend",
+       {"/cosmos.bank.v1beta1.MsgSend",
+        {{"from_address", 1}, {"to_address", 2}, {"amount", 3}}}},
+      {"cosmos-sdk/MsgDelegate",
+       {"/cosmos.staking.v1beta1.MsgDelegate",
+        {{"delegator_address", 1}, {"validator_address", 2}, {"amount", 3}}}},
+      {"cosmos-sdk/MsgUndelegate",
+       {"/cosmos.staking.v1beta1.MsgUndelegate",
+        {{"delegator_address", 1}, {"validator_address", 2}, {"amount", 3}}}},
+      {"cosmos-sdk/MsgBeginRedelegate",
+       {"/cosmos.staking.v1beta1.MsgBeginRedelegate",
+        {{"delegator_address", 1},
+         {"validator_src_address", 2},
+         {"validator_dst_address", 3},
+         {"amount", 4}}}},
+      {"cosmos-sdk/MsgWithdrawDelegationReward",
+       {"/cosmos.distribution.v1beta1.MsgWithdrawDelegatorReward",
+        {{"delegator_address", 1}, {"validator_address", 2}}}},
+      {"cosmos-sdk/MsgSetWithdrawAddress",
+       {"/cosmos.distribution.v1beta1.MsgSetWithdrawAddress",
+        {{"delegator_address", 1}, {"withdraw_address", 2}}}},
+      {"cosmos-sdk/MsgWithdrawValidatorCommission",
+       {"/cosmos.distribution.v1beta1.MsgWithdrawValidatorCommission",
+        {{"validator_address", 1}}}},
+  };
+  return mappings;
+}
+
+Proto coin(const nlohmann::json &c) {
+  Proto p;
+  p.text(1, c["denom"].get<std::string>());
+  p.text(2, c["amount"].get<std::string>());
+  return p;
+}
+
+// Converts an amino JSON sign doc to SIGN_MODE_DIRECT. Returns false when it
+// holds something without a protobuf mapping here.
+bool toSignDoc(const nlohmann::json &tx, bytes_t *signDoc) {
+  if (!tx.is_object() || !tx.contains("msgs") || tx["msgs"].empty() ||
+      !tx.contains("fee") || !tx.contains("memo") || tx.contains("tip")) {
+    return false;
+  }
+
+  Proto body;
+  for (const auto &msg : tx["msgs"]) {
+    if (!msg.contains("type") ||
+        msgMappings().count(msg["type"].get<std::string>()) == 0) {
+      return false;
+    }
+    const MsgMapping &mapping = msgMappings().at(msg["type"]);
+
+    // Fields in number order, as protobuf encoders write them
+    std::map<uint32_t, const nlohmann::json *> ordered;
+    for (const auto &item : msg["value"].items()) {
+      if (mapping.fields.count(item.key()) == 0) {
+        return false;
+      }
+      ordered[mapping.fields.at(item.key())] = &item.value();
+    }
+    Proto value;
+    for (const auto &field : ordered) {
+      const nlohmann::json &v = *field.second;
+      if (v.is_string()) {
+        value.text(field.first, v.get<std::string>());
+      } else if (v.is_object()) {
+        value.message(field.first, coin(v));
+      } else {
+        for (const auto &c : v) {
+          value.message(field.first, coin(c));
+        }
+      }
+    }
+    body.message(1, Proto().text(1, mapping.typeUrl).bytes(2, value.data));
+  }
+  if (!tx["memo"].get<std::string>().empty()) {
+    body.text(2, tx["memo"].get<std::string>());
+  }
+
+  Proto fee;
+  for (const auto &c : tx["fee"]["amount"]) {
+    fee.message(1, coin(c));
+  }
+  fee.varint(2, std::stoull(tx["fee"]["gas"].get<std::string>()));
+
+  Proto signerInfo;
+  const uint64_t sequence = std::stoull(tx["sequence"].get<std::string>());
+  if (sequence != 0) {
+    signerInfo.varint(3, sequence);
+  }
+  Proto authInfo;
+  authInfo.message(1, signerInfo).message(2, fee);
+
+  Proto doc;
+  doc.bytes(1, body.data).bytes(2, authInfo.data);
+  doc.text(3, tx["chain_id"].get<std::string>());
+  const uint64_t account = std::stoull(tx["account_number"].get<std::string>());
+  if (account != 0) {
+    doc.varint(4, account);
+  }
+  *signDoc = doc.data;
+  return true;
+}
+
+parser_error_t parseDirect(const bytes_t &signDoc, parser_context_t *ctx,
+                           parser_tx_t *tx_obj) {
+  memset(tx_obj, 0, sizeof(*tx_obj));
+  tx_obj->tx_type = tx_direct;
+  CHECK_PARSER_ERR(parser_parse(ctx, signDoc.data(), signDoc.size(), tx_obj))
+  return parser_validate(ctx);
+}
+
+// A delegation, with the pieces tests tamper with
+bytes_t delegation(const Proto &extraMsgField, const Proto &extraBody) {
+  Proto amount;
+  amount.text(1, "uatom").text(2, "1000000");
+  Proto value;
+  value.text(1, "cosmos102hty0jv2s29lyc4u0tv97z9v298e24t3vwtpl");
+  value.text(2, "cosmosvaloper1grgelyng2v6v3t8z87wu3sxgt9m5s03xfytvz7");
+  value.message(3, amount);
+  value.data.insert(value.data.end(), extraMsgField.data.begin(),
+                    extraMsgField.data.end());
+
+  Proto body;
+  body.message(1, Proto()
+                      .text(1, "/cosmos.staking.v1beta1.MsgDelegate")
+                      .bytes(2, value.data));
+  body.data.insert(body.data.end(), extraBody.data.begin(),
+                   extraBody.data.end());
+
+  Proto fee;
+  fee.message(1, Proto().text(1, "uatom").text(2, "5000")).varint(2, 200000);
+  Proto authInfo;
+  authInfo.message(1, Proto().varint(3, 1)).message(2, fee);
+
+  Proto doc;
+  doc.bytes(1, body.data).bytes(2, authInfo.data);
+  doc.text(3, "cosmoshub-4").varint(4, 6571);
+  return doc.data;
+}
+
+TEST(TxDirect, MatchesJsonVectors) {
+  size_t converted = 0;
+  for (const auto &tc : GetJsonTestCases("testcases/manual.json")) {
+    bytes_t signDoc;
+    if (tc.validationErr != "No error" ||
+        !toSignDoc(nlohmann::json::parse(tc.tx), &signDoc)) {
+      continue;
+    }
+    converted++;
+
+    app_mode_set_expert(tc.expert);
+    parser_context_t ctx;
+    parser_tx_t tx_obj;
+    ASSERT_EQ(parseDirect(signDoc, &ctx, &tx_obj), parser_ok) << tc.name;
+
+    // Shorter than the JSON form it was converted from
+    EXPECT_LT(signDoc.size(), tc.tx.size()) << tc.name;
+
+    const auto output = dumpUI(&ctx, 40, 40);
+    EXPECT_EQ(output, tc.expected) << tc.name;
+  }
+  EXPECT_GE(converted, 10u);
+}
+
+TEST(TxDirect, MultipleCoins) {
+  Proto value;
+  value.text(1, "cosmos1from").text(2, "cosmos1to");
+  value.message(3, Proto().text(1, "uatom").text(2, "10"));
+  value.message(3, Proto().text(1, "stake").text(2, "20"));
+  Proto body;
+  body.message(
+      1, Proto().text(1, "/cosmos.bank.v1beta1.MsgSend").bytes(2, value.data));
+  Proto authInfo;
+  authInfo.message(1, Proto()).message(2, Proto().varint(2, 100));
+  Proto doc;
+  doc.bytes(1, body.data).bytes(2, authInfo.data).text(3, "cosmoshub-4");
+
+  app_mode_set_expert(false);
+  parser_context_t ctx;
+  parser_tx_t tx_obj;
+  ASSERT_EQ(parseDirect(doc.data, &ctx, &tx_obj), parser_ok);
+  const std::vector<std::string> expected = {
+      "0 | Type : Send",
+      "1 | Amount [1/2] : 0.000010 ATOM",
+      "1 | Amount [2/2] : 20 stake",
+      "2 | From : cosmos1from",
+      "3 | To : cosmos1to",
+      "4 | Fee : Empty",
+  };
+  EXPECT_EQ(dumpUI(&ctx, 40, 40), expected);
+}
+
+TEST(TxDirect, RejectsWhatCannotBeShown) {
+  parser_context_t ctx;
+  parser_tx_t tx_obj;
+  ASSERT_EQ(parseDirect(delegation(Proto(), Proto()), &ctx, &tx_obj),
+            parser_ok);
+
+  // Field missing from the schema
+  EXPECT_EQ(parseDirect(delegation(Proto().text(9, "x"), Proto()), &ctx,
+                        &tx_obj),
+            parser_unexpected_field);
+  // Second validator, which would silently replace the first one
+  EXPECT_EQ(parseDirect(delegation(Proto().text(2, "cosmosvaloper1other"),
+                                   Proto()),
+                        &ctx, &tx_obj),
+            parser_duplicated_field);
+  // Extension options
+  EXPECT_EQ(parseDirect(delegation(Proto(), Proto().text(1023, "x")), &ctx,
+                        &tx_obj),
+            parser_unexpected_field);
+  // Memo that is not printable
+  EXPECT_EQ(parseDirect(delegation(Proto(), Proto().text(2, "a\nb")), &ctx,
+                        &tx_obj),
+            parser_unexpected_characters);
+  // Message without a schema
+  Proto body;
+  body.message(1, Proto().text(1, "/cosmos.gov.v1.MsgVote").text(2, ""));
+  Proto doc;
+  doc.bytes(1, body.data)
+      .bytes(2, Proto().message(1, Proto()).message(2, Proto()).data)
+      .text(3, "cosmoshub-4");
+  EXPECT_EQ(parseDirect(doc.data, &ctx, &tx_obj), parser_unexpected_type);
+}
+
+TEST(TxDirect, RejectsMalformedInput) {
+  parser_context_t ctx;
+  parser_tx_t tx_obj;
+  const bytes_t doc = delegation(Proto(), Proto());
+
+  // Cut anywhere before the account number, which is the last field
+  for (size_t len = 1; len < doc.size() - 3; len++) {
+    const bytes_t truncated(doc.begin(), doc.begin() + len);
+    EXPECT_NE(parseDirect(truncated, &ctx, &tx_obj), parser_ok) << len;
+  }
+
+  // Chain id as a varint
+  bytes_t wrongWire = doc;
+  wrongWire.push_back(3 << 3);
+  wrongWire.push_back(1);
+  EXPECT_EQ(parseDirect(wrongWire, &ctx, &tx_obj),
+            parser_proto_unexpected_wire_type);
+}
+
+TEST(ProtoReader, Varints) {
+  proto_reader_t reader;
+  proto_field_t field;
+
+  // Largest value, ten bytes
+  const bytes_t max = {0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                       0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+  ASSERT_EQ(proto_reader_init(&reader, max.data(), max.size()), parser_ok);
+  ASSERT_EQ(proto_read_field(&reader, &field), parser_ok);
+  EXPECT_EQ(field.number, 1u);
+  EXPECT_EQ(field.value, UINT64_MAX);
+  EXPECT_TRUE(proto_reader_done(&reader));
+
+  // Above 64 bits
+  const bytes_t overflow = {0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                            0xFF, 0xFF, 0xFF, 0xFF, 0x02};
+  ASSERT_EQ(proto_reader_init(&reader, overflow.data(), overflow.size()),
+            parser_ok);
+  EXPECT_EQ(proto_read_field(&reader, &field), parser_value_out_of_range);
+
+  // Length beyond the end of the buffer
+  const bytes_t longLen = {0x0A, 0x05, 0x61};
+  ASSERT_EQ(proto_reader_init(&reader, longLen.data(), longLen.size()),
+            parser_ok);
+  EXPECT_EQ(proto_read_field(&reader, &field), parser_proto_unexpected_EOF);
+
+  // Group and field number 0
+  const bytes_t group = {0x0B};
+  ASSERT_EQ(proto_reader_init(&reader, group.data(), group.size()), parser_ok);
+  EXPECT_EQ(proto_read_field(&reader, &field),
+            parser_proto_unexpected_wire_type);
+  const bytes_t zero = {0x00, 0x00};
+  ASSERT_EQ(proto_reader_init(&reader, zero.data(), zero.size()), parser_ok);
+  EXPECT_EQ(proto_read_field(&reader, &field), parser_unexpected_field);
+}
+// Bytes kept by the stream, the callback has no context
+bytes_t streamKept;
+
+uint32_t keepStreamed(const uint8_t *data, uint32_t len) {
+  streamKept.insert(streamKept.end(), data, data + len);
+  return len;
+}
+
+// Feeds the sign doc in chunks of chunkLen bytes, as the sign handler does
+parser_error_t parseStreamed(const bytes_t &signDoc, size_t chunkLen,
+                             parser_context_t *ctx, parser_tx_t *tx_obj) {
+  static tx_direct_stream_t stream;
+  memset(tx_obj, 0, sizeof(*tx_obj));
+  streamKept.clear();
+  tx_direct_stream_init(&stream, &tx_obj->tx_direct, keepStreamed);
+
+  for (size_t offset = 0; offset < signDoc.size(); offset += chunkLen) {
+    const size_t len = std::min(chunkLen, signDoc.size() - offset);
+    CHECK_PARSER_ERR(
+        tx_direct_stream_feed(&stream, signDoc.data() + offset, len))
+  }
+  CHECK_PARSER_ERR(parser_parseDirectStream(ctx, streamKept.data(),
+                                            streamKept.size(), &stream, tx_obj))
+  return parser_validate(ctx);
+}
+
+TEST(TxDirectStream, MatchesBufferedParse) {
+  size_t converted = 0;
+  for (const auto &tc : GetJsonTestCases("testcases/manual.json")) {
+    bytes_t signDoc;
+    if (tc.validationErr != "No error" ||
+        !toSignDoc(nlohmann::json::parse(tc.tx), &signDoc)) {
+      continue;
+    }
+    converted++;
+
+    app_mode_set_expert(tc.expert);
+    parser_context_t ctx;
+    parser_tx_t tx_obj;
+    for (size_t chunkLen : {1u, 7u, 250u}) {
+      ASSERT_EQ(parseStreamed(signDoc, chunkLen, &ctx, &tx_obj), parser_ok)
+          << tc.name << " " << chunkLen;
+      EXPECT_EQ(dumpUI(&ctx, 40, 40), tc.expected) << tc.name;
+      EXPECT_LT(streamKept.size(), signDoc.size()) << tc.name;
+    }
+  }
+  EXPECT_GE(converted, 10u);
+}
+
+TEST(TxDirectStream, RejectsWhatCannotBeShown) {
+  parser_context_t ctx;
+  parser_tx_t tx_obj;
+
+  EXPECT_EQ(parseStreamed(delegation(Proto().text(9, "x"), Proto()), 7, &ctx,
+                          &tx_obj),
+            parser_unexpected_field);
+  EXPECT_EQ(parseStreamed(delegation(Proto(), Proto().text(1023, "x")), 7,
+                          &ctx, &tx_obj),
+            parser_unexpected_field);
+  EXPECT_EQ(parseStreamed(delegation(Proto(), Proto().text(2, "a\nb")), 7,
+                          &ctx, &tx_obj),
+            parser_unexpected_characters);
+
+  // A second signer
+  Proto body;
+  body.message(1, Proto()
+                      .text(1, "/cosmos.staking.v1beta1.MsgUndelegate")
+                      .bytes(2, Proto().text(1, "cosmos1d").data));
+  Proto doc;
+  doc.bytes(1, body.data)
+      .bytes(2, Proto()
+                    .message(1, Proto())
+                    .message(1, Proto())
+                    .message(2, Proto())
+                    .data)
+      .text(3, "cosmoshub-4");
+  EXPECT_EQ(parseStreamed(doc.data, 7, &ctx, &tx_obj),
+            parser_unexpected_number_items);
+}
+
+TEST(TxDirectStream, RejectsTruncatedInput) {
+  parser_context_t ctx;
+  parser_tx_t tx_obj;
+  const bytes_t doc = delegation(Proto(), Proto());
+  ASSERT_EQ(parseStreamed(doc, 7, &ctx, &tx_obj), parser_ok);
+
+  for (size_t len = 1; len < doc.size() - 3; len++) {
+    const bytes_t truncated(doc.begin(), doc.begin() + len);
+    EXPECT_NE(parseStreamed(truncated, 7, &ctx, &tx_obj), parser_ok) << len;
+  }
+
+  // Bytes past the end of the body
+  bytes_t trailing = doc;
+  trailing[1]--;
+  EXPECT_NE(parseStreamed(trailing, 7, &ctx, &tx_obj), parser_ok);
+}
+
+// Streams the sign doc through the transaction buffer, as the sign handler
+// does. The fields kept go to its flash storage, of FLASH_BUFFER_SIZE bytes.
+const char *parseThroughTxBuffer(const bytes_t &signDoc) {
+  tx_initialize();
+  tx_reset();
+  tx_stream_start();
+  for (size_t offset = 0; offset < signDoc.size(); offset += 250) {
+    const size_t len = std::min<size_t>(250, signDoc.size() - offset);
+    tx_append_streamed(signDoc.data() + offset, (uint32_t)len);
+  }
+  return tx_parse(tx_direct);
+}
+
+// Sends of numCoins IBC coins each, signed by signerInfo
+bytes_t manySends(size_t numCoins, const Proto &signerInfo) {
+  Proto body;
+  for (size_t i = 0; i < DIRECT_MAX_MSGS; i++) {
+    Proto value;
+    value.text(1, "cosmos102hty0jv2s29lyc4u0tv97z9v298e24t3vwtpl");
+    value.text(2, "cosmos14lultfckehtszvzw4ehu0apvsr77afvyhgqhwh");
+    for (size_t c = 0; c < numCoins; c++) {
+      char denom[80];
+      snprintf(denom, sizeof(denom), "ibc/%064zX", i * 16 + c);
+      value.message(3, Proto().text(1, denom).text(2, "10000000"));
+    }
+    body.message(1, Proto()
+                        .text(1, "/cosmos.bank.v1beta1.MsgSend")
+                        .bytes(2, value.data));
+  }
+  Proto fee;
+  fee.message(1, Proto().text(1, "uatom").text(2, "5000")).varint(2, 200000);
+  Proto doc;
+  doc.bytes(1, body.data)
+      .bytes(2, Proto().message(1, signerInfo).message(2, fee).data)
+      .text(3, "cosmoshub-4")
+      .varint(4, 6571);
+  return doc.data;
+}
+
+Proto singleKeySigner() {
+  Proto signerInfo;
+  signerInfo.message(1, Proto()
+                            .text(1, "/cosmos.crypto.secp256k1.PubKey")
+                            .bytes(2, bytes_t(35, 0x02)));
+  signerInfo.varint(3, 1);
+  return signerInfo;
+}
+
+TEST(TxDirectStream, SignDocLargerThanBuffer) {
+  // A multisig signer with many keys. Its public key is skipped while
+  // streaming, the messages are kept and fit in the transaction buffer.
+  Proto multisig;
+  multisig.varint(1, 600);
+  for (size_t k = 0; k < 1000; k++) {
+    multisig.message(2, Proto()
+                            .text(1, "/cosmos.crypto.secp256k1.PubKey")
+                            .bytes(2, Proto().bytes(1, bytes_t(33, 0x02))
+                                          .data));
+  }
+  Proto signerInfo;
+  signerInfo.message(
+      1, Proto()
+             .text(1, "/cosmos.crypto.multisig.LegacyAminoPubKey")
+             .bytes(2, multisig.data));
+  signerInfo.message(2, Proto().message(1, Proto().varint(1, 1)));
+  signerInfo.varint(3, 1);
+  const bytes_t doc = manySends(1, signerInfo);
+  ASSERT_GT(doc.size(), UINT16_MAX);
+
+  app_mode_set_expert(false);
+  parser_context_t ctx;
+  parser_tx_t tx_obj;
+  memset(&tx_obj, 0, sizeof(tx_obj));
+  tx_obj.tx_type = tx_direct;
+  EXPECT_NE(parser_parse(&ctx, doc.data(), doc.size(), &tx_obj), parser_ok);
+
+  ASSERT_EQ(parseThroughTxBuffer(doc), nullptr);
+  EXPECT_LE(tx_get_buffer_length(), 16384u);
+
+  uint8_t numItems = 0;
+  ASSERT_EQ(tx_getNumItems(&numItems), zxerr_ok);
+  char key[40];
+  char value[40];
+  uint8_t pageCount = 0;
+  ASSERT_EQ(tx_getItem(0, key, sizeof(key), value, sizeof(value), 0,
+                       &pageCount),
+            zxerr_ok);
+  EXPECT_STREQ(key, "Type");
+  EXPECT_STREQ(value, "Send");
+  // Past the indexes tx_getItem takes
+  ASSERT_GT(numItems, INT8_MAX);
+  parser_item_t last = {key, sizeof(key), value, sizeof(value), 0, 0};
+  ASSERT_EQ(tx_getItems(numItems - 1, 1, &last), zxerr_ok);
+  EXPECT_STREQ(key, "Fee");
+  EXPECT_STREQ(value, "0.005000 ATOM");
+
+  // The same messages parse from a stream without a bound on what is kept
+  ASSERT_EQ(parseStreamed(doc, 250, &ctx, &tx_obj), parser_ok);
+  EXPECT_EQ(streamKept.size(), tx_get_buffer_length());
+}
+
+TEST(TxDirectStream, RejectsShownFieldsLargerThanBuffer) {
+  // 11 IBC coins per send make about 64 KB of message values to show
+  const bytes_t doc = manySends(11, singleKeySigner());
+  app_mode_set_expert(false);
+  EXPECT_STREQ(parseThroughTxBuffer(doc), "Transaction is too big");
+  EXPECT_LE(tx_get_buffer_length(), 16384u);
+}
+} // namespace
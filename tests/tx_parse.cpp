@@ -21,6 +21,10 @@
 #include <tx_display.h>
 #include <tx_parser.h>
 
+#include <cstring>
+#include <string>
+#include <vector>
+
 namespace {
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "ConstantParameter"
@@ -192,4 +196,38 @@ TEST(TxParse, Page_Count_MultipleMsgs) {
   tx_display_numItems(&numItems);
   EXPECT_EQ(22, numItems) << "Wrong number of items";
 }
+
+TEST(TxParse, Translation_Length) {
+  // Plain, escaped, hex escaped, BMP, non BMP and a trailing space
+  const std::vector<std::string> inputs = {
+      "",
+      "cosmos",
+      "a\nb\\c",
+      "\x01\x02",
+      "caf\xc3\xa9",
+      "\xf0\x9f\x98\x80",
+      "ends with space ",
+      "ends with @",
+  };
+
+  for (const auto &input : inputs) {
+    char out[128];
+    std::vector<char> src(input.begin(), input.end());
+    src.push_back(0);
+    EXPECT_EQ(tx_display_translation(out, sizeof(out), src.data(),
+                                     (uint16_t)input.size()),
+              parser_ok);
+
+    uint16_t len = 0;
+    EXPECT_EQ(tx_display_translation_len(src.data(), (uint16_t)input.size(),
+                                         &len),
+              parser_ok);
+    EXPECT_EQ(len, strlen(out)) << input;
+  }
+
+  // Truncated code point
+  uint16_t len = 0;
+  EXPECT_EQ(tx_display_translation_len("\xc3", 1, &len),
+            parser_unexpected_characters);
+}
 } // namespace
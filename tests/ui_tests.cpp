@@ -21,6 +21,7 @@
 #include "coin.h"
 #include "common.h"
 #include "common/parser.h"
+#include <algorithm>
 #include <hexutils.h>
 #include <iostream>
 #include <memory>
@@ -120,6 +121,60 @@ void check_Textualtestcase(const testcase_t &tc, bool expert_mode) {
   }
 }
 
+// Reads the items in runs of runLen with parser_getItems, and compares them
+// with what parser_getItem returns for each
+void check_items(parser_context_t *ctx, uint8_t runLen) {
+  uint8_t numItems = 0;
+  ASSERT_EQ(parser_getNumItems(ctx, &numItems), parser_ok);
+
+  char keys[4][40];
+  char values[4][40];
+  parser_item_t items[4];
+  for (uint8_t first = 0; first < numItems; first += runLen) {
+    const uint8_t count = std::min<uint8_t>(runLen, numItems - first);
+    for (uint8_t i = 0; i < count; i++) {
+      items[i] = {keys[i], sizeof(keys[i]), values[i], sizeof(values[i]), 0,
+                  0};
+    }
+    ASSERT_EQ(parser_getItems(ctx, first, count, items), parser_ok);
+
+    for (uint8_t i = 0; i < count; i++) {
+      char key[40];
+      char value[40];
+      uint8_t pageCount = 0;
+      ASSERT_EQ(parser_getItem(ctx, first + i, key, sizeof(key), value,
+                               sizeof(value), 0, &pageCount),
+                parser_ok);
+      EXPECT_STREQ(keys[i], key) << "item " << first + i;
+      EXPECT_STREQ(values[i], value) << "item " << first + i;
+      EXPECT_EQ(items[i].pageCount, pageCount) << "item " << first + i;
+    }
+  }
+
+  EXPECT_EQ(parser_getItems(ctx, numItems - 1, 2, items),
+            parser_display_idx_out_of_range);
+}
+
+void check_items_testcase(const testcase_t &tc) {
+  const auto *buffer = (const uint8_t *)tc.tx.c_str();
+  for (bool expert : {false, true}) {
+    app_mode_set_expert(expert);
+
+    parser_context_t ctx;
+    parser_tx_t tx_obj;
+    memset(&tx_obj, 0, sizeof(tx_obj));
+    tx_obj.tx_type = tx_json;
+    if (parser_parse(&ctx, buffer, tc.tx.size(), &tx_obj) != parser_ok ||
+        parser_validate(&ctx) != parser_ok) {
+      return;
+    }
+
+    for (uint8_t runLen : {1, 3, 4}) {
+      check_items(&ctx, runLen);
+    }
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////
@@ -153,6 +208,7 @@ INSTANTIATE_TEST_SUITE_P( // NOLINT(cert-err58-cpp)
 
 TEST_P(JsonTests_Secp256, ValidateTestcase) { validate_testcase(GetParam()); }
 TEST_P(JsonTests_Secp256, CheckUIOutput) { check_testcase(GetParam()); }
+TEST_P(JsonTests_Secp256, ItemRuns) { check_items_testcase(GetParam()); }
 
 TEST_P(JsonTests_Textual, Normal) { check_Textualtestcase(GetParam(), false); }
 TEST_P(JsonTests_Textual, Expert) { check_Textualtestcase(GetParam(), true); }
@@ -0,0 +1,77 @@
+/*******************************************************************************
+ *   (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include "utf8_validate.h"
+#include "gtest/gtest.h"
+#include <string>
+
+namespace {
+parser_error_t validate(const std::string &s, bool *isAscii) {
+  return utf8_validate((const uint8_t *)s.data(), s.size(), isAscii);
+}
+
+TEST(Utf8Validate, Ascii) {
+  bool isAscii = false;
+  EXPECT_EQ(validate("", &isAscii), parser_ok);
+  EXPECT_TRUE(isAscii);
+
+  // Longer than a word, with control characters
+  EXPECT_EQ(validate("cosmos1ulav3hsenupswqfkw2y3sup5kgtqwnvqa8eyhs\n\t",
+                     &isAscii),
+            parser_ok);
+  EXPECT_TRUE(isAscii);
+}
+
+TEST(Utf8Validate, WellFormed) {
+  bool isAscii = true;
+  const std::string valid[] = {
+      "caf\xc3\xa9",      // U+00E9
+      "\xe0\xa0\x80",     // U+0800, lowest 3 byte form
+      "\xed\x9f\xbf",     // U+D7FF, below the surrogates
+      "\xef\xbf\xbd",     // U+FFFD
+      "\xf0\x90\x80\x80", // U+10000, lowest 4 byte form
+      "\xf4\x8f\xbf\xbf", // U+10FFFF
+      // Emoji between runs of ASCII
+      "long ascii prefix \xf0\x9f\x98\x80 and suffix",
+  };
+  for (const auto &s : valid) {
+    EXPECT_EQ(validate(s, &isAscii), parser_ok) << s;
+    EXPECT_FALSE(isAscii) << s;
+  }
+}
+
+TEST(Utf8Validate, IllFormed) {
+  bool isAscii = true;
+  const std::string invalid[] = {
+      "\x80",             // lone continuation
+      "\xc0\xaf",         // overlong '/'
+      "\xc1\xbf",         // overlong
+      "\xe0\x9f\xbf",     // overlong 3 byte form
+      "\xed\xa0\x80",     // U+D800, a surrogate
+      "\xf0\x8f\xbf\xbf", // overlong 4 byte form
+      "\xf4\x90\x80\x80", // above U+10FFFF
+      "\xf5\x80\x80\x80", // invalid lead byte
+      "\xff",             // invalid lead byte
+      "abc\xc3",          // truncated
+      "\xe2\x82",         // truncated
+      "\xe2\x28\xa1",     // bad continuation
+      "01234567\xc3\x28", // bad continuation after a word of ASCII
+  };
+  for (const auto &s : invalid) {
+    EXPECT_EQ(validate(s, &isAscii), parser_unexpected_characters) << s;
+  }
+}
+} // namespace
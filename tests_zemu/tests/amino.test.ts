@@ -30,6 +30,7 @@ import {
   big_transaction,
   wasm_execute_contract_boundary_test,
 } from './common'
+import { recordApdus } from './recorder'
 
 // @ts-ignore
 import secp256k1 from 'secp256k1/elliptic'
@@ -56,6 +57,7 @@ describe('Amino', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'amino_sign_basic_normal')
 
       const path = "m/44'/118'/0'/0/0"
       const tx = Buffer.from(JSON.stringify(example_tx_str_basic), 'utf-8')
@@ -100,6 +102,7 @@ describe('Amino', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'amino_sign_basic_normal2')
 
       const path = "m/44'/118'/0'/0/0"
       const tx = Buffer.from(JSON.stringify(example_tx_str_basic2))
@@ -144,6 +147,7 @@ describe('Amino', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'amino_sign_basic_with_extra_fields')
 
       const path = "m/44'/118'/0'/0/0"
       const tx = Buffer.from(JSON.stringify(example_tx_str_basic))
@@ -188,6 +192,7 @@ describe('Amino', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'amino_ibc_denoms')
 
       const path = "m/44'/118'/0'/0/0"
       const tx = Buffer.from(JSON.stringify(ibc_denoms))
@@ -232,6 +237,7 @@ describe('Amino', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'amino_setwithdrawaddress')
 
       const path = "m/44'/118'/0'/0/0"
       const tx = Buffer.from(JSON.stringify(setWithdrawAddress))
@@ -276,6 +282,7 @@ describe('Amino', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'amino_cligovdeposit')
 
       const path = "m/44'/118'/0'/0/0"
       const tx = Buffer.from(JSON.stringify(cliGovDeposit))
@@ -320,6 +327,7 @@ describe('Amino', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'amino_msgmultisend')
 
       // Activate expert mode
       await sim.toggleExpertMode()
@@ -369,6 +377,7 @@ describe('Amino', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'amino_wasm_execute_contract_boundary_test')
 
       // Activate expert mode
       await sim.toggleExpertMode()
@@ -416,6 +425,7 @@ describe('Amino', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'amino_setwithdrawaddress_eth')
 
       // Change to expert mode so we can skip fields
       await sim.toggleExpertMode()
@@ -463,6 +473,7 @@ describe('Amino', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'amino_sign_basic_normal_eth')
 
       // Enable expert to allow sign with eth path
       await sim.toggleExpertMode()
@@ -513,6 +524,7 @@ describe('Amino', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'amino_sign_basic_normal_eth_no_expert')
 
       const path = "m/44'/60'/0'/0/0"
       const tx = Buffer.from(JSON.stringify(example_tx_str_basic), 'utf-8')
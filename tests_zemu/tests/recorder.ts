@@ -0,0 +1,58 @@
+/** ******************************************************************************
+ *  (c) 2018 - 2024 Zondax AG
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************* */
+
+import Zemu, { IDeviceModel } from '@zondax/zemu'
+import fs from 'fs'
+
+const Resolve = require('path').resolve
+
+// Sessions are replayed against a host build of the app by tests/apdu_replay.cpp,
+// which reports the same target as a Nano S Plus
+const RECORDED_MODEL = 'nanosp'
+const SESSIONS_DIR = Resolve('../tests/apdu_sessions')
+
+// With RECORD_APDUS set, saves the APDUs sent to the app and its replies to
+// tests/apdu_sessions/zemu_<name>.jsonl, one exchange per line, after a line
+// naming the emulator as their source. They sit next to host_<name>.jsonl,
+// whose replies come from the host build. Expert mode toggles are saved too,
+// since the replies depend on them.
+export function recordApdus(sim: Zemu, m: IDeviceModel, name: string) {
+  if (!process.env.RECORD_APDUS || m.name !== RECORDED_MODEL) {
+    return
+  }
+
+  fs.mkdirSync(SESSIONS_DIR, { recursive: true })
+  const file = Resolve(SESSIONS_DIR, `zemu_${name}.jsonl`)
+  fs.writeFileSync(file, `${JSON.stringify({ source: 'zemu', model: m.name })}\n`)
+  const record = (entry: object) => fs.appendFileSync(file, `${JSON.stringify(entry)}\n`)
+
+  const transport = sim.getTransport()
+  const exchange = transport.exchange.bind(transport)
+  transport.exchange = async (apdu: Buffer) => {
+    const reply: Buffer = await exchange(apdu)
+    record({ apdu: apdu.toString('hex'), reply: reply.toString('hex') })
+    return reply
+  }
+
+  let expert = false
+  const toggleExpertMode = sim.toggleExpertMode.bind(sim)
+  sim.toggleExpertMode = async (...args: any[]) => {
+    const result = await toggleExpertMode(...args)
+    expert = !expert
+    record({ expert })
+    return result
+  }
+}
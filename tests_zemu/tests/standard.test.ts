@@ -17,6 +17,7 @@
 import Zemu, { zondaxMainmenuNavigation, ButtonKind, isTouchDevice } from '@zondax/zemu'
 import  CosmosApp  from '@zondax/ledger-cosmos-js'
 import { defaultOptions, DEVICE_MODELS } from './common'
+import { recordApdus } from './recorder'
 
 // @ts-ignore
 // import secp256k1 from 'secp256k1/elliptic'
@@ -49,6 +50,7 @@ describe('Standard', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'standard_get_app_version')
       const resp = await app.getVersion()
 
       console.log(resp)
@@ -66,6 +68,7 @@ describe('Standard', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'standard_get_address')
 
       // Derivation path. First 3 items are automatically hardened!
       const path = "m/44'/118'/5'/0/3"
@@ -94,6 +97,7 @@ describe('Standard', function () {
         approveAction: ButtonKind.DynamicTapButton,
       })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'standard_show_address')
 
       // Derivation path. First 3 items are automatically hardened!
       const path = "m/44'/118'/5'/0/3"
@@ -126,6 +130,7 @@ describe('Standard', function () {
         approveAction: ButtonKind.DynamicTapButton,
       })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'standard_show_eth_address')
 
       // Derivation path. First 3 items are automatically hardened!
       const path = "m/44'/60'/0'/0/1"
@@ -178,6 +183,7 @@ describe('Standard', function () {
         approveAction: ButtonKind.DynamicTapButton,
       })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'standard_show_address_huge')
 
       // Derivation path. First 3 items are automatically hardened!
       const path = "m/44'/118'/2147483647'/0/4294967295"
@@ -203,6 +209,7 @@ describe('Standard', function () {
         approveAction: ButtonKind.DynamicTapButton,
       })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'standard_show_address_huge_expert')
 
       // Activate expert mode
       await sim.toggleExpertMode();
@@ -18,6 +18,7 @@ import Zemu, { ClickNavigation, TouchNavigation, isTouchDevice } from '@zondax/z
 // @ts-ignore
 import CosmosApp from '@zondax/ledger-cosmos-js'
 import { defaultOptions, DEVICE_MODELS, tx_sign_textual, TEXTUAL_TX } from './common'
+import { recordApdus } from './recorder'
 // @ts-ignore
 import secp256k1 from 'secp256k1/elliptic'
 // @ts-ignore
@@ -48,6 +49,7 @@ describe('Textual', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'textual_sign_basic_textual')
 
       const path = "m/44'/118'/0'/0/0"
       const tx = Buffer.from(tx_sign_textual, 'hex')
@@ -92,6 +94,7 @@ describe('Textual', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'textual_sign_basic_textual_expert')
 
       // Change to expert mode so we can skip fields
       await sim.toggleExpertMode()
@@ -139,6 +142,7 @@ describe('Textual', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'textual_sign_basic_textual_evmos')
 
       // Enable expert to allow sign with eth path
       await sim.toggleExpertMode()
@@ -191,6 +195,7 @@ describe('Textual', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'textual_sign_basic_textual_evmos_2')
 
       // Enable expert to allow sign with eth path
       await sim.toggleExpertMode()
@@ -243,6 +248,7 @@ describe('Textual', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'textual_sign_basic_textual_eth_warning')
 
       const path = "m/44'/60'/0'/0/0"
       const tx = Buffer.from(tx_sign_textual, 'hex')
@@ -298,6 +304,7 @@ describe('Textual', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'textual_sign_basic_textual_eth_warning_2')
 
       const path = "m/44'/60'/0'/0/0"
       const tx = Buffer.from(tx_sign_textual, 'hex')
@@ -354,6 +361,7 @@ describe('Textual', function () {
     try {
       await sim.start({ ...defaultOptions, model: m.name })
       const app = new CosmosApp(sim.getTransport())
+      recordApdus(sim, m, 'textual_sign_basic_textual_eth')
 
       // Enable expert to allow sign with eth path
       await sim.toggleExpertMode()